@@ -0,0 +1,95 @@
+# (C) Copyright 2026, SECO Mind Srl
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import hashlib
+import json
+import logging
+import os
+import re
+import struct
+import uuid
+from pathlib import Path
+
+from configuration import Configuration
+from http_requests import http_post_server_data
+
+interface_ota_request = "io.edgehog.devicemanager.OTARequest"
+
+IMAGE_MAGIC = 0x96F3B83D
+IMAGE_HEADER_SIZE = 32
+IMAGE_TLV_INFO_MAGIC = 0x6907
+IMAGE_TLV_HEADER_SIZE = 4
+IMAGE_TLV_SHA256 = 0x10
+
+OTA_STATS_REGEX = (
+    r"OTA stats: ttfb (-?\d+) ms, (\d+) bytes in (\d+) ms, (\d+) KiB/s, "
+    r"erase (\d+) ms, total (\d+) ms"
+)
+OTA_STATS_FIELDS = ["ttfb_ms", "bytes", "transfer_ms", "throughput_kib_s", "erase_ms", "total_ms"]
+
+logger = logging.getLogger(__name__)
+
+
+def is_ota_stats_enabled(dut) -> bool:
+    """Reads the Zephyr build config from the DUT to check if the OTA stats are logged."""
+    cfg_file = Path(dut.device_config.build_dir) / "zephyr" / ".config"
+
+    with open(cfg_file, "r") as f:
+        return "CONFIG_EDGEHOG_DEVICE_OTA_STATS=y" in f.read()
+
+
+def generate_mcuboot_image(body_size: int) -> bytes:
+    """
+    Builds an unsigned MCUboot image with a random body and a SHA-256 TLV, so that the device
+    verifies the hash of the image as it would for a real update.
+    """
+    # magic, load address, header size, protected TLV size, image size, flags and version
+    header = struct.pack(
+        "<IIHHIIBBHI", IMAGE_MAGIC, 0, IMAGE_HEADER_SIZE, 0, body_size, 0, 1, 0, 0, 0
+    )
+    header += bytes(IMAGE_HEADER_SIZE - len(header))
+    body = os.urandom(body_size)
+
+    # The hash covers the header and the body, there are no protected TLVs
+    sha256 = hashlib.sha256(header + body).digest()
+    tlv = struct.pack("<HH", IMAGE_TLV_SHA256, len(sha256)) + sha256
+    # The total size of the TLV area includes its info header
+    tlv_info = struct.pack("<HH", IMAGE_TLV_INFO_MAGIC, IMAGE_TLV_HEADER_SIZE + len(tlv))
+    return header + body + tlv_info + tlv
+
+
+def run_ota_benchmark(e2e_cfg: Configuration, body_size: int, timeout: int = 300) -> dict:
+    """
+    Serves a new image from the local HTTP server, requests its OTA update and returns the
+    timing logged by the device at the end of the download.
+    """
+    # A new URL for each run, so that the image is never found in the secondary slot
+    image = generate_mcuboot_image(body_size)
+    image_name = f"ota-benchmark-{uuid.uuid4()}.bin"
+    (e2e_cfg.http_server_data_dir / image_name).write_bytes(image)
+
+    ota_request = {
+        "uuid": str(uuid.uuid4()),
+        "url": f"https://192.0.2.2:{e2e_cfg.http_server_port}/{image_name}",
+        "operation": "Update",
+    }
+    logger.info(f"Requesting the OTA update of a {len(image)} bytes image")
+    http_post_server_data(e2e_cfg, interface_ota_request, "/request", ota_request)
+
+    lines = e2e_cfg.dut.readlines_until(regex=OTA_STATS_REGEX, timeout=timeout)
+    match = re.search(OTA_STATS_REGEX, lines[-1])
+    assert match, "OTA stats not found in the device logs"
+
+    stats = dict(zip(OTA_STATS_FIELDS, (int(value) for value in match.groups())))
+    assert stats["bytes"] >= len(image), f"OTA download incomplete: {stats}"
+    logger.info(f"OTA benchmark of {len(image)} bytes: {stats}")
+    return stats
+
+
+def record_ota_benchmark(e2e_cfg: Configuration, body_size: int, stats: dict):
+    """Appends the result of a run to ota_benchmark.json in the build directory."""
+    results_file = Path(e2e_cfg.dut.device_config.build_dir) / "ota_benchmark.json"
+    results = json.loads(results_file.read_text()) if results_file.exists() else []
+    results.append({"body_size": body_size, **stats})
+    results_file.write_text(json.dumps(results, indent=2))
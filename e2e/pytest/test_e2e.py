@@ -21,6 +21,7 @@ from file_transfer import (
     validate_file_transfer_filesystem_tar_nested,
     validate_file_transfer_filesystem_tar_empty,
 )
+from ota_benchmark import is_ota_stats_enabled, run_ota_benchmark, record_ota_benchmark
 from storage_usage import (
     validate_storage_usage_published,
     validate_storage_usage_values,
@@ -72,6 +73,34 @@ def e2e_device_env(end_to_end_configuration: Configuration):
     stop_server()
 
 
+@pytest.fixture(scope="function")
+def e2e_ota_benchmark_env(end_to_end_configuration: Configuration):
+
+    logger.info("Starting the http server")
+    start_server(
+        port=end_to_end_configuration.http_server_port,
+        cert_file=end_to_end_configuration.http_server_cert,
+        key_file=end_to_end_configuration.http_server_key,
+        data_dir=end_to_end_configuration.http_server_data_dir,
+    )
+
+    logger.info("Launching the device")
+    end_to_end_configuration.dut.launch()
+    end_to_end_configuration.dut.readlines_until(regex=SHELL_IS_READY, timeout=60)
+    time.sleep(1)
+
+    yield end_to_end_configuration
+
+    # The device reboots to deploy the image, there is no shell to disconnect
+    logger.info("Dumping final device logs and tearing down")
+    logs = end_to_end_configuration.dut.readlines()
+    for line in logs:
+        logger.info(f"DEVICE LOG: {line.strip()}")
+
+    logger.info("Stopping the http server")
+    stop_server()
+
+
 @pytest.mark.default
 def test_telemetry(e2e_device_env):
     cfg, initial_time = e2e_device_env
@@ -109,3 +138,15 @@ def test_storage_usage(e2e_device_env):
     validate_storage_usage_telemetry_frequency(cfg)
 
     time.sleep(1)
+
+
+@pytest.mark.ota_benchmark
+@pytest.mark.parametrize("body_size", [64 * 1024, 256 * 1024])
+def test_ota_benchmark(e2e_ota_benchmark_env, body_size):
+    cfg = e2e_ota_benchmark_env
+
+    if not is_ota_stats_enabled(cfg.dut):
+        pytest.skip("CONFIG_EDGEHOG_DEVICE_OTA_STATS is not enabled in the Zephyr build")
+
+    stats = run_ota_benchmark(cfg, body_size)
+    record_ota_benchmark(cfg, body_size, stats)
@@ -89,8 +89,14 @@ int main(void)
     tls_credential_add(CONFIG_ASTARTE_DEVICE_SDK_HTTPS_CA_CERT_TAG, TLS_CREDENTIAL_CA_CERTIFICATE,
         astarte_ca_certificate_root, ARRAY_SIZE(astarte_ca_certificate_root));
 
+#ifdef CONFIG_E2E_OTA_BENCHMARK
+    // The OTA images are served by the local HTTP server
+    tls_credential_add(CONFIG_EDGEHOG_DEVICE_OTA_HTTPS_CA_CERT_TAG, TLS_CREDENTIAL_CA_CERTIFICATE,
+        edgehog_ft_ca_certificate_root, sizeof(edgehog_ft_ca_certificate_root));
+#else
     tls_credential_add(CONFIG_EDGEHOG_DEVICE_OTA_HTTPS_CA_CERT_TAG, TLS_CREDENTIAL_CA_CERTIFICATE,
         edgehog_ota_ca_certificate_root, sizeof(edgehog_ota_ca_certificate_root));
+#endif
 
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HTTPS_CA_CERT_TAG
     tls_credential_add(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HTTPS_CA_CERT_TAG,
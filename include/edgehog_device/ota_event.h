@@ -36,7 +36,11 @@ typedef enum
     /** @brief Edgehog OTA routine failed. */
     EDGEHOG_OTA_FAILED_EVENT,
     /** @brief Edgehog OTA routine successful. */
-    EDGEHOG_OTA_SUCCESS_EVENT
+    EDGEHOG_OTA_SUCCESS_EVENT,
+    /** @brief Edgehog OTA image downloaded and verified, waiting for its activation. */
+    EDGEHOG_OTA_STAGED_EVENT,
+    /** @brief Edgehog OTA staged image activation, published by the application. */
+    EDGEHOG_OTA_ACTIVATE_EVENT
 } edgehog_ota_event_t;
 
 /**
@@ -14,6 +14,7 @@
 #include "file_transfer/upload.h"
 #include "generated_interfaces.h"
 #include "hardware_info.h"
+#include "http.h"
 #include "led.h"
 #include "log.h"
 #include "network_properties.h"
@@ -457,6 +458,7 @@ edgehog_result_t edgehog_device_stop(edgehog_device_handle_t edgehog_device, k_t
         EDGEHOG_LOG_ERR("Astarte device disconnection failure %s.", astarte_result_to_name(ares));
         return EDGEHOG_RESULT_ASTARTE_ERROR;
     }
+    edgehog_http_close_idle_connections();
     return EDGEHOG_RESULT_OK;
 }
 
@@ -26,16 +26,140 @@ EDGEHOG_LOG_MODULE_REGISTER(file_transfer, CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_L
 #define THREAD_STACK_SIZE 8192
 #define THREAD_PRIORITY 5
 #define THREAD_RUNNING_BIT (1)
+#define QUEUE_SIZE CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_QUEUE_SIZE
+#define WORKERS_COUNT CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_WORKERS
+#define WORKERS_PER_TARGET CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_WORKERS_PER_TARGET
+#define WORKER_RECV_BUF_SIZE CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE
+#define WORKER_POLL_MS 100
+#define PRIORITY_SMALL_SIZE CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PRIORITY_SMALL_SIZE
+#define WORKER_NAME_SIZE 24
+#define FNV1A_OFFSET_BASIS 2166136261U
+#define FNV1A_PRIME 16777619U
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
-K_THREAD_STACK_DEFINE(file_transfer_service_thread_stack_area, THREAD_STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(file_transfer_worker_stack_areas, WORKERS_COUNT, THREAD_STACK_SIZE);
+static uint8_t file_transfer_worker_recv_bufs[WORKERS_COUNT][WORKER_RECV_BUF_SIZE] __aligned(4);
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 
 /************************************************
  *         Static functions declarations        *
  ***********************************************/
 
-static void thread_entry_point(void *device_ptr, void *unused1, void *unused2);
+static void thread_entry_point(void *device_ptr, void *worker_index, void *unused);
+
+/**
+ * @brief Take the next transfer request to perform.
+ *
+ * @details The queued requests are moved to the pending ones, then the runnable request with the
+ * highest aged priority is taken. When none is runnable the msgq is polled for a new request,
+ * unless the pending requests are full.
+ *
+ * @param file_transfer File transfer service.
+ * @param worker Worker requesting a transfer, it is marked busy on the target of the request.
+ * @param msg Filled with the request to perform.
+ * @return True if a request has been taken, false if none is ready.
+ */
+static bool take_next_request(
+    edgehog_ft_t *file_transfer, edgehog_ft_worker_t *worker, edgehog_ft_msg_t *msg);
+
+/**
+ * @brief Get the scheduling information of a pending request, for edgehog_ft_scheduler_select.
+ *
+ * @note Must be called with the service lock held.
+ *
+ * @param index Index of the pending request.
+ * @param user_data File transfer service.
+ * @param entry Filled with the scheduling information of the request.
+ * @return True if the target of the request is below its limit.
+ */
+static bool get_pending_entry(size_t index, void *user_data, edgehog_ft_sched_entry_t *entry);
+
+/**
+ * @brief Check if a request can run without exceeding the limit of its target.
+ *
+ * @note Must be called with the service lock held.
+ *
+ * @param file_transfer File transfer service.
+ * @param msg Transfer request.
+ * @return True if the target of the request is below its limit.
+ */
+static bool is_target_available(const edgehog_ft_t *file_transfer, const edgehog_ft_msg_t *msg);
+
+/**
+ * @brief Mark a worker busy on the target of a request.
+ *
+ * @note Must be called with the service lock held.
+ *
+ * @param file_transfer File transfer service.
+ * @param worker Worker to mark busy.
+ * @param msg Request to perform.
+ */
+static void claim_target(
+    edgehog_ft_t *file_transfer, edgehog_ft_worker_t *worker, const edgehog_ft_msg_t *msg);
+
+/**
+ * @brief Compute the hash of the target of a request.
+ *
+ * @details The target of a filesystem transfer is the allowed partition containing its path, so
+ * that transfers on different files of the same mount point are limited together. The target of
+ * a streaming transfer is its stream.
+ *
+ * @param file_transfer File transfer service.
+ * @param msg Transfer request.
+ * @return Hash of the target.
+ */
+static uint32_t hash_target(const edgehog_ft_t *file_transfer, const edgehog_ft_msg_t *msg);
+
+/**
+ * @brief Account the queue wait time of a request dispatched to a worker.
+ *
+ * @note Must be called with the service lock held.
+ *
+ * @param file_transfer File transfer service.
+ * @param msg Dispatched request.
+ */
+static void account_queue_wait(edgehog_ft_t *file_transfer, const edgehog_ft_msg_t *msg);
+
+/**
+ * @brief Compute the scheduling priority of a request.
+ *
+ * @details Small downloads, up to CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PRIORITY_SMALL_SIZE bytes,
+ * have high priority. Uploads from the filesystem have low priority, as their size is only known
+ * once started. Other transfers have normal priority.
+ *
+ * @param msg Transfer request.
+ * @return Priority of the request.
+ */
+static enum edgehog_ft_priority get_request_priority(const edgehog_ft_msg_t *msg);
+
+/**
+ * @brief Register the start of a transfer, taking the OTA/file transfer semaphore if it's the
+ * first one in progress.
+ *
+ * @details While an OTA update waits for the semaphore no transfer is started, not even next to
+ * the ones in progress, so that the OTA update only waits for the transfers already running.
+ *
+ * @param edgehog_device A valid Edgehog device handle.
+ * @return True if the transfer can proceed, false if the service has been stopped while waiting.
+ */
+static bool begin_transfer(edgehog_device_handle_t edgehog_device);
+
+/**
+ * @brief Register the end of a transfer, giving the OTA/file transfer semaphore back if it was
+ * the last one in progress.
+ *
+ * @param edgehog_device A valid Edgehog device handle.
+ */
+static void end_transfer(edgehog_device_handle_t edgehog_device);
+
+/**
+ * @brief Abort the first workers of the pool, used when the service fails to start.
+ *
+ * @param file_transfer File transfer service.
+ * @param count Number of workers to abort.
+ */
+static void abort_workers(edgehog_ft_t *file_transfer, size_t count);
+
 static edgehog_ft_filesystem_partition_t *duplicate_partitions(
     edgehog_ft_filesystem_partition_t *partitions, size_t partitions_len);
 static void free_partitions(edgehog_ft_filesystem_partition_t *partitions, size_t partitions_len);
@@ -163,6 +287,8 @@ edgehog_ft_t *edgehog_ft_new(
         data->partitions_len = partitions_len;
     }
     data->cbks = cbks;
+    k_mutex_init(&data->lock);
+    k_mutex_init(&data->ota_lock);
 
     return data;
 
@@ -201,27 +327,38 @@ edgehog_result_t edgehog_ft_start(edgehog_device_handle_t device)
         return EDGEHOG_RESULT_FILE_TRANSFER_START_FAIL;
     }
 
-    k_tid_t thread_id = k_thread_create(&file_transfer->thread,
-        file_transfer_service_thread_stack_area, THREAD_STACK_SIZE, thread_entry_point,
-        (void *) device, NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+    file_transfer->pending_len = 0;
+    file_transfer->active_transfers = 0;
+    memset(&file_transfer->queue_stats, 0, sizeof(file_transfer->queue_stats));
 
-    if (!thread_id) {
-        EDGEHOG_LOG_ERR("Unable to start file transfer message thread");
-        k_msgq_cleanup(&file_transfer->msgq);
-        atomic_clear_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
-        return EDGEHOG_RESULT_FILE_TRANSFER_START_FAIL;
-    }
+    for (size_t i = 0; i < WORKERS_COUNT; i++) {
+        edgehog_ft_worker_t *worker = &file_transfer->workers[i];
+        worker->busy = false;
+        k_tid_t thread_id = k_thread_create(&worker->thread, file_transfer_worker_stack_areas[i],
+            THREAD_STACK_SIZE, thread_entry_point, (void *) device, (void *) i, NULL,
+            THREAD_PRIORITY, 0, K_NO_WAIT);
+
+        if (!thread_id) {
+            EDGEHOG_LOG_ERR("Unable to start file transfer worker %zu", i);
+            abort_workers(file_transfer, i);
+            k_msgq_cleanup(&file_transfer->msgq);
+            atomic_clear_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
+            return EDGEHOG_RESULT_FILE_TRANSFER_START_FAIL;
+        }
 
 #ifdef CONFIG_THREAD_NAME
-    int ret = k_thread_name_set(thread_id, "file_transfer");
-    if (ret != 0) {
-        EDGEHOG_LOG_ERR("Failed to set thread name, error %d", ret);
-        k_thread_abort(thread_id);
-        k_msgq_cleanup(&file_transfer->msgq);
-        atomic_clear_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
-        return EDGEHOG_RESULT_FILE_TRANSFER_START_FAIL;
-    }
+        char name[WORKER_NAME_SIZE] = { 0 };
+        snprintf(name, sizeof(name), "file_transfer_%zu", i);
+        int ret = k_thread_name_set(thread_id, name);
+        if (ret != 0) {
+            EDGEHOG_LOG_ERR("Failed to set thread name, error %d", ret);
+            abort_workers(file_transfer, i + 1);
+            k_msgq_cleanup(&file_transfer->msgq);
+            atomic_clear_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
+            return EDGEHOG_RESULT_FILE_TRANSFER_START_FAIL;
+        }
 #endif
+    }
 
     return EDGEHOG_RESULT_OK;
 }
@@ -238,27 +375,35 @@ edgehog_result_t edgehog_ft_stop(edgehog_ft_t *file_transfer, k_timeout_t timeou
         EDGEHOG_LOG_WRN("Stopping edgehog file transfer while not running");
         return EDGEHOG_RESULT_OK;
     }
-    // Request the thread to self exit
+    // Request the workers to self exit
     atomic_clear_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
-    // Wait for the thread to self exit
-    int res = k_thread_join(&file_transfer->thread, timeout);
-    switch (res) {
-        case 0:
-            break;
-        case -EAGAIN:
-            // Force stop the thread, this will likely leak memory and resources
-            k_thread_abort(&file_transfer->thread);
-            eres = EDGEHOG_RESULT_FILE_TRANSFER_STOP_TIMEOUT;
-            break;
-        default:
-            EDGEHOG_LOG_ERR("Failed to stop file transfer thread, error %d", res);
-            eres = EDGEHOG_RESULT_INTERNAL_ERROR;
+    // Wait for the workers to self exit, the timeout applies to the whole pool
+    k_timepoint_t end = sys_timepoint_calc(timeout);
+    for (size_t i = 0; i < WORKERS_COUNT; i++) {
+        struct k_thread *thread = &file_transfer->workers[i].thread;
+        int res = k_thread_join(thread, sys_timepoint_timeout(end));
+        switch (res) {
+            case 0:
+                break;
+            case -EAGAIN:
+                // Force stop the worker, this will likely leak memory and resources
+                k_thread_abort(thread);
+                eres = EDGEHOG_RESULT_FILE_TRANSFER_STOP_TIMEOUT;
+                break;
+            default:
+                EDGEHOG_LOG_ERR("Failed to stop file transfer worker %zu, error %d", i, res);
+                eres = EDGEHOG_RESULT_INTERNAL_ERROR;
+        }
     }
-    // Empty the message queue from leftovers
+    // Empty the message queue and the pending requests from leftovers
     edgehog_ft_msg_t msg_rcv;
     while (k_msgq_get(&file_transfer->msgq, &msg_rcv, K_NO_WAIT) == 0) {
         edgehog_ft_msg_destroy(&msg_rcv);
     }
+    for (size_t i = 0; i < file_transfer->pending_len; i++) {
+        edgehog_ft_msg_destroy(&file_transfer->pending[i]);
+    }
+    file_transfer->pending_len = 0;
     // Safely free the message queue's internal buffer
     k_msgq_cleanup(&file_transfer->msgq);
 
@@ -274,6 +419,17 @@ bool edgehog_ft_is_running(edgehog_ft_t *file_transfer)
     return atomic_test_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
 }
 
+void edgehog_ft_get_queue_stats(edgehog_ft_t *file_transfer, edgehog_ft_queue_stats_t *stats)
+{
+    if (!file_transfer || !stats) {
+        return;
+    }
+
+    k_mutex_lock(&file_transfer->lock, K_FOREVER);
+    *stats = file_transfer->queue_stats;
+    k_mutex_unlock(&file_transfer->lock);
+}
+
 edgehog_result_t edgehog_ft_process_event(edgehog_device_handle_t device,
     astarte_device_datastream_object_event_t *object_event, edgehog_ft_type_t type)
 {
@@ -302,6 +458,8 @@ edgehog_result_t edgehog_ft_process_event(edgehog_device_handle_t device,
         goto failure;
     }
 
+    msg.enqueued_ms = k_uptime_get();
+    msg.priority = get_request_priority(&msg);
     if (k_msgq_put(&device->file_transfer->msgq, &msg, K_NO_WAIT) != 0) {
         EDGEHOG_LOG_ERR("Unable to send file transfer data to the handler task");
         eres = EDGEHOG_RESULT_FILE_TRANSFER_QUEUE_ERROR;
@@ -328,51 +486,235 @@ failure:
  *         Static functions definitions         *
  ***********************************************/
 
-static void thread_entry_point(void *device_ptr, void *unused1, void *unused2)
+static void thread_entry_point(void *device_ptr, void *worker_index, void *unused)
 {
-    EDGEHOG_LOG_DBG("File transfer thread entry point.");
-    ARG_UNUSED(unused1);
-    ARG_UNUSED(unused2);
+    EDGEHOG_LOG_DBG("File transfer worker entry point.");
+    ARG_UNUSED(unused);
 
     edgehog_device_handle_t edgehog_device = (edgehog_device_handle_t) device_ptr;
     edgehog_ft_t *file_transfer = edgehog_device->file_transfer;
-    struct k_msgq *msgq = &file_transfer->msgq;
+    size_t index = (size_t) worker_index;
+    edgehog_ft_worker_t *worker = &file_transfer->workers[index];
 
     edgehog_ft_msg_t msg_rcv = { 0 };
     while (atomic_test_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT)) {
-        if (k_msgq_get(msgq, &msg_rcv, K_MSEC(100)) == 0) {
-
-            // Wait for OTA semaphore with a timeout to prevent deadlocks during shutdown
-            bool sem_taken = false;
-            while (atomic_test_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT)) {
-                if (k_sem_take(&edgehog_device->sync_ota_ft_sem, K_MSEC(100)) == 0) {
-                    sem_taken = true;
-                    break;
-                }
-            }
+        if (!take_next_request(file_transfer, worker, &msg_rcv)) {
+            continue;
+        }
 
-            // If the thread was stopped while waiting, clean up the popped message and exit
-            if (!sem_taken) {
-                edgehog_ft_msg_destroy(&msg_rcv);
-                break;
-            }
+        // Wait for OTA semaphore with a timeout to prevent deadlocks during shutdown
+        bool started = begin_transfer(edgehog_device);
+
+        // If the service was stopped while waiting, clean up the taken message and exit
+        if (!started) {
+            edgehog_ft_msg_destroy(&msg_rcv);
+            k_mutex_lock(&file_transfer->lock, K_FOREVER);
+            worker->busy = false;
+            k_mutex_unlock(&file_transfer->lock);
+            break;
+        }
+
+        // Proceed with the transfer since the workers hold the semaphore
+        msg_rcv.recv_buf = file_transfer_worker_recv_bufs[index];
+        msg_rcv.recv_buf_size = sizeof(file_transfer_worker_recv_bufs[index]);
+        char id_str[UUID_STR_LEN] = { 0 };
+        uuid_to_string(&msg_rcv.id, id_str);
+        if (msg_rcv.type == EDGEHOG_FT_TYPE_SERVER_TO_DEVICE) {
+            EDGEHOG_LOG_DBG("Server to device file transfer on worker %zu: %s", index, id_str);
+            edgehog_ft_handle_server_to_device(edgehog_device, &msg_rcv);
+        } else if (msg_rcv.type == EDGEHOG_FT_TYPE_DEVICE_TO_SERVER) {
+            EDGEHOG_LOG_DBG("Device to server file transfer on worker %zu: %s", index, id_str);
+            edgehog_ft_handle_device_to_server(edgehog_device, &msg_rcv);
+        }
+
+        end_transfer(edgehog_device);
+        k_mutex_lock(&file_transfer->lock, K_FOREVER);
+        worker->busy = false;
+        k_mutex_unlock(&file_transfer->lock);
+    }
+
+    EDGEHOG_LOG_DBG("Exiting file transfer worker %zu", index);
+}
+
+static bool take_next_request(
+    edgehog_ft_t *file_transfer, edgehog_ft_worker_t *worker, edgehog_ft_msg_t *msg)
+{
+    k_mutex_lock(&file_transfer->lock, K_FOREVER);
+    // Move the queued requests to the pending ones, where they are scheduled by priority
+    while (file_transfer->pending_len < QUEUE_SIZE) {
+        edgehog_ft_msg_t *slot = &file_transfer->pending[file_transfer->pending_len];
+        if (k_msgq_get(&file_transfer->msgq, slot, K_NO_WAIT) != 0) {
+            break;
+        }
+        file_transfer->pending_len++;
+    }
+
+    size_t index = edgehog_ft_scheduler_select(
+        file_transfer->pending_len, k_uptime_get(), get_pending_entry, file_transfer);
+    if (index < file_transfer->pending_len) {
+        *msg = file_transfer->pending[index];
+        file_transfer->pending_len--;
+        memmove(&file_transfer->pending[index], &file_transfer->pending[index + 1],
+            (file_transfer->pending_len - index) * sizeof(edgehog_ft_msg_t));
+        claim_target(file_transfer, worker, msg);
+        account_queue_wait(file_transfer, msg);
+        k_mutex_unlock(&file_transfer->lock);
+        return true;
+    }
+    bool pending_full = file_transfer->pending_len >= QUEUE_SIZE;
+    k_mutex_unlock(&file_transfer->lock);
+
+    // Wait for a running transfer to release its target before accepting new requests
+    if (pending_full) {
+        k_msleep(WORKER_POLL_MS);
+        return false;
+    }
+    // Wait for a new request, it is scheduled on the next call
+    edgehog_ft_msg_t queued = { 0 };
+    if (k_msgq_get(&file_transfer->msgq, &queued, K_MSEC(WORKER_POLL_MS)) == 0) {
+        k_mutex_lock(&file_transfer->lock, K_FOREVER);
+        file_transfer->pending[file_transfer->pending_len++] = queued;
+        k_mutex_unlock(&file_transfer->lock);
+    }
+    return false;
+}
+
+static bool get_pending_entry(size_t index, void *user_data, edgehog_ft_sched_entry_t *entry)
+{
+    const edgehog_ft_t *file_transfer = (const edgehog_ft_t *) user_data;
+    const edgehog_ft_msg_t *msg = &file_transfer->pending[index];
+
+    entry->priority = msg->priority;
+    entry->enqueued_ms = msg->enqueued_ms;
+    return is_target_available(file_transfer, msg);
+}
+
+static bool is_target_available(const edgehog_ft_t *file_transfer, const edgehog_ft_msg_t *msg)
+{
+    uint32_t target_hash = hash_target(file_transfer, msg);
+    size_t running = 0;
+    for (size_t i = 0; i < WORKERS_COUNT; i++) {
+        const edgehog_ft_worker_t *worker = &file_transfer->workers[i];
+        if (worker->busy && (worker->target_type == msg->location_type)
+            && (worker->target_hash == target_hash)) {
+            running++;
+        }
+    }
+    return running < WORKERS_PER_TARGET;
+}
 
-            // Proceed with the transfer since we hold the semaphore
-            char id_str[UUID_STR_LEN] = { 0 };
-            uuid_to_string(&msg_rcv.id, id_str);
-            if (msg_rcv.type == EDGEHOG_FT_TYPE_SERVER_TO_DEVICE) {
-                EDGEHOG_LOG_DBG("Server to device file transfer: %s", id_str);
-                edgehog_ft_handle_server_to_device(edgehog_device, &msg_rcv);
-            } else if (msg_rcv.type == EDGEHOG_FT_TYPE_DEVICE_TO_SERVER) {
-                EDGEHOG_LOG_DBG("Device to server file transfer: %s", id_str);
-                edgehog_ft_handle_device_to_server(edgehog_device, &msg_rcv);
+static void claim_target(
+    edgehog_ft_t *file_transfer, edgehog_ft_worker_t *worker, const edgehog_ft_msg_t *msg)
+{
+    worker->busy = true;
+    worker->target_type = msg->location_type;
+    worker->target_hash = hash_target(file_transfer, msg);
+}
+
+static uint32_t hash_target(const edgehog_ft_t *file_transfer, const edgehog_ft_msg_t *msg)
+{
+    const char *target = msg->location ? msg->location : "";
+    size_t target_len = strlen(target);
+
+    if (msg->location_type == EDGEHOG_FT_LOCATION_TYPE_FILESYSTEM) {
+        // Use the longest allowed mount point containing the path, as in is_valid_partition
+        size_t mount_point_len = 0;
+        for (size_t i = 0; i < file_transfer->partitions_len; i++) {
+            const char *mount_point = file_transfer->partitions[i].mount_point;
+            size_t len = strlen(mount_point);
+            if ((len > mount_point_len) && (len <= target_len)
+                && (strncmp(target, mount_point, len) == 0)
+                && ((target[len] == '/') || (target[len] == '\0'))) {
+                mount_point_len = len;
             }
+        }
+        if (mount_point_len > 0) {
+            target_len = mount_point_len;
+        }
+    }
+
+    // FNV-1a, collisions only make two targets share their limit
+    uint32_t hash = FNV1A_OFFSET_BASIS;
+    for (size_t i = 0; i < target_len; i++) {
+        hash = (hash ^ (uint8_t) target[i]) * FNV1A_PRIME;
+    }
+    return hash;
+}
+
+static void account_queue_wait(edgehog_ft_t *file_transfer, const edgehog_ft_msg_t *msg)
+{
+    edgehog_ft_queue_stats_t *stats = &file_transfer->queue_stats;
+    int64_t wait_ms = k_uptime_get() - msg->enqueued_ms;
+    stats->transfers++;
+    stats->total_wait_ms += wait_ms;
+    if (wait_ms > stats->max_wait_ms) {
+        stats->max_wait_ms = wait_ms;
+    }
+    size_t pending = k_msgq_num_used_get(&file_transfer->msgq) + file_transfer->pending_len;
+    EDGEHOG_LOG_DBG("File transfer with priority %d queued for %lld ms, average %lld ms, max %lld "
+                    "ms over %u transfers, %zu pending",
+        (int) msg->priority, wait_ms, stats->total_wait_ms / stats->transfers, stats->max_wait_ms,
+        stats->transfers, pending);
+}
 
-            k_sem_give(&edgehog_device->sync_ota_ft_sem);
+static enum edgehog_ft_priority get_request_priority(const edgehog_ft_msg_t *msg)
+{
+    if (msg->type == EDGEHOG_FT_TYPE_SERVER_TO_DEVICE) {
+        if ((msg->file_size_bytes > 0) && (msg->file_size_bytes <= PRIORITY_SMALL_SIZE)) {
+            return EDGEHOG_FT_PRIORITY_HIGH;
         }
+        return EDGEHOG_FT_PRIORITY_NORMAL;
     }
+    if (msg->location_type == EDGEHOG_FT_LOCATION_TYPE_FILESYSTEM) {
+        return EDGEHOG_FT_PRIORITY_LOW;
+    }
+    return EDGEHOG_FT_PRIORITY_NORMAL;
+}
 
-    EDGEHOG_LOG_DBG("Exiting file transfer thread");
+static bool begin_transfer(edgehog_device_handle_t edgehog_device)
+{
+    edgehog_ft_t *file_transfer = edgehog_device->file_transfer;
+    bool started = false;
+
+    k_mutex_lock(&file_transfer->ota_lock, K_FOREVER);
+    while (atomic_test_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT)) {
+        if (atomic_get(&edgehog_device->ota_waiting) != 0) {
+            // Release the lock so that the transfers in progress can end and the OTA can start
+            k_mutex_unlock(&file_transfer->ota_lock);
+            k_msleep(WORKER_POLL_MS);
+            k_mutex_lock(&file_transfer->ota_lock, K_FOREVER);
+            continue;
+        }
+        if ((file_transfer->active_transfers > 0)
+            || (k_sem_take(&edgehog_device->sync_ota_ft_sem, K_MSEC(WORKER_POLL_MS)) == 0)) {
+            started = true;
+            break;
+        }
+    }
+    if (started) {
+        file_transfer->active_transfers++;
+    }
+    k_mutex_unlock(&file_transfer->ota_lock);
+    return started;
+}
+
+static void end_transfer(edgehog_device_handle_t edgehog_device)
+{
+    edgehog_ft_t *file_transfer = edgehog_device->file_transfer;
+
+    k_mutex_lock(&file_transfer->ota_lock, K_FOREVER);
+    file_transfer->active_transfers--;
+    if (file_transfer->active_transfers == 0) {
+        k_sem_give(&edgehog_device->sync_ota_ft_sem);
+    }
+    k_mutex_unlock(&file_transfer->ota_lock);
+}
+
+static void abort_workers(edgehog_ft_t *file_transfer, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        k_thread_abort(&file_transfer->workers[i].thread);
+    }
 }
 
 static edgehog_ft_filesystem_partition_t *duplicate_partitions(
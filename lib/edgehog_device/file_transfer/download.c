@@ -9,6 +9,9 @@
 #include "edgehog_private.h"
 #include "file_transfer/core.h"
 #include "file_transfer/decompression.h"
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARALLEL_DOWNLOAD
+#include "file_transfer/download_ranges.h"
+#endif
 #include "file_transfer/filesystem.h"
 #include "file_transfer/stream.h"
 #include "file_transfer/utils.h"
@@ -47,6 +50,8 @@ static edgehog_result_t process_tar_chunk(
 #endif
 static edgehog_result_t process_uncompressed_chunk(
     edgehog_ft_http_cbk_data_t *data, const edgehog_http_response_chunk_t *response_chunk);
+static edgehog_result_t download_single_connection(
+    edgehog_ft_http_cbk_data_t *data, const edgehog_ft_msg_t *msg);
 static const edgehog_ft_file_write_cbks_t *get_callbacks(
     enum edgehog_ft_location_type destination_type);
 static edgehog_result_t setup_digest(edgehog_ft_http_cbk_data_t *data);
@@ -143,29 +148,46 @@ static edgehog_result_t http_get_server_to_device_request_cbk(
     EDGEHOG_LOG_HEXDUMP_DBG(response_chunk->chunk_start_addr, response_chunk->chunk_size,
         "[server-to-device] raw chunk data");
 
-    if (data->expected_digest && response_chunk->chunk_size > 0) {
-        psa_status_t status = psa_hash_update(
-            &data->hash_operation, response_chunk->chunk_start_addr, response_chunk->chunk_size);
+    // A resumed download could receive data already processed in a previous attempt, either
+    // because the server ignored the range request or sent a wider range. Skip it, so that the
+    // file and the digest only see each byte once.
+    edgehog_http_response_chunk_t chunk = *response_chunk;
+    size_t chunk_offset = chunk.range_offset + data->attempt_bytes;
+    data->attempt_bytes += chunk.chunk_size;
+    if (chunk_offset < data->received_bytes) {
+        size_t skip_size = MIN(data->received_bytes - chunk_offset, chunk.chunk_size);
+        chunk.chunk_start_addr += skip_size;
+        chunk.chunk_size -= skip_size;
+    } else if (chunk_offset > data->received_bytes) {
+        EDGEHOG_LOG_ERR("Gap in the received data, expected offset %zu received %zu",
+            data->received_bytes, chunk_offset);
+        return EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+    }
+
+    if (data->expected_digest && chunk.chunk_size > 0) {
+        psa_status_t status
+            = psa_hash_update(&data->hash_operation, chunk.chunk_start_addr, chunk.chunk_size);
         if (status != PSA_SUCCESS) {
             data->posix_errno = EIO;
             data->message = "Failed to update file digest";
             return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
         }
     }
+    data->received_bytes += chunk.chunk_size;
 
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
     if (data->encoding == EDGEHOG_FT_ENCODING_LZ4) {
-        return process_compressed_chunk(data, response_chunk);
+        return process_compressed_chunk(data, &chunk);
     }
 #endif
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR
     if (data->encoding == EDGEHOG_FT_ENCODING_TAR) {
-        return process_tar_chunk(data, response_chunk);
+        return process_tar_chunk(data, &chunk);
     }
 #endif
 
     // Fallthrough for uncompressed, or if compression is disabled
-    return process_uncompressed_chunk(data, response_chunk);
+    return process_uncompressed_chunk(data, &chunk);
 }
 
 /************************************************
@@ -234,17 +256,18 @@ void edgehog_ft_handle_server_to_device(
     }
     digest_active = true;
 
-    // Initialize the HTTP get msg
-    edgehog_http_get_data_t http_get_data = {
-        .url = msg->url,
-        .header_fields = (const char **) msg->http_headers,
-        .timeout_ms = EDGEHOG_FT_HTTP_REQ_TIMEOUT_MS,
-        .response_cbk = http_get_server_to_device_request_cbk,
-        .user_data = http_cbk_user_data,
-    };
-    // Perform the HTTP get request to fetch the file
-
-    eres = edgehog_http_get(&http_get_data);
+    // Large files can be split in ranges downloaded over concurrent connections
+    bool downloaded = false;
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARALLEL_DOWNLOAD
+    if (edgehog_ft_download_ranges_supported(msg, file_cbks)) {
+        bool fallback = false;
+        eres = edgehog_ft_download_ranges(http_cbk_user_data, msg, &fallback);
+        downloaded = !fallback;
+    }
+#endif
+    if (!downloaded) {
+        eres = download_single_connection(http_cbk_user_data, msg);
+    }
     if (eres != EDGEHOG_RESULT_OK) {
         EDGEHOG_LOG_ERR("File transfer HTTP get failure: %d.", eres);
         posix_errno = http_cbk_user_data->posix_errno;
@@ -289,6 +312,49 @@ exit:
  *         Static functions definitions         *
  ***********************************************/
 
+static edgehog_result_t download_single_connection(
+    edgehog_ft_http_cbk_data_t *data, const edgehog_ft_msg_t *msg)
+{
+    edgehog_result_t eres = EDGEHOG_RESULT_OK;
+    edgehog_http_get_data_t http_get_data = {
+        .url = msg->url,
+        .header_fields = (const char **) msg->http_headers,
+        .timeout_ms = EDGEHOG_FT_HTTP_REQ_TIMEOUT_MS,
+        .recv_buf = msg->recv_buf,
+        .recv_buf_size = msg->recv_buf_size,
+        .response_cbk = http_get_server_to_device_request_cbk,
+        .user_data = data,
+    };
+
+    // Perform the HTTP get request to fetch the file. Transport failures are retried resuming
+    // from the first byte not yet processed, while the partial file and digest are kept.
+    int64_t start_ms = k_uptime_get();
+    for (int attempt = 0;; attempt++) {
+        http_get_data.range_start = data->received_bytes;
+        data->attempt_bytes = 0;
+        eres = edgehog_http_get(&http_get_data);
+        if ((eres == EDGEHOG_RESULT_OK) || (data->posix_errno != 0)
+            || (attempt >= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME_ATTEMPTS)) {
+            break;
+        }
+        // Definitive errors, such as a missing file or an expired URL, won't be fixed by a retry
+        if (!edgehog_http_is_retryable_status(http_get_data.status_code)) {
+            EDGEHOG_LOG_ERR("File transfer rejected by the server with status %u",
+                http_get_data.status_code);
+            break;
+        }
+        EDGEHOG_LOG_WRN("File transfer interrupted at byte %zu (%d), resume attempt %d of %d",
+            data->received_bytes, eres, attempt + 1,
+            CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME_ATTEMPTS);
+        k_msleep(EDGEHOG_FT_RESUME_DELAY_MS);
+    }
+
+    if (eres == EDGEHOG_RESULT_OK) {
+        edgehog_ft_log_throughput(data->received_bytes, k_uptime_get() - start_ms, 1);
+    }
+    return eres;
+}
+
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
 static edgehog_result_t process_compressed_chunk(
     edgehog_ft_http_cbk_data_t *data, const edgehog_http_response_chunk_t *response_chunk)
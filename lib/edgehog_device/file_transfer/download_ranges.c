@@ -0,0 +1,341 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "file_transfer/download_ranges.h"
+
+#include "http.h"
+#include "log.h"
+
+#include <psa/crypto.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <stdlib.h>
+
+EDGEHOG_LOG_MODULE_REGISTER(
+    file_transfer_download_ranges, CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define RANGES_COUNT CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARALLEL_DOWNLOAD_CONNECTIONS
+#define THREAD_STACK_SIZE CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARALLEL_DOWNLOAD_STACK_SIZE
+/* Buffer used to read back the downloaded file when computing the digest */
+#define DIGEST_READ_BUFFER_SIZE 1024
+
+// Below this size the rounded up ranges could leave the last ones empty
+BUILD_ASSERT(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARALLEL_DOWNLOAD_MIN_SIZE
+        >= RANGES_COUNT * (RANGES_COUNT - 1),
+    "The parallel download minimum size must be at least CONNECTIONS * (CONNECTIONS - 1)");
+
+struct ranges_ctx;
+
+/** @brief A byte range of the file, downloaded by its own thread. */
+typedef struct
+{
+    /** @brief Context of the parallel download this range is part of. */
+    struct ranges_ctx *ranges;
+    /** @brief Offset of the first byte of the range in the file. */
+    size_t start;
+    /** @brief Size of the range in bytes. */
+    size_t size;
+    /** @brief Bytes of the range received and written to the file. */
+    size_t received;
+    /** @brief Bytes of the range received during the current attempt. */
+    size_t attempt_bytes;
+    /** @brief Result of the download of the range. */
+    edgehog_result_t eres;
+} range_t;
+
+/** @brief Context of a parallel range download. */
+typedef struct ranges_ctx
+{
+    /** @brief HTTP callback data of the transfer, shared by all the ranges. */
+    edgehog_ft_http_cbk_data_t *data;
+    /** @brief The server-to-device message payload. */
+    const edgehog_ft_msg_t *msg;
+    /** @brief Serializes the writes to the file and the progress updates. */
+    struct k_mutex write_mutex;
+    /** @brief Set when a range failed, to stop the download of the others. */
+    atomic_t abort;
+    /** @brief Set when the server does not honor the range requests. */
+    atomic_t unsupported;
+    /** @brief The byte ranges the file has been split into. */
+    range_t ranges[RANGES_COUNT];
+} ranges_ctx_t;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+K_THREAD_STACK_ARRAY_DEFINE(range_thread_stacks, RANGES_COUNT, THREAD_STACK_SIZE);
+static struct k_thread range_threads[RANGES_COUNT];
+// Protects the range threads and stacks, a single parallel download can run at any time
+K_MUTEX_DEFINE(range_threads_mutex);
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declarations        *
+ ***********************************************/
+
+static void range_thread_entry(void *range_ptr, void *unused1, void *unused2);
+static edgehog_result_t download_ranges(ranges_ctx_t *ctx);
+static edgehog_result_t hash_file(edgehog_ft_http_cbk_data_t *data, size_t file_size);
+
+/************************************************
+ *     Callbacks definition and declaration     *
+ ***********************************************/
+
+static edgehog_result_t range_response_cbk(
+    edgehog_http_response_chunk_t *response_chunk, void *user_data)
+{
+    range_t *range = (range_t *) user_data;
+    ranges_ctx_t *ctx = range->ranges;
+    edgehog_ft_http_cbk_data_t *data = ctx->data;
+    const edgehog_ft_file_write_cbks_t *file_cbks
+        = (const edgehog_ft_file_write_cbks_t *) data->file_cbks;
+
+    if (atomic_get(&ctx->abort)) {
+        return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+    }
+
+    // The server should reply with exactly the requested range, a response covering a different
+    // span means that it ignored the range request and is sending the whole file
+    size_t remaining = range->size - range->received;
+    if ((range->attempt_bytes == 0)
+        && ((response_chunk->range_offset != range->start + range->received)
+            || (response_chunk->response_size != remaining))) {
+        EDGEHOG_LOG_WRN("Range request not honored, offset %zu size %zu",
+            response_chunk->range_offset, response_chunk->response_size);
+        atomic_set(&ctx->unsupported, true);
+        return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+    }
+    if (response_chunk->chunk_size > remaining) {
+        EDGEHOG_LOG_ERR("Received more data than requested for range at %zu", range->start);
+        return EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+    }
+    if (response_chunk->chunk_size == 0) {
+        return EDGEHOG_RESULT_OK;
+    }
+
+    k_mutex_lock(&ctx->write_mutex, K_FOREVER);
+    edgehog_result_t eres = file_cbks->file_write_at(data->file_cbks_ctx,
+        range->start + range->received, response_chunk->chunk_start_addr,
+        response_chunk->chunk_size);
+    if (eres == EDGEHOG_RESULT_OK) {
+        edgehog_ft_update_progress(data, response_chunk->chunk_size, false);
+    } else {
+        data->posix_errno = EIO;
+        data->message = "Failed to write chunk to file";
+    }
+    k_mutex_unlock(&ctx->write_mutex);
+
+    if (eres != EDGEHOG_RESULT_OK) {
+        return eres;
+    }
+
+    range->received += response_chunk->chunk_size;
+    range->attempt_bytes += response_chunk->chunk_size;
+    return EDGEHOG_RESULT_OK;
+}
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+bool edgehog_ft_download_ranges_supported(
+    const edgehog_ft_msg_t *msg, const edgehog_ft_file_write_cbks_t *file_cbks)
+{
+    return (msg->location_type == EDGEHOG_FT_LOCATION_TYPE_FILESYSTEM)
+        && (msg->encoding == EDGEHOG_FT_ENCODING_NONE)
+        && (msg->file_size_bytes >= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARALLEL_DOWNLOAD_MIN_SIZE)
+        && (msg->file_size_bytes >= RANGES_COUNT) && file_cbks->file_write_at
+        && file_cbks->file_read_at && file_cbks->file_rewind;
+}
+
+edgehog_result_t edgehog_ft_download_ranges(
+    edgehog_ft_http_cbk_data_t *data, const edgehog_ft_msg_t *msg, bool *fallback)
+{
+    edgehog_result_t eres = EDGEHOG_RESULT_OK;
+    ranges_ctx_t *ctx = NULL;
+    const edgehog_ft_file_write_cbks_t *file_cbks
+        = (const edgehog_ft_file_write_cbks_t *) data->file_cbks;
+    size_t file_size = (size_t) msg->file_size_bytes;
+
+    *fallback = false;
+
+    if (k_mutex_lock(&range_threads_mutex, K_NO_WAIT) != 0) {
+        EDGEHOG_LOG_INF("Parallel download already running, using a single connection");
+        *fallback = true;
+        return EDGEHOG_RESULT_OK;
+    }
+
+    ctx = k_calloc(1, sizeof(ranges_ctx_t));
+    if (!ctx) {
+        EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
+        *fallback = true;
+        goto exit;
+    }
+    ctx->data = data;
+    ctx->msg = msg;
+    k_mutex_init(&ctx->write_mutex);
+
+    size_t range_size = DIV_ROUND_UP(file_size, RANGES_COUNT);
+    for (size_t i = 0; i < RANGES_COUNT; i++) {
+        ctx->ranges[i].ranges = ctx;
+        ctx->ranges[i].start = MIN(i * range_size, file_size);
+        ctx->ranges[i].size = MIN(range_size, file_size - ctx->ranges[i].start);
+    }
+
+    int64_t start_ms = k_uptime_get();
+    eres = download_ranges(ctx);
+    if (atomic_get(&ctx->unsupported)) {
+        // The single connection download appends to the file, drop any range already written
+        EDGEHOG_LOG_WRN("Range requests not supported by the server, using a single connection");
+        eres = file_cbks->file_rewind(data->file_cbks_ctx);
+        if (eres != EDGEHOG_RESULT_OK) {
+            data->posix_errno = EIO;
+            data->message = "Failed to rewind the file";
+            goto exit;
+        }
+        data->transferred_bytes = 0;
+        atomic_set(&data->last_reported_bytes, 0);
+        *fallback = true;
+        goto exit;
+    }
+    if (eres != EDGEHOG_RESULT_OK) {
+        goto exit;
+    }
+    edgehog_ft_log_throughput(file_size, k_uptime_get() - start_ms, RANGES_COUNT);
+
+    // The digest is computed in order, reading the file back once all the ranges have arrived
+    if (data->expected_digest) {
+        eres = hash_file(data, file_size);
+        if (eres != EDGEHOG_RESULT_OK) {
+            goto exit;
+        }
+    }
+
+    edgehog_ft_update_progress(data, 0, true);
+
+exit:
+    k_free(ctx);
+    k_mutex_unlock(&range_threads_mutex);
+    return eres;
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static void range_thread_entry(void *range_ptr, void *unused1, void *unused2)
+{
+    ARG_UNUSED(unused1);
+    ARG_UNUSED(unused2);
+    range_t *range = (range_t *) range_ptr;
+    ranges_ctx_t *ctx = range->ranges;
+
+    edgehog_http_get_data_t http_get_data = {
+        .url = ctx->msg->url,
+        .header_fields = (const char **) ctx->msg->http_headers,
+        .timeout_ms = EDGEHOG_FT_HTTP_REQ_TIMEOUT_MS,
+        .response_cbk = range_response_cbk,
+        .user_data = range,
+    };
+
+    // Each range is resumed independently from its first byte not yet written
+    for (int attempt = 0;; attempt++) {
+        http_get_data.range_start = range->start + range->received;
+        http_get_data.range_size = range->size - range->received;
+        range->attempt_bytes = 0;
+        range->eres = edgehog_http_get(&http_get_data);
+        if ((range->eres == EDGEHOG_RESULT_OK) || atomic_get(&ctx->abort)
+            || atomic_get(&ctx->unsupported)
+            || (attempt >= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME_ATTEMPTS)) {
+            break;
+        }
+        EDGEHOG_LOG_WRN("Range at %zu interrupted at byte %zu (%d), resume attempt %d of %d",
+            range->start, range->received, range->eres, attempt + 1,
+            CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME_ATTEMPTS);
+        k_msleep(EDGEHOG_FT_RESUME_DELAY_MS);
+    }
+
+    if ((range->eres == EDGEHOG_RESULT_OK) && (range->received != range->size)) {
+        EDGEHOG_LOG_ERR("Range at %zu incomplete, received %zu of %zu bytes", range->start,
+            range->received, range->size);
+        range->eres = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+    }
+    if (range->eres != EDGEHOG_RESULT_OK) {
+        atomic_set(&ctx->abort, true);
+    }
+}
+
+static edgehog_result_t download_ranges(ranges_ctx_t *ctx)
+{
+    edgehog_result_t eres = EDGEHOG_RESULT_OK;
+    int priority = k_thread_priority_get(k_current_get());
+
+    for (size_t i = 0; i < RANGES_COUNT; i++) {
+        // An empty range would become an open ended request past the end of the file
+        if (ctx->ranges[i].size == 0) {
+            continue;
+        }
+        k_thread_create(&range_threads[i], range_thread_stacks[i], THREAD_STACK_SIZE,
+            range_thread_entry, &ctx->ranges[i], NULL, NULL, priority, 0, K_NO_WAIT);
+#ifdef CONFIG_THREAD_NAME
+        k_thread_name_set(&range_threads[i], "ft_range");
+#endif
+    }
+
+    for (size_t i = 0; i < RANGES_COUNT; i++) {
+        if (ctx->ranges[i].size == 0) {
+            continue;
+        }
+        k_thread_join(&range_threads[i], K_FOREVER);
+        if ((eres == EDGEHOG_RESULT_OK) && (ctx->ranges[i].eres != EDGEHOG_RESULT_OK)) {
+            eres = ctx->ranges[i].eres;
+        }
+    }
+
+    return eres;
+}
+
+static edgehog_result_t hash_file(edgehog_ft_http_cbk_data_t *data, size_t file_size)
+{
+    edgehog_result_t eres = EDGEHOG_RESULT_OK;
+    const edgehog_ft_file_write_cbks_t *file_cbks
+        = (const edgehog_ft_file_write_cbks_t *) data->file_cbks;
+
+    uint8_t *buffer = k_malloc(DIGEST_READ_BUFFER_SIZE);
+    if (!buffer) {
+        EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
+        data->posix_errno = ENOMEM;
+        data->message = "Out of memory computing the file digest";
+        return EDGEHOG_RESULT_OUT_OF_MEMORY;
+    }
+
+    size_t offset = 0;
+    while (offset < file_size) {
+        size_t read_size = 0;
+        eres = file_cbks->file_read_at(data->file_cbks_ctx, offset, buffer,
+            MIN(DIGEST_READ_BUFFER_SIZE, file_size - offset), &read_size);
+        if ((eres != EDGEHOG_RESULT_OK) || (read_size == 0)) {
+            data->posix_errno = EIO;
+            data->message = "Failed to read back the file for the digest";
+            eres = EDGEHOG_RESULT_INTERNAL_ERROR;
+            break;
+        }
+        psa_status_t status = psa_hash_update(&data->hash_operation, buffer, read_size);
+        if (status != PSA_SUCCESS) {
+            data->posix_errno = EIO;
+            data->message = "Failed to update file digest";
+            eres = EDGEHOG_RESULT_INTERNAL_ERROR;
+            break;
+        }
+        offset += read_size;
+    }
+
+    k_free(buffer);
+    return eres;
+}
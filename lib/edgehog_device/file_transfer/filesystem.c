@@ -84,6 +84,11 @@ static edgehog_result_t write_init(
     void **ctx, edgehog_ft_cbks_t *cbks, size_t expected_file_size, char *destination, bool is_tar);
 static edgehog_result_t write_append_next_entry(void *ctx, const char *file_name);
 static edgehog_result_t write_append(void *ctx, const uint8_t *chunk_data, size_t chunk_size);
+static edgehog_result_t write_at(
+    void *ctx, size_t offset, const uint8_t *chunk_data, size_t chunk_size);
+static edgehog_result_t write_read_at(
+    void *ctx, size_t offset, uint8_t *buffer, size_t buffer_size, size_t *read_size);
+static edgehog_result_t write_rewind(void *ctx);
 static edgehog_result_t write_complete(void *ctx);
 static void write_abort(void *ctx);
 
@@ -121,6 +126,9 @@ void delete_files_callback(const char *path, struct fs_dirent *entry, void *user
 const edgehog_ft_file_write_cbks_t edgehog_ft_filesystem_write_cbks = { .file_init = write_init,
     .file_append_next_entry = write_append_next_entry,
     .file_append_chunk = write_append,
+    .file_write_at = write_at,
+    .file_read_at = write_read_at,
+    .file_rewind = write_rewind,
     .file_complete = write_complete,
     .file_abort = write_abort };
 const edgehog_ft_file_read_cbks_t edgehog_ft_filesystem_read_cbks = { .file_init = read_init,
@@ -168,8 +176,9 @@ static edgehog_result_t write_init(
     // Only open the file immediately if we are NOT extracting a TAR.
     // If it is a TAR, the files will be opened in write_append_next_entry.
     if (!is_tar) {
+        // Opened for reading too, parallel range downloads read the file back for the digest
         // NOLINTNEXTLINE (hicpp-signed-bitwise)
-        int res = fs_open(&wctx->file, destination, FS_O_CREATE | FS_O_WRITE);
+        int res = fs_open(&wctx->file, destination, FS_O_CREATE | FS_O_RDWR);
         if (res != 0) {
             EDGEHOG_LOG_ERR("Failed to open file for writing %s, err %d", destination, res);
             eres = EDGEHOG_RESULT_INTERNAL_ERROR;
@@ -278,6 +287,77 @@ static edgehog_result_t write_append(void *ctx, const uint8_t *chunk_data, size_
     return EDGEHOG_RESULT_OK;
 }
 
+static edgehog_result_t write_at(
+    void *ctx, size_t offset, const uint8_t *chunk_data, size_t chunk_size)
+{
+    write_ctx_t *wctx = (write_ctx_t *) ctx;
+
+    if (!wctx->file_open || wctx->is_tar) {
+        EDGEHOG_LOG_ERR("Attempted to write chunk at offset but no regular file is open");
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    // Seeking past the end of the file is allowed, the gap is filled when the preceding ranges
+    // are written
+    int res = fs_seek(&wctx->file, (off_t) offset, FS_SEEK_SET);
+    if (res != 0) {
+        EDGEHOG_LOG_ERR("Failed to seek file to offset %zu, err %d", offset, res);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    return write_append(ctx, chunk_data, chunk_size);
+}
+
+static edgehog_result_t write_read_at(
+    void *ctx, size_t offset, uint8_t *buffer, size_t buffer_size, size_t *read_size)
+{
+    write_ctx_t *wctx = (write_ctx_t *) ctx;
+
+    if (!wctx->file_open || wctx->is_tar) {
+        EDGEHOG_LOG_ERR("Attempted to read chunk at offset but no regular file is open");
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    int res = fs_seek(&wctx->file, (off_t) offset, FS_SEEK_SET);
+    if (res != 0) {
+        EDGEHOG_LOG_ERR("Failed to seek file to offset %zu, err %d", offset, res);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    ssize_t read_res = fs_read(&wctx->file, buffer, buffer_size);
+    if (read_res < 0) {
+        EDGEHOG_LOG_ERR("Failed to read back file chunk, err %zd", read_res);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    *read_size = (size_t) read_res;
+    return EDGEHOG_RESULT_OK;
+}
+
+static edgehog_result_t write_rewind(void *ctx)
+{
+    write_ctx_t *wctx = (write_ctx_t *) ctx;
+
+    if (!wctx->file_open || wctx->is_tar) {
+        EDGEHOG_LOG_ERR("Attempted to rewind but no regular file is open");
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    int res = fs_seek(&wctx->file, 0, FS_SEEK_SET);
+    if (res != 0) {
+        EDGEHOG_LOG_ERR("Failed to seek file to its beginning, err %d", res);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    res = fs_truncate(&wctx->file, 0);
+    if (res != 0) {
+        EDGEHOG_LOG_ERR("Failed to truncate file, err %d", res);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    return EDGEHOG_RESULT_OK;
+}
+
 static edgehog_result_t write_complete(void *ctx)
 {
     write_ctx_t *wctx = (write_ctx_t *) ctx;
@@ -0,0 +1,41 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "file_transfer/scheduler.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define PRIORITY_AGING_MS CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PRIORITY_AGING_MS
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+size_t edgehog_ft_scheduler_select(
+    size_t count, int64_t now_ms, edgehog_ft_sched_entry_cbk_t entry_cbk, void *user_data)
+{
+    size_t selected = count;
+    int64_t selected_priority = 0;
+    int64_t selected_enqueued_ms = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        edgehog_ft_sched_entry_t entry = { 0 };
+        if (!entry_cbk(i, user_data, &entry)) {
+            continue;
+        }
+        int64_t priority = entry.priority + ((now_ms - entry.enqueued_ms) / PRIORITY_AGING_MS);
+        // Workers fill pending concurrently, so ties are broken on the enqueue time, not on index
+        if ((selected == count) || (priority > selected_priority)
+            || ((priority == selected_priority) && (entry.enqueued_ms < selected_enqueued_ms))) {
+            selected = i;
+            selected_priority = priority;
+            selected_enqueued_ms = entry.enqueued_ms;
+        }
+    }
+    return selected;
+}
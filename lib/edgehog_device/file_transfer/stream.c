@@ -69,6 +69,7 @@ static edgehog_result_t write_init(
     void **ctx, edgehog_ft_cbks_t *cbks, size_t expected_file_size, char *destination, bool is_tar);
 static edgehog_result_t write_append_next_entry(void *ctx, const char *file_name);
 static edgehog_result_t write_append(void *ctx, const uint8_t *chunk_data, size_t chunk_size);
+static edgehog_result_t write_rewind(void *ctx);
 static edgehog_result_t write_complete(void *ctx);
 static void write_abort(void *ctx);
 
@@ -88,6 +89,7 @@ static void read_abort(void *ctx);
 const edgehog_ft_file_write_cbks_t edgehog_ft_stream_write_cbks = { .file_init = write_init,
     .file_append_next_entry = write_append_next_entry,
     .file_append_chunk = write_append,
+    .file_rewind = write_rewind,
     .file_complete = write_complete,
     .file_abort = write_abort };
 const edgehog_ft_file_read_cbks_t edgehog_ft_stream_read_cbks = { .file_init = read_init,
@@ -188,6 +190,19 @@ static edgehog_result_t write_append(void *ctx, const uint8_t *chunk_data, size_
     return EDGEHOG_RESULT_OK;
 }
 
+static edgehog_result_t write_rewind(void *ctx)
+{
+    write_ctx_t *wctx = (write_ctx_t *) ctx;
+
+    // Data already written to the pipe may have been consumed by the application
+    if (wctx->transferred_size > 0) {
+        EDGEHOG_LOG_ERR("Unable to rewind a stream after %zu bytes", wctx->transferred_size);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    return EDGEHOG_RESULT_OK;
+}
+
 static edgehog_result_t write_complete(void *ctx)
 {
     EDGEHOG_LOG_DBG("File write has been completed.");
@@ -156,17 +156,29 @@ void edgehog_ft_handle_device_to_server(
     }
 
     size_t upload_size = 0;
+    bool is_tar = msg->encoding == EDGEHOG_FT_ENCODING_TAR;
+    bool chunked = false;
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CHUNKED_UPLOAD
+    // The size of an archive is unknown until it has been fully produced, skip computing it
+    chunked = is_tar;
+#endif
 
     // Initialize file context on the first chunk
     void *file_cbks_ctx = NULL;
     eres = file_cbks->file_init(&file_cbks_ctx, &edgehog_device->file_transfer->cbks, msg->location,
-        &upload_size, msg->encoding == EDGEHOG_FT_ENCODING_TAR);
+        chunked ? NULL : &upload_size, is_tar);
     if (eres != EDGEHOG_RESULT_OK) {
         posix_errno = EIO;
         message = "Failed to initialize the file backend";
         goto exit;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CHUNKED_UPLOAD
+    // Compressed payloads and streams without an expected size are also of unknown size
+    chunked = chunked || (msg->encoding == EDGEHOG_FT_ENCODING_LZ4)
+        || ((msg->location_type == EDGEHOG_FT_LOCATION_TYPE_STREAMING) && (upload_size == 0));
+#endif
+
     msg->file_size_bytes = upload_size;
 
     // Initialize the user data for the HTTP callback
@@ -185,6 +197,7 @@ void edgehog_ft_handle_device_to_server(
         .header_fields = (const char **) msg->http_headers,
         .timeout_ms = EDGEHOG_FT_HTTP_REQ_TIMEOUT_MS,
         .payload_size = upload_size,
+        .chunked = chunked,
         .payload_cbk = http_put_device_to_server_payload_cbk,
         .user_data = http_cbk_user_data };
     // Perform the HTTP put request to upload the file
@@ -256,6 +256,15 @@ void edgehog_ft_update_progress(
     }
 }
 
+void edgehog_ft_log_throughput(size_t bytes, int64_t elapsed_ms, int connections)
+{
+    // Avoid a division by zero for downloads completed within the same millisecond
+    int64_t elapsed = MAX(elapsed_ms, 1);
+    uint64_t kib_per_s = ((uint64_t) bytes * MSEC_PER_SEC) / ((uint64_t) elapsed * 1024U);
+    EDGEHOG_LOG_INF("Downloaded %zu bytes in %lld ms over %d connection(s): %llu KiB/s", bytes,
+        elapsed_ms, connections, kib_per_s);
+}
+
 void edgehog_ft_send_response(edgehog_device_handle_t device, const struct uuid *identifier,
     edgehog_ft_type_t type, int in_errno, const char *in_msg, edgehog_result_t eres)
 {
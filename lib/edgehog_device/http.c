@@ -5,6 +5,11 @@
  */
 
 #include "http.h"
+#include "http_headers.h"
+#include "http_payload.h"
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+#include "http_pool.h"
+#endif
 
 #include <zephyr/kernel.h>
 #include <zephyr/net/http/client.h>
@@ -12,10 +17,19 @@
 #include <zephyr/net/http/status.h>
 #include <zephyr/net/socket.h>
 
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+#include <zephyr/net/net_event.h>
+#include <zephyr/net/net_mgmt.h>
+#endif
+
 #ifndef CONFIG_EDGEHOG_DEVICE_DEVELOP_USE_NON_TLS_HTTP
 #include <zephyr/net/tls_credentials.h>
 #endif
 
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_HAPPY_EYEBALLS
+#include <zephyr/sys/fdtable.h>
+#endif
+
 #include <stdio.h>
 #include <string.h>
 
@@ -23,6 +37,7 @@
 EDGEHOG_LOG_MODULE_REGISTER(edgehog_http, CONFIG_EDGEHOG_DEVICE_HTTP_LOG_LEVEL);
 
 #define CONTENT_LENGTH_HEADER_BUF_SIZE 64
+#define RANGE_HEADER_BUF_SIZE 64
 
 /************************************************
  *        Defines, constants and typedef        *
@@ -39,6 +54,28 @@ struct request_cbk_ctx
     edgehog_http_response_cbk_t response_cbk;
     /** @brief User data passed to callback functions. */
     void *user_data;
+    /** @brief Set once the payload callback has started sending the request body. */
+    bool payload_sent;
+    /** @brief Set when the payload is sent with chunked transfer encoding. */
+    bool chunked_payload;
+    /** @brief Set once the headers of the response have been fully parsed. */
+    bool headers_received;
+    /** @brief Set when the server allows to keep the connection open after the response. */
+    bool keep_alive;
+    /** @brief Set when the full response message has been received. */
+    bool message_complete;
+    /** @brief Set when the request has been performed as a range request. */
+    bool range_requested;
+    /** @brief First byte requested through a range request, zero when no range is requested. */
+    size_t range_start;
+    /** @brief Buffer receiving the ETag of the response, NULL if not requested. */
+    char *etag;
+    /** @brief Size of the ETag buffer. */
+    size_t etag_size;
+    /** @brief Headers of the response tracked by the client. */
+    http_headers_t headers;
+    /** @brief Status code of the response, zero until the headers have been received. */
+    uint16_t status_code;
 };
 
 /** @brief Data struct holding internal parameters for a generic HTTP request. */
@@ -60,14 +97,62 @@ struct request_data
     http_response_cb_t response_cbk;
     /** @brief Context passed to the HTTP client containing user callbacks and state. */
     struct request_cbk_ctx cbk_ctx;
+    /** @brief Range header for the request, empty when no range is requested. */
+    char range_header[RANGE_HEADER_BUF_SIZE];
+    /** @brief Receive buffer lent by the caller, NULL to allocate one for the request. */
+    uint8_t *recv_buf;
+    /** @brief Size of the receive buffer. */
+    size_t recv_buf_len;
 };
 
 #define PORT_STR_LEN 6
 #define HTTPS_STR "https"
 #define HTTPS_STR_LEN sizeof(HTTPS_STR)
 
-/** @brief Buffer size for formatting chunk length in HTTP chunked transfer encoding. */
-#define HTTP_CHUNKED_PAYLOAD_CHUNK_LENGTH_BUFFER_SIZE 32
+/** @brief Header added to requests with a payload sent using chunked transfer encoding. */
+#define TRANSFER_ENCODING_CHUNKED_HEADER "Transfer-Encoding: chunked\r\n"
+
+/** @brief Maximum size of a host name stored in the DNS cache. */
+#define HOST_MAX_SIZE 128
+/** @brief Maximum number of resolved addresses used for a single host. */
+#define RESOLVED_ADDRESSES_MAX 4
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+/** @brief Connection header added to every request. */
+#define CONNECTION_HEADER "Connection: keep-alive\r\n"
+#else
+#define CONNECTION_HEADER "Connection: close\r\n"
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+/** @brief Interface events invalidating the DNS cache. */
+#define DNS_CACHE_IF_EVENTS (NET_EVENT_IF_UP | NET_EVENT_IF_DOWN)
+/** @brief IPv4 events invalidating the DNS cache. */
+#define DNS_CACHE_IPV4_EVENTS (NET_EVENT_IPV4_ADDR_ADD | NET_EVENT_IPV4_ADDR_DEL)
+/** @brief IPv6 events invalidating the DNS cache. */
+#define DNS_CACHE_IPV6_EVENTS (NET_EVENT_IPV6_ADDR_ADD | NET_EVENT_IPV6_ADDR_DEL)
+
+/** @brief A resolved host stored in the DNS cache. */
+struct dns_cache_entry
+{
+    /** @brief Flag marking the entry as valid. */
+    bool valid;
+    /** @brief Resolved host name. */
+    char host[HOST_MAX_SIZE];
+    /** @brief Resolved service port. */
+    char port[PORT_STR_LEN];
+    /** @brief Resolved addresses, linked through their ai_next field when copied. */
+    struct zsock_addrinfo addrs[RESOLVED_ADDRESSES_MAX];
+    /** @brief Number of valid elements in addrs. */
+    size_t addrs_count;
+    /** @brief Uptime in ms at which the entry has been resolved. */
+    int64_t resolved_at_ms;
+    /** @brief Uptime in ms at which the entry has been last used, for LRU eviction. */
+    int64_t last_used_ms;
+    /** @brief Time in ms taken by the DNS lookup that produced the entry. */
+    int64_t lookup_ms;
+};
+#endif
 
 /************************************************
  *         Static functions declaration         *
@@ -77,29 +162,145 @@ struct request_data
  * @brief Create a new TCP socket and connect it to a server.
  * @note The returned socket should be closed once its use has terminated.
  *
- * @param[in] host domain name, a string representation of an IPv4.
+ * @param[in] host domain name, a string representation of an IPv4 or IPv6.
  * @param[in] port service port, a string representation of HTTP service port.
  * @return -1 upon failure, a file descriptor for the new socket otherwise.
  */
 static int create_and_connect_socket(const char *host, const char *port);
 
 /**
- * @brief Configures, initiates, and manages an HTTP request (GET or PUT).
+ * @brief Resolve a host name, using the DNS cache when available.
+ *
+ * @param[in] host domain name, a string representation of an IPv4 or IPv6.
+ * @param[in] port service port, a string representation of HTTP service port.
+ * @param[out] addrs Array filled with the resolved addresses, linked through ai_next.
+ * @param[out] addrs_count Number of resolved addresses stored in addrs.
+ * @param[out] cached Set to true when the addresses come from the DNS cache.
+ * @return 0 upon success, -1 otherwise.
+ */
+static int resolve_host(const char *host, const char *port,
+    struct zsock_addrinfo addrs[RESOLVED_ADDRESSES_MAX], size_t *addrs_count, bool *cached);
+
+/**
+ * @brief Create a socket and connect it to the first reachable address of a list.
+ *
+ * @param[in] host domain name, used for TLS verification.
+ * @param[in] addrs List of addresses to attempt, linked through ai_next.
+ * @return -1 upon failure, a file descriptor for the socket otherwise.
+ */
+static int connect_to_any(const char *host, const struct zsock_addrinfo *addrs);
+
+/**
+ * @brief Create a socket for an address, with the TLS options set unless TLS is disabled.
+ *
+ * @param[in] host domain name, used for TLS verification.
+ * @param[in] addr Address the socket will be connected to.
+ * @return -1 upon failure, a file descriptor for the socket otherwise.
+ */
+static int create_socket(const char *host, const struct zsock_addrinfo *addr);
+
+#ifndef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_HAPPY_EYEBALLS
+/**
+ * @brief Create a socket and connect it to an address, blocking until connected.
+ *
+ * @param[in] host domain name, used for TLS verification.
+ * @param[in] addr Address to connect to.
+ * @return -1 upon failure, a file descriptor for the socket otherwise.
+ */
+static int connect_to_address(const char *host, const struct zsock_addrinfo *addr);
+#else
+/**
+ * @brief Race connections to a list of addresses, following RFC 8305 (Happy Eyeballs).
+ * @details Attempts are started in order, each one after a delay from the previous one or as
+ * soon as the previous one fails. The first established connection wins and the others are
+ * closed. With TLS a connection is established once its handshake has completed, so an address
+ * that accepts TCP connections but stalls the handshake doesn't win the race. The whole race is
+ * bounded by the connection timeout.
+ *
+ * @param[in] host domain name, used for TLS verification.
+ * @param[in] addrs List of addresses to attempt, linked through ai_next.
+ * @param[out] sock Connected socket, in blocking mode, of the winning address.
+ * @return The winning address, NULL if no connection could be established in time.
+ */
+static const struct zsock_addrinfo *race_connections(
+    const char *host, const struct zsock_addrinfo *addrs, int *sock);
+
+/**
+ * @brief Start a non-blocking connection to an address.
+ *
+ * @param[in] host domain name, used for TLS verification.
+ * @param[in] addr Address to connect to.
+ * @return -1 upon failure, a file descriptor for the connecting socket otherwise.
+ */
+static int start_connection_attempt(const char *host, const struct zsock_addrinfo *addr);
+#endif
+
+/**
+ * @brief Skip to the first address of a list matching, or not matching, a family.
+ *
+ * @param[in] addr First element of the list to search.
+ * @param[in] family Address family to match.
+ * @param[in] same_family Search an address of the family when true, of another family otherwise.
+ * @return The found address, NULL when the end of the list has been reached.
+ */
+static const struct zsock_addrinfo *skip_to_family(
+    const struct zsock_addrinfo *addr, int family, bool same_family);
+
+/**
+ * @brief Copy a linked list of addresses to an array, linking the copied elements.
+ * @details The address families are interleaved, starting from the first family returned by the
+ * resolver, so that connection attempts alternate between IPv6 and IPv4.
+ *
+ * @param[in] src First element of the list to copy.
+ * @param[out] dst Destination array.
+ * @return Number of copied elements.
+ */
+static size_t copy_addrinfo_list(
+    const struct zsock_addrinfo *src, struct zsock_addrinfo dst[RESOLVED_ADDRESSES_MAX]);
+
+/**
+ * @brief Get a connected socket for a server, reusing an idle pooled connection when possible.
+ * @note The returned socket should be released with release_connection once its use has
+ * terminated.
+ *
+ * @param[in] host domain name, a string representation of an IPv4 or IPv6.
+ * @param[in] port service port, a string representation of HTTP service port.
+ * @param[out] reused Set to true when the socket has been taken from the keep-alive pool.
+ * @return -1 upon failure, a file descriptor for the socket otherwise.
+ */
+static int open_connection(const char *host, const char *port, bool *reused);
+
+/**
+ * @brief Release a socket obtained with open_connection.
  *
+ * @details The socket is stored in the keep-alive pool when reusable, it's closed otherwise.
+ *
+ * @param[in] sock The socket to release.
+ * @param[in] host Host the socket is connected to.
+ * @param[in] port Port the socket is connected to.
+ * @param[in] reusable True when the socket is in a clean state and can serve another request.
+ */
+static void release_connection(int sock, const char *host, const char *port, bool reusable);
+
+/**
+ * @brief Send a request over a connected socket and process its response.
+ *
+ * @param[in] sock The connected socket descriptor.
  * @param[in] data Pointer to the internal request configuration structure.
- * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ * @param[in] host Host for the request.
+ * @param[in] path Path, including the query, for the request.
+ * @return The return value of http_client_req.
  */
-static edgehog_result_t perform_request(struct request_data *data);
+static int execute_request(int sock, struct request_data *data, const char *host, const char *path);
 
 /**
- * @brief Helper function to reliably send all bytes of a buffer over a socket.
+ * @brief Configures, initiates, and manages an HTTP request (GET or PUT).
  *
- * @param sock The connected socket descriptor.
- * @param buf Pointer to the data to send.
- * @param len Number of bytes to send.
- * @return The total number of bytes sent, or -1 on error.
+ * @param[in] data Pointer to the internal request configuration structure.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
  */
-static int send_buffer_fully(int sock, const uint8_t *buf, size_t len);
+static edgehog_result_t perform_request(struct request_data *data);
+
 /**
  * @brief Helper function to build the full path (including query) from a parsed URL.
  *
@@ -111,10 +312,155 @@ static int send_buffer_fully(int sock, const uint8_t *buf, size_t len);
 static edgehog_result_t build_full_path(
     const char *url, const struct http_parser_url *parser, char **out_path);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+/**
+ * @brief Take an idle connection to a server out of the keep-alive pool.
+ *
+ * @param[in] host Host of the server.
+ * @param[in] port Port of the server.
+ * @return -1 if no usable connection is present, a connected socket otherwise.
+ */
+static int pool_take(const char *host, const char *port);
+
+/**
+ * @brief Store an idle connection in the keep-alive pool, evicting the oldest one if full.
+ *
+ * @param[in] sock The connected socket to store.
+ * @param[in] host Host the socket is connected to.
+ * @param[in] port Port the socket is connected to.
+ */
+static void pool_put(int sock, const char *host, const char *port);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+/**
+ * @brief Register the network events that flush the DNS cache, if not already done.
+ */
+static void dns_cache_register_events(void);
+
+/**
+ * @brief Look for a valid entry in the DNS cache.
+ *
+ * @param[in] host Host name to look for.
+ * @param[in] port Service port to look for.
+ * @param[out] addrs Array filled with the cached addresses, linked through ai_next.
+ * @param[out] addrs_count Number of addresses stored in addrs.
+ * @return true if a valid entry has been found, false otherwise.
+ */
+static bool dns_cache_lookup(const char *host, const char *port,
+    struct zsock_addrinfo addrs[RESOLVED_ADDRESSES_MAX], size_t *addrs_count);
+
+/**
+ * @brief Store resolved addresses in the DNS cache, evicting the least recently used entry if full.
+ *
+ * @param[in] host Resolved host name.
+ * @param[in] port Resolved service port.
+ * @param[in] addrs Resolved addresses, linked through ai_next.
+ * @param[in] lookup_ms Time taken by the DNS lookup.
+ */
+static void dns_cache_store(
+    const char *host, const char *port, const struct zsock_addrinfo *addrs, int64_t lookup_ms);
+
+/**
+ * @brief Remove a single entry from the DNS cache.
+ *
+ * @param[in] host Host name of the entry.
+ * @param[in] port Service port of the entry.
+ */
+static void dns_cache_invalidate(const char *host, const char *port);
+#endif
+
 /************************************************
  *       Callbacks definition/declaration       *
  ***********************************************/
 
+/**
+ * @brief Retrieve the request context from an HTTP parser owned by the Zephyr HTTP client.
+ */
+static struct request_cbk_ctx *parser_to_ctx(struct http_parser *parser)
+{
+    struct http_request *req = CONTAINER_OF(parser, struct http_request, internal.parser);
+    return (struct request_cbk_ctx *) req->internal.user_data;
+}
+
+static int on_header_field_cbk(struct http_parser *parser, const char *at, size_t length)
+{
+    struct request_cbk_ctx *ctx = parser_to_ctx(parser);
+    http_headers_on_field(&ctx->headers, at, length);
+    return 0;
+}
+
+static int on_header_value_cbk(struct http_parser *parser, const char *at, size_t length)
+{
+    struct request_cbk_ctx *ctx = parser_to_ctx(parser);
+    http_headers_on_value(&ctx->headers, at, length);
+    return 0;
+}
+
+static int on_headers_complete_cbk(struct http_parser *parser)
+{
+    struct request_cbk_ctx *ctx = parser_to_ctx(parser);
+    http_headers_on_complete(&ctx->headers);
+    ctx->headers_received = true;
+    ctx->status_code = (uint16_t) parser->status_code;
+    ctx->keep_alive = (http_should_keep_alive(parser) != 0);
+    return 0;
+}
+
+static int on_message_complete_cbk(struct http_parser *parser)
+{
+    struct request_cbk_ctx *ctx = parser_to_ctx(parser);
+    ctx->message_complete = true;
+    return 0;
+}
+
+/** @brief HTTP parser callbacks used to track the connection state of each response. */
+static const struct http_parser_settings http_parser_cbks = {
+    .on_header_field = on_header_field_cbk,
+    .on_header_value = on_header_value_cbk,
+    .on_headers_complete = on_headers_complete_cbk,
+    .on_message_complete = on_message_complete_cbk,
+};
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+static void pool_expiry_work_handler(struct k_work *work);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+static void dns_cache_net_event_handler(
+    struct net_mgmt_event_callback *cb, uint64_t mgmt_event, struct net_if *iface)
+{
+    ARG_UNUSED(cb);
+    ARG_UNUSED(iface);
+    EDGEHOG_LOG_DBG("Network event 0x%llx received, flushing the DNS cache",
+        (unsigned long long) mgmt_event);
+    edgehog_http_flush_dns_cache();
+}
+#endif
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+static http_pool_t conn_pool;
+K_MUTEX_DEFINE(conn_pool_mutex);
+K_WORK_DELAYABLE_DEFINE(pool_expiry_work, pool_expiry_work_handler);
+static atomic_t stat_pool_hits;
+static atomic_t stat_pool_misses;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+static struct dns_cache_entry dns_cache[CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE_SIZE];
+K_MUTEX_DEFINE(dns_cache_mutex);
+static struct net_mgmt_event_callback dns_cache_if_cb;
+static struct net_mgmt_event_callback dns_cache_ipv4_cb;
+#ifdef CONFIG_NET_IPV6
+static struct net_mgmt_event_callback dns_cache_ipv6_cb;
+#endif
+static atomic_t dns_cache_events_registered;
+static uint64_t stat_dns_time_saved_ms;
+static atomic_t stat_dns_cache_hits;
+static atomic_t stat_dns_cache_misses;
+#endif
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
 /**
  * @brief Internal Zephyr callback invoked when an HTTP response chunk is received.
  *
@@ -147,6 +493,21 @@ static int get_response_cbk(
     }
 
     edgehog_http_response_chunk_t http_response_chunk = { 0 };
+    if (rsp->http_status_code == HTTP_206_PARTIAL_CONTENT) {
+        if (!ctx->range_requested) {
+            EDGEHOG_LOG_ERR("Partial content received for a request without range");
+            ctx->result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+            return -1;
+        }
+        if (ctx->headers.content_range_found
+            && (ctx->headers.content_range_start != ctx->range_start)) {
+            EDGEHOG_LOG_ERR("Unexpected range start %zu, requested %zu",
+                ctx->headers.content_range_start, ctx->range_start);
+            ctx->result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+            return -1;
+        }
+        http_response_chunk.range_offset = ctx->range_start;
+    }
     if (rsp->body_found) {
         EDGEHOG_LOG_DBG("Processing body fragment of size %zu.", rsp->body_frag_len);
         http_response_chunk.chunk_start_addr = rsp->body_frag_start;
@@ -154,8 +515,11 @@ static int get_response_cbk(
     } else {
         EDGEHOG_LOG_DBG("Empty body found in HTTP response chunk");
     }
+    // A connection closed before the declared content length has been received is reported as
+    // final, it should not be handed to the user as the last chunk of the response
+    bool truncated = (final_data == HTTP_DATA_FINAL) && rsp->cl_present && !ctx->message_complete;
     http_response_chunk.response_size = rsp->content_length;
-    http_response_chunk.last_chunk = (final_data == HTTP_DATA_FINAL);
+    http_response_chunk.last_chunk = (final_data == HTTP_DATA_FINAL) && !truncated;
 
     if (final_data == HTTP_DATA_FINAL) {
         EDGEHOG_LOG_DBG("All HTTP data received for this response.");
@@ -163,11 +527,17 @@ static int get_response_cbk(
         EDGEHOG_LOG_DBG("Awaiting more HTTP data...");
     }
 
-    ctx->result = ctx->response_cbk(&http_response_chunk, ctx->user_data);
+    ctx->result = ctx->response_cbk ? ctx->response_cbk(&http_response_chunk, ctx->user_data)
+                                    : EDGEHOG_RESULT_OK;
     if (ctx->result != EDGEHOG_RESULT_OK) {
         EDGEHOG_LOG_ERR("HTTP response user callback error: %d", ctx->result);
         return -1;
     }
+    if (truncated) {
+        EDGEHOG_LOG_ERR("Connection closed before the end of the response");
+        ctx->result = EDGEHOG_RESULT_NETWORK_ERROR;
+        return -1;
+    }
     return 0;
 }
 
@@ -222,42 +592,9 @@ static int put_payload_cbk(int sock, struct http_request * /*req*/, void *user_d
     }
 
     struct request_cbk_ctx *ctx = (struct request_cbk_ctx *) user_data;
-    int total_sent_bytes = 0;
-    edgehog_http_payload_chunk_t http_payload_chunk = { 0 };
-
-    while (!http_payload_chunk.last_chunk) {
-        // Clear the previous chunk information
-        memset(&http_payload_chunk, 0, sizeof(http_payload_chunk));
-
-        // Get the next chunk to upload from the user callback
-        ctx->result = ctx->payload_cbk(&http_payload_chunk, ctx->user_data);
-        if (ctx->result != EDGEHOG_RESULT_OK) {
-            EDGEHOG_LOG_ERR("HTTP payload user callback error: %d", ctx->result);
-            return -EIO;
-        }
-
-        EDGEHOG_LOG_DBG("Retrieved payload chunk from user callback. Size: %zu, Last chunk: %d",
-            http_payload_chunk.chunk_size, http_payload_chunk.last_chunk);
-
-        // Send the raw chunk directly to the socket without HTTP chunk wrappers
-        if (http_payload_chunk.chunk_size > 0) {
-            int sent_bytes = send_buffer_fully(
-                sock, http_payload_chunk.chunk_start_addr, http_payload_chunk.chunk_size);
-            if (sent_bytes < 0) {
-                EDGEHOG_LOG_ERR("Failed to send chunk payload: %d", sent_bytes);
-                ctx->result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
-                return -EIO;
-            }
-            total_sent_bytes += sent_bytes;
-
-            EDGEHOG_LOG_DBG("Sent raw chunk of size %zu bytes. Total sent so far: %d",
-                http_payload_chunk.chunk_size, total_sent_bytes);
-        }
-    }
-
-    EDGEHOG_LOG_DBG("Finished sending all payload chunks. Total bytes sent: %d", total_sent_bytes);
-
-    return total_sent_bytes;
+    ctx->payload_sent = true;
+    return http_payload_send(
+        sock, ctx->chunked_payload, ctx->payload_cbk, ctx->user_data, &ctx->result);
 }
 
 /************************************************
@@ -283,9 +620,72 @@ edgehog_result_t edgehog_http_get(edgehog_http_get_data_t *data)
                 .payload_cbk = NULL,
                 .response_cbk = data->response_cbk,
                 .user_data = data->user_data,
+                .range_requested = (data->range_start > 0) || (data->range_size > 0),
+                .range_start = data->range_start,
+                .etag = data->etag,
+                .etag_size = data->etag ? data->etag_size : 0,
+            },
+        .recv_buf = data->recv_buf,
+        .recv_buf_len = data->recv_buf ? data->recv_buf_size : 0,
+    };
+    if (data->etag && (data->etag_size > 0)) {
+        data->etag[0] = '\0';
+    }
+
+    if (req_data.cbk_ctx.range_requested) {
+        int snprintf_rc = 0;
+        if (data->range_size > 0) {
+            snprintf_rc = snprintf(req_data.range_header, RANGE_HEADER_BUF_SIZE,
+                "Range: bytes=%zu-%zu\r\n", data->range_start,
+                data->range_start + data->range_size - 1);
+        } else {
+            snprintf_rc = snprintf(req_data.range_header, RANGE_HEADER_BUF_SIZE,
+                "Range: bytes=%zu-\r\n", data->range_start);
+        }
+        if ((snprintf_rc < 0) || (snprintf_rc >= RANGE_HEADER_BUF_SIZE)) {
+            EDGEHOG_LOG_ERR("Error formatting the Range header");
+            return EDGEHOG_RESULT_INTERNAL_ERROR;
+        }
+        EDGEHOG_LOG_DBG("Requesting range starting at byte %zu", data->range_start);
+    }
+
+    edgehog_result_t eres = perform_request(&req_data);
+    data->status_code = req_data.cbk_ctx.status_code;
+    data->retry_after_s = req_data.cbk_ctx.headers.retry_after_s;
+    return eres;
+}
+
+edgehog_result_t edgehog_http_head(edgehog_http_get_data_t *data)
+{
+    EDGEHOG_LOG_DBG(
+        "Initiating HTTP HEAD request to URL: %s (Timeout: %d ms)", data->url, data->timeout_ms);
+
+    struct request_data req_data = {
+        .method = HTTP_HEAD,
+        .url = data->url,
+        .header_fields = data->header_fields,
+        .timeout_ms = data->timeout_ms,
+        .payload_len = 0,
+        .payload_cbk = NULL,
+        .response_cbk = get_response_cbk,
+        .cbk_ctx =
+            {
+                .result = EDGEHOG_RESULT_OK,
+                .payload_cbk = NULL,
+                .response_cbk = data->response_cbk,
+                .user_data = data->user_data,
+                .etag = data->etag,
+                .etag_size = data->etag ? data->etag_size : 0,
             },
     };
-    return perform_request(&req_data);
+    if (data->etag && (data->etag_size > 0)) {
+        data->etag[0] = '\0';
+    }
+
+    edgehog_result_t eres = perform_request(&req_data);
+    data->status_code = req_data.cbk_ctx.status_code;
+    data->retry_after_s = req_data.cbk_ctx.headers.retry_after_s;
+    return eres;
 }
 
 edgehog_result_t edgehog_http_put(edgehog_http_put_data_t *data)
@@ -298,12 +698,15 @@ edgehog_result_t edgehog_http_put(edgehog_http_put_data_t *data)
         for (size_t i = 0; data->header_fields[i] != NULL; i++) {
             const char *header = data->header_fields[i];
 
-            // Check for "Content-Length:" headers
+            // Check for "Content-Length:" and "Transfer-Encoding:" headers
             // If found, return immediately with an error to prevent conflicting upload directives.
             char content_length[] = "Content-Length: ";
             size_t content_length_len = sizeof(content_length) - 1;
+            char transfer_encoding[] = "Transfer-Encoding: ";
+            size_t transfer_encoding_len = sizeof(transfer_encoding) - 1;
 
-            if (strncmp(header, content_length, content_length_len) == 0) {
+            if ((strncmp(header, content_length, content_length_len) == 0)
+                || (strncmp(header, transfer_encoding, transfer_encoding_len) == 0)) {
                 EDGEHOG_LOG_ERR("Conflicting header provided by user: %s", header);
                 return EDGEHOG_RESULT_HTTP_REQUEST_INVALID_HEADERS;
             }
@@ -315,7 +718,8 @@ edgehog_result_t edgehog_http_put(edgehog_http_put_data_t *data)
         .url = data->url,
         .header_fields = data->header_fields,
         .timeout_ms = data->timeout_ms,
-        .payload_len = data->payload_size,
+        // Zephyr omits the Content-Length header when the payload length is zero
+        .payload_len = data->chunked ? 0 : data->payload_size,
         .payload_cbk = put_payload_cbk,
         .response_cbk = put_response_cbk,
         .cbk_ctx = {
@@ -323,6 +727,7 @@ edgehog_result_t edgehog_http_put(edgehog_http_put_data_t *data)
             .payload_cbk = data->payload_cbk,
             .response_cbk = NULL,
             .user_data = data->user_data,
+            .chunked_payload = data->chunked,
         },
     };
 
@@ -331,19 +736,122 @@ edgehog_result_t edgehog_http_put(edgehog_http_put_data_t *data)
     return result;
 }
 
+bool edgehog_http_is_retryable_status(uint16_t status_code)
+{
+    if ((status_code < HTTP_400_BAD_REQUEST) || (status_code >= HTTP_500_INTERNAL_SERVER_ERROR)) {
+        return true;
+    }
+    return (status_code == HTTP_408_REQUEST_TIMEOUT) || (status_code == HTTP_425_TOO_EARLY)
+        || (status_code == HTTP_429_TOO_MANY_REQUESTS);
+}
+
+void edgehog_http_close_idle_connections(void)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+    k_mutex_lock(&conn_pool_mutex, K_FOREVER);
+    http_pool_close_all(&conn_pool);
+    k_mutex_unlock(&conn_pool_mutex);
+#endif
+}
+
+void edgehog_http_get_stats(edgehog_http_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(edgehog_http_stats_t));
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+    stats->pool_hits = (uint32_t) atomic_get(&stat_pool_hits);
+    stats->pool_misses = (uint32_t) atomic_get(&stat_pool_misses);
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+    stats->dns_cache_hits = (uint32_t) atomic_get(&stat_dns_cache_hits);
+    stats->dns_cache_misses = (uint32_t) atomic_get(&stat_dns_cache_misses);
+    k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+    stats->dns_time_saved_ms = stat_dns_time_saved_ms;
+    k_mutex_unlock(&dns_cache_mutex);
+#endif
+}
+
+void edgehog_http_flush_dns_cache(void)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+    k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+    for (size_t i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+        dns_cache[i].valid = false;
+    }
+    k_mutex_unlock(&dns_cache_mutex);
+#endif
+}
+
 /************************************************
  *         Static functions definitions         *
  ***********************************************/
 
 static int create_and_connect_socket(const char *hostname, const char *port)
 {
-    EDGEHOG_LOG_DBG("Attempting DNS resolution for %s:%s", hostname, port);
+    struct zsock_addrinfo addrs[RESOLVED_ADDRESSES_MAX];
+    size_t addrs_count = 0;
+    bool cached = false;
+
+    if (resolve_host(hostname, port, addrs, &addrs_count, &cached) != 0) {
+        return -1;
+    }
+
+    EDGEHOG_LOG_DBG("Iterating through %zu available addresses.", addrs_count);
+    int sock = connect_to_any(hostname, addrs);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+    // Cached addresses could be outdated, resolve the host again before giving up
+    if ((sock == -1) && cached) {
+        EDGEHOG_LOG_WRN("Cached addresses for %s unreachable, resolving again", hostname);
+        dns_cache_invalidate(hostname, port);
+        if (resolve_host(hostname, port, addrs, &addrs_count, &cached) != 0) {
+            return -1;
+        }
+        sock = connect_to_any(hostname, addrs);
+    }
+#endif
+
+    // Check if we exhausted the list without a successful connection
+    if (sock == -1) {
+        EDGEHOG_LOG_ERR("Failed to connect to any resolved address. Exhausted all DNS records.");
+    }
+
+    return sock;
+}
+
+static int resolve_host(const char *host, const char *port,
+    struct zsock_addrinfo addrs[RESOLVED_ADDRESSES_MAX], size_t *addrs_count, bool *cached)
+{
+    *cached = false;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+    dns_cache_register_events();
+    if (dns_cache_lookup(host, port, addrs, addrs_count)) {
+        EDGEHOG_LOG_DBG("DNS cache hit for %s:%s", host, port);
+        atomic_inc(&stat_dns_cache_hits);
+        *cached = true;
+        return 0;
+    }
+    atomic_inc(&stat_dns_cache_misses);
+#endif
+
+    EDGEHOG_LOG_DBG("Attempting DNS resolution for %s:%s", host, port);
 
     struct zsock_addrinfo hints = { 0 };
+#if defined(CONFIG_NET_IPV4) && defined(CONFIG_NET_IPV6)
+    hints.ai_family = AF_UNSPEC;
+#elif defined(CONFIG_NET_IPV6)
+    hints.ai_family = AF_INET6;
+#else
     hints.ai_family = AF_INET;
+#endif
     hints.ai_socktype = SOCK_STREAM;
     struct zsock_addrinfo *host_addrinfo = NULL;
-    int getaddrinfo_rc = zsock_getaddrinfo(hostname, port, &hints, &host_addrinfo);
+    int64_t lookup_start_ms = k_uptime_get();
+    int getaddrinfo_rc = zsock_getaddrinfo(host, port, &hints, &host_addrinfo);
     if (getaddrinfo_rc != 0) {
         EDGEHOG_LOG_ERR("Unable to resolve address (%d) %s", getaddrinfo_rc,
             zsock_gai_strerror(getaddrinfo_rc));
@@ -352,9 +860,48 @@ static int create_and_connect_socket(const char *hostname, const char *port)
         }
         return -1;
     }
+    int64_t lookup_ms = k_uptime_get() - lookup_start_ms;
+
+    EDGEHOG_LOG_DBG("DNS resolution successful in %lld ms.", (long long) lookup_ms);
 
-    EDGEHOG_LOG_DBG("DNS resolution successful. Iterating through available addresses.");
+    *addrs_count = copy_addrinfo_list(host_addrinfo, addrs);
+    zsock_freeaddrinfo(host_addrinfo);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+    dns_cache_store(host, port, addrs, lookup_ms);
+#else
+    ARG_UNUSED(lookup_ms);
+#endif
+
+    return 0;
+}
+
+static int connect_to_any(const char *hostname, const struct zsock_addrinfo *addrs)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_HAPPY_EYEBALLS
+    int sock = -1;
+    if (!race_connections(hostname, addrs, &sock)) {
+        return -1;
+    }
+    return sock;
+#else
+    int sock = -1;
+
+    // Iterate through the linked list of resolved addresses
+    for (const struct zsock_addrinfo *curr_addr = addrs; curr_addr != NULL;
+        curr_addr = curr_addr->ai_next) {
+        sock = connect_to_address(hostname, curr_addr);
+        if (sock != -1) {
+            break;
+        }
+    }
+
+    return sock;
+#endif
+}
+
+static int create_socket(const char *hostname, const struct zsock_addrinfo *addr)
+{
 #ifdef CONFIG_EDGEHOG_DEVICE_DEVELOP_USE_NON_TLS_HTTP
     int proto = IPPROTO_TCP;
     EDGEHOG_LOG_DBG("Using cleartext TCP (IPPROTO_TCP)");
@@ -363,78 +910,249 @@ static int create_and_connect_socket(const char *hostname, const char *port)
     EDGEHOG_LOG_DBG("Using secure TLS (IPPROTO_TLS_1_2)");
 #endif
 
-    int sock = -1;
-    struct zsock_addrinfo *curr_addr = NULL;
-
-    // Iterate through the linked list of resolved addresses
-    for (curr_addr = host_addrinfo; curr_addr != NULL; curr_addr = curr_addr->ai_next) {
-        EDGEHOG_LOG_DBG("Attempting to create socket (family: %d, socktype: %d, proto: %d)",
-            curr_addr->ai_family, curr_addr->ai_socktype, proto);
+    EDGEHOG_LOG_DBG("Attempting to create socket (family: %d, socktype: %d, proto: %d)",
+        addr->ai_family, addr->ai_socktype, proto);
 
-        sock = zsock_socket(curr_addr->ai_family, curr_addr->ai_socktype, proto);
-        if (sock == -1) {
-            EDGEHOG_LOG_DBG("Socket creation failed for this address, trying next address...");
-            continue;
-        }
+    int sock = zsock_socket(addr->ai_family, addr->ai_socktype, proto);
+    if (sock == -1) {
+        EDGEHOG_LOG_DBG("Socket creation failed for this address.");
+        return -1;
+    }
 
-        EDGEHOG_LOG_DBG("Socket successfully created (fd: %d). Applying options.", sock);
+    EDGEHOG_LOG_DBG("Socket successfully created (fd: %d). Applying options.", sock);
 
 #ifndef CONFIG_EDGEHOG_DEVICE_DEVELOP_USE_NON_TLS_HTTP
-        // While the file transfer is optional the OTA is mandatory, so the OTA HTTPs
-        // certificate will always be set.
-        sec_tag_t sec_tag_opt[] = {
-            CONFIG_EDGEHOG_DEVICE_OTA_HTTPS_CA_CERT_TAG,
+    // While the file transfer is optional the OTA is mandatory, so the OTA HTTPs
+    // certificate will always be set.
+    sec_tag_t sec_tag_opt[] = {
+        CONFIG_EDGEHOG_DEVICE_OTA_HTTPS_CA_CERT_TAG,
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HTTPS_CA_CERT_TAG
-            CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HTTPS_CA_CERT_TAG,
+        CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HTTPS_CA_CERT_TAG,
 #endif
-        };
+    };
 
-        EDGEHOG_LOG_DBG("Setting TLS_SEC_TAG_LIST option.");
-        int sockopt_rc
-            = zsock_setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tag_opt, sizeof(sec_tag_opt));
-        if (sockopt_rc == -1) {
-            EDGEHOG_LOG_ERR("Socket options error (TLS_SEC_TAG_LIST): %d", sockopt_rc);
-            zsock_close(sock);
-            sock = -1;
-            continue;
+    EDGEHOG_LOG_DBG("Setting TLS_SEC_TAG_LIST option.");
+    int sockopt_rc
+        = zsock_setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tag_opt, sizeof(sec_tag_opt));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_ERR("Socket options error (TLS_SEC_TAG_LIST): %d", sockopt_rc);
+        zsock_close(sock);
+        return -1;
+    }
+
+    EDGEHOG_LOG_DBG("Setting TLS_HOSTNAME option to '%s'.", hostname);
+    sockopt_rc = zsock_setsockopt(sock, SOL_TLS, TLS_HOSTNAME, hostname, strlen(hostname));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_ERR("Socket options error (TLS_HOSTNAME): %d", sockopt_rc);
+        zsock_close(sock);
+        return -1;
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_TLS_SESSION_CACHE
+    // A failure here only costs a full handshake, so it's not treated as fatal
+    EDGEHOG_LOG_DBG("Setting TLS_SESSION_CACHE option.");
+    int session_cache = TLS_SESSION_CACHE_ENABLED;
+    sockopt_rc
+        = zsock_setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &session_cache, sizeof(session_cache));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_WRN("Socket options error (TLS_SESSION_CACHE): %d", errno);
+    }
+#endif
+#else
+    ARG_UNUSED(hostname);
+#endif
+
+    return sock;
+}
+
+#ifndef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_HAPPY_EYEBALLS
+static int connect_to_address(const char *hostname, const struct zsock_addrinfo *addr)
+{
+    int sock = create_socket(hostname, addr);
+    if (sock == -1) {
+        return -1;
+    }
+
+    EDGEHOG_LOG_DBG("Attempting to connect socket %d to remote address.", sock);
+    int connect_rc = zsock_connect(sock, addr->ai_addr, addr->ai_addrlen);
+    if (connect_rc == -1) {
+        EDGEHOG_LOG_DBG("Connection failed (%d -  %s), closing socket.", errno, strerror(errno));
+        zsock_close(sock);
+        return -1;
+    }
+
+    EDGEHOG_LOG_DBG("Successfully connected socket %d.", sock);
+    return sock;
+}
+#else
+static const struct zsock_addrinfo *race_connections(
+    const char *hostname, const struct zsock_addrinfo *addrs, int *sock)
+{
+    struct zsock_pollfd fds[RESOLVED_ADDRESSES_MAX] = { 0 };
+    const struct zsock_addrinfo *fds_addrs[RESOLVED_ADDRESSES_MAX] = { 0 };
+    size_t fds_count = 0;
+    const struct zsock_addrinfo *next_addr = addrs;
+    const struct zsock_addrinfo *winner = NULL;
+    int64_t start_ms = k_uptime_get();
+    int64_t deadline_ms = start_ms + CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_CONNECT_TIMEOUT_MS;
+    int64_t next_attempt_ms = start_ms;
+
+    while (!winner) {
+        int64_t now = k_uptime_get();
+        if (now >= deadline_ms) {
+            EDGEHOG_LOG_ERR("Connection establishment timed out after %lld ms",
+                (long long) (now - start_ms));
+            break;
         }
 
-        EDGEHOG_LOG_DBG("Setting TLS_HOSTNAME option to '%s'.", hostname);
-        sockopt_rc = zsock_setsockopt(sock, SOL_TLS, TLS_HOSTNAME, hostname, strlen(hostname));
-        if (sockopt_rc == -1) {
-            EDGEHOG_LOG_ERR("Socket options error (TLS_HOSTNAME): %d", sockopt_rc);
-            zsock_close(sock);
-            sock = -1;
+        // Start the next attempt once the delay from the previous one has elapsed, or right away
+        // when no attempt is in progress
+        if (next_addr && ((now >= next_attempt_ms) || (fds_count == 0))) {
+            int attempt_sock = start_connection_attempt(hostname, next_addr);
+            if (attempt_sock != -1) {
+                fds[fds_count].fd = attempt_sock;
+                fds[fds_count].events = ZSOCK_POLLOUT;
+                fds_addrs[fds_count] = next_addr;
+                fds_count++;
+                next_attempt_ms
+                    = now + CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_CONNECTION_ATTEMPT_DELAY_MS;
+            }
+            next_addr = next_addr->ai_next;
             continue;
         }
-#endif
+        if (fds_count == 0) {
+            break;
+        }
 
-        EDGEHOG_LOG_DBG("Attempting to connect socket %d to remote address.", sock);
-        int connect_rc = zsock_connect(sock, curr_addr->ai_addr, curr_addr->ai_addrlen);
-        if (connect_rc == -1) {
-            EDGEHOG_LOG_DBG(
-                "Connection failed (%d -  %s), closing socket and trying next address...", errno,
-                strerror(errno));
-            zsock_close(sock);
-            sock = -1;
-            continue;
+        int64_t timeout_ms = deadline_ms - now;
+        if (next_addr) {
+            timeout_ms = MIN(timeout_ms, next_attempt_ms - now);
+        }
+        int poll_rc = zsock_poll(fds, (int) fds_count, (int) timeout_ms);
+        if (poll_rc < 0) {
+            EDGEHOG_LOG_ERR("Polling connection attempts failed: %d", errno);
+            break;
         }
 
-        // If we reach here, we have successfully connected
-        EDGEHOG_LOG_DBG("Successfully connected socket %d.", sock);
-        break;
+        for (size_t i = 0; i < fds_count;) {
+            if (fds[i].revents == 0) {
+                i++;
+                continue;
+            }
+            int so_error = 0;
+            socklen_t so_error_len = sizeof(so_error);
+            int sockopt_rc
+                = zsock_getsockopt(fds[i].fd, SOL_SOCKET, SO_ERROR, &so_error, &so_error_len);
+            if (!winner && (fds[i].revents & ZSOCK_POLLOUT) && (sockopt_rc == 0)
+                && (so_error == 0)) {
+                winner = fds_addrs[i];
+                *sock = fds[i].fd;
+            } else {
+                EDGEHOG_LOG_DBG("Connection attempt failed (%d), closing socket.", so_error);
+                zsock_close(fds[i].fd);
+                // A failed attempt lets the next one start immediately
+                next_attempt_ms = now;
+            }
+            // Remove the attempt swapping it with the last one
+            fds_count--;
+            fds[i] = fds[fds_count];
+            fds_addrs[i] = fds_addrs[fds_count];
+        }
     }
 
-    // Free the linked list after we are done iterating
-    zsock_freeaddrinfo(host_addrinfo);
+    for (size_t i = 0; i < fds_count; i++) {
+        zsock_close(fds[i].fd);
+    }
 
-    // Check if we exhausted the list without a successful connection
+    if (!winner) {
+        return NULL;
+    }
+
+    // The connection is handed over in blocking mode, as the HTTP client expects
+    int flags = zsock_fcntl(*sock, ZVFS_F_GETFL, 0);
+    if ((flags == -1) || (zsock_fcntl(*sock, ZVFS_F_SETFL, flags & ~ZVFS_O_NONBLOCK) == -1)) {
+        EDGEHOG_LOG_ERR("Unable to restore blocking mode on socket %d", *sock);
+        zsock_close(*sock);
+        *sock = -1;
+        return NULL;
+    }
+
+    EDGEHOG_LOG_DBG("Connection established with family %d in %lld ms", winner->ai_family,
+        (long long) (k_uptime_get() - start_ms));
+    return winner;
+}
+
+static int start_connection_attempt(const char *hostname, const struct zsock_addrinfo *addr)
+{
+    int sock = create_socket(hostname, addr);
     if (sock == -1) {
-        EDGEHOG_LOG_ERR("Failed to connect to any resolved address. Exhausted all DNS records.");
+        return -1;
+    }
+
+    int flags = zsock_fcntl(sock, ZVFS_F_GETFL, 0);
+    if ((flags == -1) || (zsock_fcntl(sock, ZVFS_F_SETFL, flags | ZVFS_O_NONBLOCK) == -1)) {
+        EDGEHOG_LOG_DBG("Unable to set non-blocking mode on socket %d.", sock);
+        zsock_close(sock);
+        return -1;
+    }
+
+    // A non-blocking TLS socket performs the handshake in the background, the socket is
+    // reported writable once the handshake has completed
+    int connect_rc = zsock_connect(sock, addr->ai_addr, addr->ai_addrlen);
+    if ((connect_rc == -1) && (errno != EINPROGRESS)) {
+        EDGEHOG_LOG_DBG("Connection failed (%d -  %s), closing socket.", errno, strerror(errno));
+        zsock_close(sock);
+        return -1;
     }
 
     return sock;
 }
+#endif
+
+static const struct zsock_addrinfo *skip_to_family(
+    const struct zsock_addrinfo *addr, int family, bool same_family)
+{
+    while (addr && ((addr->ai_family == family) != same_family)) {
+        addr = addr->ai_next;
+    }
+    return addr;
+}
+
+static size_t copy_addrinfo_list(
+    const struct zsock_addrinfo *src, struct zsock_addrinfo dst[RESOLVED_ADDRESSES_MAX])
+{
+    size_t count = 0;
+    int first_family = src ? src->ai_family : AF_UNSPEC;
+    const struct zsock_addrinfo *first = src;
+    const struct zsock_addrinfo *other = src;
+    bool take_first = true;
+
+    while (count < RESOLVED_ADDRESSES_MAX) {
+        first = skip_to_family(first, first_family, true);
+        other = skip_to_family(other, first_family, false);
+        const struct zsock_addrinfo *curr = ((take_first && first) || !other) ? first : other;
+        if (!curr) {
+            break;
+        }
+        if (curr == first) {
+            first = first->ai_next;
+        } else {
+            other = other->ai_next;
+        }
+        take_first = !take_first;
+
+        dst[count] = *curr;
+        // Point to the address stored inside the copied element instead of the source one
+        dst[count].ai_addr = &dst[count]._ai_addr;
+        dst[count].ai_canonname = NULL;
+        dst[count].ai_next = NULL;
+        if (count > 0) {
+            dst[count - 1].ai_next = &dst[count];
+        }
+        count++;
+    }
+    return count;
+}
 
 static edgehog_result_t perform_request(struct request_data *data)
 {
@@ -475,38 +1193,107 @@ static edgehog_result_t perform_request(struct request_data *data)
 
     EDGEHOG_LOG_DBG("Parsed URL correctly. Host: %s, Port: %s", host, port);
 
-    int sock = create_and_connect_socket(host, port);
-    if (sock < 0) {
-        EDGEHOG_LOG_ERR(
-            "Aborting HTTP request due to socket creation/connection failure (err %d)", sock);
-        return EDGEHOG_RESULT_NETWORK_ERROR;
-    }
-
     char *full_path = NULL;
     edgehog_result_t path_res = build_full_path(data->url, &parser, &full_path);
     if (path_res != EDGEHOG_RESULT_OK) {
-        zsock_close(sock);
         return path_res;
     }
 
     EDGEHOG_LOG_DBG("Extracted path with query: %s", full_path);
 
-    // Perform the HTTP request and wait for the response
-    uint8_t *recv_buf = k_malloc(CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE);
-    if (recv_buf == NULL) {
-        EDGEHOG_LOG_ERR("Failed to allocate memory for recv_buf");
-        k_free(full_path);
+    // Receive into the buffer lent by the caller if any, to let it consume the body in place
+    uint8_t *allocated_buf = NULL;
+    if (!data->recv_buf) {
+        allocated_buf = k_malloc(CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE);
+        if (allocated_buf == NULL) {
+            EDGEHOG_LOG_ERR("Failed to allocate memory for recv_buf");
+            k_free(full_path);
+            return EDGEHOG_RESULT_OUT_OF_MEMORY;
+        }
+        data->recv_buf = allocated_buf;
+        data->recv_buf_len = CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE;
+    }
+
+    bool reused = false;
+    int sock = open_connection(host, port, &reused);
+    if (sock < 0) {
+        EDGEHOG_LOG_ERR(
+            "Aborting HTTP request due to socket creation/connection failure (err %d)", sock);
+        eres = EDGEHOG_RESULT_NETWORK_ERROR;
+        goto exit;
+    }
+
+    int http_rc = execute_request(sock, data, host, full_path);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+    // A pooled connection may have been closed by the server while idle, in such case the
+    // request is transparently retried over a fresh connection if nothing has been exchanged.
+    if (reused && (http_rc < 0) && !data->cbk_ctx.payload_sent
+        && !data->cbk_ctx.headers_received) {
+        EDGEHOG_LOG_WRN("Reused connection failed (%d), retrying on a new connection", http_rc);
         zsock_close(sock);
-        return EDGEHOG_RESULT_OUT_OF_MEMORY;
+        atomic_inc(&stat_pool_misses);
+        sock = create_and_connect_socket(host, port);
+        if (sock < 0) {
+            EDGEHOG_LOG_ERR("Aborting HTTP request due to socket creation/connection failure");
+            eres = EDGEHOG_RESULT_NETWORK_ERROR;
+            goto exit;
+        }
+        http_rc = execute_request(sock, data, host, full_path);
+    }
+#endif
+
+    EDGEHOG_LOG_DBG("http_client_req returned with code: %d", http_rc);
+
+    if (http_rc < 0) {
+        EDGEHOG_LOG_ERR("HTTP request failed, http error: %d", http_rc);
+        eres = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+    } else if (data->cbk_ctx.result != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_ERR("HTTP request failed, edgehog error: %d", data->cbk_ctx.result);
+        eres = data->cbk_ctx.result;
+    } else {
+        EDGEHOG_LOG_DBG("HTTP request completed successfully.");
+    }
+
+    release_connection(sock, host, port,
+        (eres == EDGEHOG_RESULT_OK) && data->cbk_ctx.message_complete
+            && data->cbk_ctx.keep_alive);
+
+exit:
+    k_free(allocated_buf);
+    k_free(full_path);
+    return eres;
+}
+
+static int execute_request(int sock, struct request_data *data, const char *host, const char *path)
+{
+    // The list is NULL terminated, so the optional entries are appended only when present
+    const char *optional_headers[4] = { CONNECTION_HEADER };
+    size_t optional_headers_count = 1;
+    if (data->range_header[0] != '\0') {
+        optional_headers[optional_headers_count++] = data->range_header;
     }
-    memset(recv_buf, 0, CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE);
+    if (data->cbk_ctx.chunked_payload) {
+        optional_headers[optional_headers_count++] = TRANSFER_ENCODING_CHUNKED_HEADER;
+    }
+
+    memset(data->recv_buf, 0, data->recv_buf_len);
+
+    data->cbk_ctx.result = EDGEHOG_RESULT_OK;
+    data->cbk_ctx.payload_sent = false;
+    data->cbk_ctx.headers_received = false;
+    data->cbk_ctx.keep_alive = false;
+    data->cbk_ctx.message_complete = false;
+    http_headers_init(&data->cbk_ctx.headers, data->cbk_ctx.etag, data->cbk_ctx.etag_size);
+    data->cbk_ctx.status_code = 0;
 
     struct http_request req = { 0 };
     req.method = data->method;
     req.host = host;
     req.port = NULL;
-    req.url = full_path;
+    req.url = path;
     req.header_fields = data->header_fields;
+    req.optional_headers = optional_headers;
     req.protocol = "HTTP/1.1";
     req.payload_len = data->payload_len;
 
@@ -519,48 +1306,47 @@ static edgehog_result_t perform_request(struct request_data *data)
     }
 
     req.response = data->response_cbk;
-    req.recv_buf = recv_buf;
-    req.recv_buf_len = CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE;
+    req.http_cb = &http_parser_cbks;
+    req.recv_buf = data->recv_buf;
+    req.recv_buf_len = data->recv_buf_len;
 
     EDGEHOG_LOG_DBG("Executing http_client_req on socket %d...", sock);
 
     // Pass context struct as the user_data parameter
-    int http_rc = http_client_req(sock, &req, data->timeout_ms, &data->cbk_ctx);
-
-    EDGEHOG_LOG_DBG("http_client_req returned with code: %d", http_rc);
+    return http_client_req(sock, &req, data->timeout_ms, &data->cbk_ctx);
+}
 
-    if (http_rc < 0) {
-        EDGEHOG_LOG_ERR("HTTP request failed, http error: %d", http_rc);
-        eres = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
-    } else if (data->cbk_ctx.result != EDGEHOG_RESULT_OK) {
-        EDGEHOG_LOG_ERR("HTTP request failed, edgehog error: %d", data->cbk_ctx.result);
-        eres = data->cbk_ctx.result;
-    } else {
-        EDGEHOG_LOG_DBG("HTTP request completed successfully.");
+static int open_connection(const char *host, const char *port, bool *reused)
+{
+    *reused = false;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+    int sock = pool_take(host, port);
+    if (sock >= 0) {
+        EDGEHOG_LOG_DBG("Reusing pooled connection (fd: %d) to %s:%s", sock, host, port);
+        atomic_inc(&stat_pool_hits);
+        *reused = true;
+        return sock;
     }
+    atomic_inc(&stat_pool_misses);
+#endif
 
-    zsock_close(sock);
-    k_free(recv_buf);
-    k_free(full_path);
-    return eres;
+    return create_and_connect_socket(host, port);
 }
 
-static int send_buffer_fully(int sock, const uint8_t *buf, size_t len)
+static void release_connection(int sock, const char *host, const char *port, bool reusable)
 {
-    int sent_bytes = 0;
-    while (sent_bytes < len) {
-        EDGEHOG_LOG_DBG("Attempting to send chunk of size %zu (already sent %d)...",
-            len - sent_bytes, sent_bytes);
-        int send_rc = zsock_send(sock, buf + sent_bytes, len - sent_bytes, 0);
-        if (send_rc <= 0) {
-            EDGEHOG_LOG_ERR("Failed to send socket data: %d", errno);
-            return -1;
-        }
-        sent_bytes += send_rc;
-        EDGEHOG_LOG_DBG("Sent %d bytes successfully.", send_rc);
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+    if (reusable) {
+        pool_put(sock, host, port);
+        return;
     }
-
-    return sent_bytes;
+#else
+    ARG_UNUSED(host);
+    ARG_UNUSED(port);
+    ARG_UNUSED(reusable);
+#endif
+    zsock_close(sock);
 }
 
 static edgehog_result_t build_full_path(
@@ -613,3 +1399,135 @@ static edgehog_result_t build_full_path(
     *out_path = full_path;
     return EDGEHOG_RESULT_OK;
 }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+static int pool_take(const char *host, const char *port)
+{
+    k_mutex_lock(&conn_pool_mutex, K_FOREVER);
+    int sock = http_pool_take(&conn_pool, host, port, k_uptime_get());
+    k_mutex_unlock(&conn_pool_mutex);
+
+    return sock;
+}
+
+static void pool_put(int sock, const char *host, const char *port)
+{
+    k_mutex_lock(&conn_pool_mutex, K_FOREVER);
+    http_pool_put(&conn_pool, sock, host, port, k_uptime_get());
+    k_mutex_unlock(&conn_pool_mutex);
+
+    k_work_reschedule(
+        &pool_expiry_work, K_MSEC(CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE_IDLE_TIMEOUT_MS));
+}
+
+static void pool_expiry_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    k_mutex_lock(&conn_pool_mutex, K_FOREVER);
+    int64_t next_expiry = http_pool_evict_expired(&conn_pool, k_uptime_get());
+    k_mutex_unlock(&conn_pool_mutex);
+
+    if (next_expiry >= 0) {
+        k_work_reschedule(&pool_expiry_work, K_MSEC(next_expiry));
+    }
+}
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+static void dns_cache_register_events(void)
+{
+    if (!atomic_cas(&dns_cache_events_registered, 0, 1)) {
+        return;
+    }
+
+    net_mgmt_init_event_callback(
+        &dns_cache_if_cb, dns_cache_net_event_handler, DNS_CACHE_IF_EVENTS);
+    net_mgmt_add_event_callback(&dns_cache_if_cb);
+    net_mgmt_init_event_callback(
+        &dns_cache_ipv4_cb, dns_cache_net_event_handler, DNS_CACHE_IPV4_EVENTS);
+    net_mgmt_add_event_callback(&dns_cache_ipv4_cb);
+#ifdef CONFIG_NET_IPV6
+    net_mgmt_init_event_callback(
+        &dns_cache_ipv6_cb, dns_cache_net_event_handler, DNS_CACHE_IPV6_EVENTS);
+    net_mgmt_add_event_callback(&dns_cache_ipv6_cb);
+#endif
+}
+
+static bool dns_cache_lookup(const char *host, const char *port,
+    struct zsock_addrinfo addrs[RESOLVED_ADDRESSES_MAX], size_t *addrs_count)
+{
+    bool found = false;
+    int64_t now = k_uptime_get();
+
+    k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+    for (size_t i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+        struct dns_cache_entry *entry = &dns_cache[i];
+        if (!entry->valid || (strcmp(entry->host, host) != 0)
+            || (strcmp(entry->port, port) != 0)) {
+            continue;
+        }
+        if ((now - entry->resolved_at_ms)
+            >= (CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE_TTL_S * MSEC_PER_SEC)) {
+            EDGEHOG_LOG_DBG("DNS cache entry for %s:%s expired", host, port);
+            entry->valid = false;
+            break;
+        }
+        *addrs_count = copy_addrinfo_list(entry->addrs, addrs);
+        entry->last_used_ms = now;
+        stat_dns_time_saved_ms += entry->lookup_ms;
+        found = true;
+        break;
+    }
+    k_mutex_unlock(&dns_cache_mutex);
+
+    return found;
+}
+
+static void dns_cache_store(
+    const char *host, const char *port, const struct zsock_addrinfo *addrs, int64_t lookup_ms)
+{
+    if (strlen(host) >= HOST_MAX_SIZE) {
+        return;
+    }
+
+    k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+    struct dns_cache_entry *slot = NULL;
+    for (size_t i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+        if (!dns_cache[i].valid) {
+            slot = &dns_cache[i];
+            break;
+        }
+        if (!slot || (dns_cache[i].last_used_ms < slot->last_used_ms)) {
+            slot = &dns_cache[i];
+        }
+    }
+
+    if (slot->valid) {
+        EDGEHOG_LOG_DBG("DNS cache full, evicting entry for %s:%s", slot->host, slot->port);
+    }
+
+    slot->valid = true;
+    strncpy(slot->host, host, HOST_MAX_SIZE - 1);
+    slot->host[HOST_MAX_SIZE - 1] = '\0';
+    strncpy(slot->port, port, PORT_STR_LEN - 1);
+    slot->port[PORT_STR_LEN - 1] = '\0';
+    slot->addrs_count = copy_addrinfo_list(addrs, slot->addrs);
+    slot->resolved_at_ms = k_uptime_get();
+    slot->last_used_ms = slot->resolved_at_ms;
+    slot->lookup_ms = lookup_ms;
+    k_mutex_unlock(&dns_cache_mutex);
+}
+
+static void dns_cache_invalidate(const char *host, const char *port)
+{
+    k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+    for (size_t i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+        if (dns_cache[i].valid && (strcmp(dns_cache[i].host, host) == 0)
+            && (strcmp(dns_cache[i].port, port) == 0)) {
+            dns_cache[i].valid = false;
+        }
+    }
+    k_mutex_unlock(&dns_cache_mutex);
+}
+#endif
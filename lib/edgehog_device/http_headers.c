@@ -0,0 +1,236 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "http_headers.h"
+
+#include <string.h>
+#include <strings.h>
+
+#include <zephyr/sys/util.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(http_headers, CONFIG_EDGEHOG_DEVICE_HTTP_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define CONTENT_RANGE_HEADER "Content-Range"
+#define CONTENT_RANGE_UNIT "bytes "
+#define ETAG_HEADER "ETag"
+#define RETRY_AFTER_HEADER "Retry-After"
+
+BUILD_ASSERT(sizeof(CONTENT_RANGE_HEADER) <= HTTP_HEADERS_FIELD_SIZE,
+    "The header name buffer must fit the tracked headers");
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Identify the tracked header from its complete name.
+ *
+ * @param[in] headers Tracked headers, holding the name of the header.
+ * @return The tracked header, HTTP_HEADER_UNTRACKED if the header is not tracked.
+ */
+static http_header_t identify_header(const http_headers_t *headers);
+
+/**
+ * @brief Parse the header received so far and prepare for the next one.
+ *
+ * @param[inout] headers Tracked headers.
+ */
+static void end_header(http_headers_t *headers);
+
+/**
+ * @brief Parse the value of a Content-Range header, expected as "bytes <first>-<last>/<total>".
+ *
+ * @param[inout] headers Tracked headers.
+ */
+static void parse_content_range(http_headers_t *headers);
+
+/**
+ * @brief Parse the value of a Retry-After header, only the delay-seconds form is supported.
+ *
+ * @param[inout] headers Tracked headers.
+ */
+static void parse_retry_after(http_headers_t *headers);
+
+/**
+ * @brief Copy the value of an ETag header to the ETag buffer.
+ *
+ * @param[inout] headers Tracked headers.
+ */
+static void parse_etag(http_headers_t *headers);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void http_headers_init(http_headers_t *headers, char *etag, size_t etag_size)
+{
+    memset(headers, 0, sizeof(http_headers_t));
+    headers->etag = etag;
+    headers->etag_size = etag ? etag_size : 0;
+    if (headers->etag_size > 0) {
+        headers->etag[0] = '\0';
+    }
+}
+
+void http_headers_on_field(http_headers_t *headers, const char *at, size_t length)
+{
+    if (headers->in_value) {
+        end_header(headers);
+    }
+
+    if (headers->field_overflow || (length > (sizeof(headers->field) - headers->field_len))) {
+        headers->field_overflow = true;
+        return;
+    }
+    memcpy(&headers->field[headers->field_len], at, length);
+    headers->field_len += length;
+}
+
+void http_headers_on_value(http_headers_t *headers, const char *at, size_t length)
+{
+    if (!headers->in_value) {
+        headers->in_value = true;
+        headers->header = identify_header(headers);
+    }
+    if (headers->header == HTTP_HEADER_UNTRACKED) {
+        return;
+    }
+
+    // One byte is kept for the string terminator
+    if (headers->value_overflow
+        || (length >= (sizeof(headers->value) - headers->value_len))) {
+        headers->value_overflow = true;
+        return;
+    }
+    memcpy(&headers->value[headers->value_len], at, length);
+    headers->value_len += length;
+}
+
+void http_headers_on_complete(http_headers_t *headers)
+{
+    if (headers->in_value) {
+        end_header(headers);
+    }
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static http_header_t identify_header(const http_headers_t *headers)
+{
+    const char *field = headers->field;
+    size_t len = headers->field_len;
+
+    if (headers->field_overflow) {
+        return HTTP_HEADER_UNTRACKED;
+    }
+    if ((len == strlen(CONTENT_RANGE_HEADER))
+        && (strncasecmp(field, CONTENT_RANGE_HEADER, len) == 0)) {
+        return HTTP_HEADER_CONTENT_RANGE;
+    }
+    if (headers->etag && (len == strlen(ETAG_HEADER))
+        && (strncasecmp(field, ETAG_HEADER, len) == 0)) {
+        return HTTP_HEADER_ETAG;
+    }
+    if ((len == strlen(RETRY_AFTER_HEADER))
+        && (strncasecmp(field, RETRY_AFTER_HEADER, len) == 0)) {
+        return HTTP_HEADER_RETRY_AFTER;
+    }
+    return HTTP_HEADER_UNTRACKED;
+}
+
+static void end_header(http_headers_t *headers)
+{
+    if (headers->value_overflow) {
+        EDGEHOG_LOG_WRN("Ignoring %.*s header longer than %d bytes", (int) headers->field_len,
+            headers->field, HTTP_HEADERS_VALUE_SIZE - 1);
+    } else {
+        headers->value[headers->value_len] = '\0';
+        switch (headers->header) {
+            case HTTP_HEADER_CONTENT_RANGE:
+                parse_content_range(headers);
+                break;
+            case HTTP_HEADER_ETAG:
+                parse_etag(headers);
+                break;
+            case HTTP_HEADER_RETRY_AFTER:
+                parse_retry_after(headers);
+                break;
+            default:
+                break;
+        }
+    }
+
+    headers->field_len = 0;
+    headers->field_overflow = false;
+    headers->value_len = 0;
+    headers->value_overflow = false;
+    headers->in_value = false;
+    headers->header = HTTP_HEADER_UNTRACKED;
+}
+
+static void parse_content_range(http_headers_t *headers)
+{
+    const char *value = headers->value;
+    size_t length = headers->value_len;
+    size_t unit_len = strlen(CONTENT_RANGE_UNIT);
+
+    if ((length <= unit_len) || (strncasecmp(value, CONTENT_RANGE_UNIT, unit_len) != 0)) {
+        EDGEHOG_LOG_WRN("Unsupported Content-Range header: %s", value);
+        return;
+    }
+
+    size_t first = 0;
+    size_t idx = unit_len;
+    while ((idx < length) && (value[idx] >= '0') && (value[idx] <= '9')) {
+        size_t digit = (size_t) (value[idx] - '0');
+        if (first > ((SIZE_MAX - digit) / 10U)) {
+            EDGEHOG_LOG_WRN("Content-Range start out of range: %s", value);
+            return;
+        }
+        first = (first * 10U) + digit;
+        idx++;
+    }
+    if ((idx == unit_len) || (idx >= length) || (value[idx] != '-')) {
+        EDGEHOG_LOG_WRN("Unsupported Content-Range header: %s", value);
+        return;
+    }
+
+    headers->content_range_start = first;
+    headers->content_range_found = true;
+}
+
+static void parse_retry_after(http_headers_t *headers)
+{
+    // An HTTP date would need a synchronized clock
+    uint64_t delay_s = 0;
+    size_t idx = 0;
+    while ((idx < headers->value_len) && (headers->value[idx] >= '0')
+        && (headers->value[idx] <= '9')) {
+        delay_s = MIN((delay_s * 10U) + (uint64_t) (headers->value[idx] - '0'), UINT32_MAX);
+        idx++;
+    }
+    if ((idx == 0) || (idx != headers->value_len)) {
+        EDGEHOG_LOG_WRN("Unsupported Retry-After header: %s", headers->value);
+        return;
+    }
+    headers->retry_after_s = (uint32_t) delay_s;
+}
+
+static void parse_etag(http_headers_t *headers)
+{
+    if (headers->value_len >= headers->etag_size) {
+        EDGEHOG_LOG_WRN("Ignoring ETag header of %zu bytes", headers->value_len);
+        return;
+    }
+    memcpy(headers->etag, headers->value, headers->value_len + 1);
+}
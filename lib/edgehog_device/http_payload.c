@@ -0,0 +1,160 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "http_payload.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/net/socket.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(http_payload, CONFIG_EDGEHOG_DEVICE_HTTP_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/** @brief Buffer size for formatting chunk length in HTTP chunked transfer encoding. */
+#define HTTP_CHUNKED_PAYLOAD_CHUNK_LENGTH_BUFFER_SIZE 32
+/** @brief Line terminating each chunk in HTTP chunked transfer encoding. */
+#define HTTP_CHUNKED_PAYLOAD_CRLF "\r\n"
+/** @brief Last chunk and empty trailer terminating an HTTP chunked payload. */
+#define HTTP_CHUNKED_PAYLOAD_TERMINATOR "0\r\n\r\n"
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Helper function to reliably send all bytes of a buffer over a socket.
+ *
+ * @param sock The connected socket descriptor.
+ * @param buf Pointer to the data to send.
+ * @param len Number of bytes to send.
+ * @return The total number of bytes sent, or -1 on error.
+ */
+static int send_buffer_fully(int sock, const uint8_t *buf, size_t len);
+/**
+ * @brief Send a chunk of a request payload, wrapping it in an HTTP chunk when required.
+ *
+ * @param sock The connected socket descriptor.
+ * @param chunked Set when the payload is sent with chunked transfer encoding.
+ * @param buf Pointer to the chunk data, should not be empty when chunked.
+ * @param len Number of bytes in the chunk.
+ * @return The total number of bytes sent, including the chunk framing, or -1 on error.
+ */
+static int send_payload_chunk(int sock, bool chunked, const uint8_t *buf, size_t len);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+int http_payload_send(int sock, bool chunked, edgehog_http_payload_cbk_t payload_cbk,
+    void *user_data, edgehog_result_t *result)
+{
+    int total_sent_bytes = 0;
+    edgehog_http_payload_chunk_t http_payload_chunk = { 0 };
+
+    *result = EDGEHOG_RESULT_OK;
+    while (!http_payload_chunk.last_chunk) {
+        // Clear the previous chunk information
+        memset(&http_payload_chunk, 0, sizeof(http_payload_chunk));
+
+        // Get the next chunk to upload from the user callback
+        *result = payload_cbk(&http_payload_chunk, user_data);
+        if (*result != EDGEHOG_RESULT_OK) {
+            EDGEHOG_LOG_ERR("HTTP payload user callback error: %d", *result);
+            return -EIO;
+        }
+
+        EDGEHOG_LOG_DBG("Retrieved payload chunk from user callback. Size: %zu, Last chunk: %d",
+            http_payload_chunk.chunk_size, http_payload_chunk.last_chunk);
+
+        // Empty chunks are skipped, as a zero length chunk would terminate a chunked payload
+        if (http_payload_chunk.chunk_size > 0) {
+            int sent_bytes = send_payload_chunk(sock, chunked, http_payload_chunk.chunk_start_addr,
+                http_payload_chunk.chunk_size);
+            if (sent_bytes < 0) {
+                EDGEHOG_LOG_ERR("Failed to send chunk payload: %d", sent_bytes);
+                *result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+                return -EIO;
+            }
+            total_sent_bytes += sent_bytes;
+
+            EDGEHOG_LOG_DBG("Sent chunk of size %zu bytes. Total sent so far: %d",
+                http_payload_chunk.chunk_size, total_sent_bytes);
+        }
+    }
+
+    if (chunked) {
+        int sent_bytes = send_buffer_fully(sock, (const uint8_t *) HTTP_CHUNKED_PAYLOAD_TERMINATOR,
+            sizeof(HTTP_CHUNKED_PAYLOAD_TERMINATOR) - 1);
+        if (sent_bytes < 0) {
+            EDGEHOG_LOG_ERR("Failed to send chunked payload terminator: %d", sent_bytes);
+            *result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+            return -EIO;
+        }
+        total_sent_bytes += sent_bytes;
+    }
+
+    EDGEHOG_LOG_DBG("Finished sending all payload chunks. Total bytes sent: %d", total_sent_bytes);
+
+    return total_sent_bytes;
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static int send_buffer_fully(int sock, const uint8_t *buf, size_t len)
+{
+    int sent_bytes = 0;
+    while (sent_bytes < len) {
+        EDGEHOG_LOG_DBG("Attempting to send chunk of size %zu (already sent %d)...",
+            len - sent_bytes, sent_bytes);
+        int send_rc = zsock_send(sock, buf + sent_bytes, len - sent_bytes, 0);
+        if (send_rc <= 0) {
+            EDGEHOG_LOG_ERR("Failed to send socket data: %d", errno);
+            return -1;
+        }
+        sent_bytes += send_rc;
+        EDGEHOG_LOG_DBG("Sent %d bytes successfully.", send_rc);
+    }
+
+    return sent_bytes;
+}
+
+static int send_payload_chunk(int sock, bool chunked, const uint8_t *buf, size_t len)
+{
+    if (!chunked) {
+        return send_buffer_fully(sock, buf, len);
+    }
+
+    char chunk_length[HTTP_CHUNKED_PAYLOAD_CHUNK_LENGTH_BUFFER_SIZE] = { 0 };
+    int snprintf_rc = snprintf(chunk_length, sizeof(chunk_length), "%zx\r\n", len);
+    if ((snprintf_rc < 0) || (snprintf_rc >= sizeof(chunk_length))) {
+        EDGEHOG_LOG_ERR("Error formatting the chunk length");
+        return -1;
+    }
+
+    int length_sent = send_buffer_fully(sock, (const uint8_t *) chunk_length, snprintf_rc);
+    if (length_sent < 0) {
+        return -1;
+    }
+    int data_sent = send_buffer_fully(sock, buf, len);
+    if (data_sent < 0) {
+        return -1;
+    }
+    int crlf_sent = send_buffer_fully(
+        sock, (const uint8_t *) HTTP_CHUNKED_PAYLOAD_CRLF, sizeof(HTTP_CHUNKED_PAYLOAD_CRLF) - 1);
+    if (crlf_sent < 0) {
+        return -1;
+    }
+
+    return length_sent + data_sent + crlf_sent;
+}
@@ -0,0 +1,135 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "http_pool.h"
+
+#include <string.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/util.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(http_pool, CONFIG_EDGEHOG_DEVICE_HTTP_LOG_LEVEL);
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Check if an idle connection has been closed or has unexpected pending data.
+ *
+ * @param[in] sock The socket to check.
+ * @return true if the socket can be used for a new request, false otherwise.
+ */
+static bool is_idle_connection_usable(int sock);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+int http_pool_take(http_pool_t *pool, const char *host, const char *port, int64_t now_ms)
+{
+    http_pool_evict_expired(pool, now_ms);
+    for (size_t i = 0; i < ARRAY_SIZE(pool->entries); i++) {
+        http_pool_entry_t *conn = &pool->entries[i];
+        if (!conn->in_use || (strcmp(conn->host, host) != 0) || (strcmp(conn->port, port) != 0)) {
+            continue;
+        }
+        conn->in_use = false;
+        if (!is_idle_connection_usable(conn->sock)) {
+            EDGEHOG_LOG_DBG("Dropping stale pooled connection to %s:%s", host, port);
+            zsock_close(conn->sock);
+            continue;
+        }
+        return conn->sock;
+    }
+    return -1;
+}
+
+void http_pool_put(http_pool_t *pool, int sock, const char *host, const char *port, int64_t now_ms)
+{
+    if ((strlen(host) >= HTTP_POOL_HOST_SIZE) || (strlen(port) >= HTTP_POOL_PORT_SIZE)) {
+        zsock_close(sock);
+        return;
+    }
+
+    http_pool_entry_t *slot = NULL;
+    for (size_t i = 0; i < ARRAY_SIZE(pool->entries); i++) {
+        if (!pool->entries[i].in_use) {
+            slot = &pool->entries[i];
+            break;
+        }
+        if (!slot || (pool->entries[i].idle_since_ms < slot->idle_since_ms)) {
+            slot = &pool->entries[i];
+        }
+    }
+
+    if (slot->in_use) {
+        EDGEHOG_LOG_DBG("Connection pool full, evicting connection to %s:%s", slot->host,
+            slot->port);
+        zsock_close(slot->sock);
+    }
+
+    slot->in_use = true;
+    slot->sock = sock;
+    strcpy(slot->host, host);
+    strcpy(slot->port, port);
+    slot->idle_since_ms = now_ms;
+}
+
+int64_t http_pool_evict_expired(http_pool_t *pool, int64_t now_ms)
+{
+    int64_t next_expiry = -1;
+
+    for (size_t i = 0; i < ARRAY_SIZE(pool->entries); i++) {
+        http_pool_entry_t *conn = &pool->entries[i];
+        if (!conn->in_use) {
+            continue;
+        }
+        int64_t idle_ms = now_ms - conn->idle_since_ms;
+        if (idle_ms >= CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE_IDLE_TIMEOUT_MS) {
+            EDGEHOG_LOG_DBG("Closing expired idle connection to %s:%s", conn->host, conn->port);
+            zsock_close(conn->sock);
+            conn->in_use = false;
+            continue;
+        }
+        int64_t remaining_ms
+            = CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE_IDLE_TIMEOUT_MS - idle_ms;
+        if ((next_expiry < 0) || (remaining_ms < next_expiry)) {
+            next_expiry = remaining_ms;
+        }
+    }
+
+    return next_expiry;
+}
+
+void http_pool_close_all(http_pool_t *pool)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(pool->entries); i++) {
+        http_pool_entry_t *conn = &pool->entries[i];
+        if (conn->in_use) {
+            EDGEHOG_LOG_DBG("Closing idle connection to %s:%s", conn->host, conn->port);
+            zsock_close(conn->sock);
+            conn->in_use = false;
+        }
+    }
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static bool is_idle_connection_usable(int sock)
+{
+    // An idle connection should have nothing to read: readable means the server closed it (EOF)
+    // or sent unsolicited data, both make the connection unusable for a new request.
+    struct zsock_pollfd pfd = {
+        .fd = sock,
+        .events = ZSOCK_POLLIN,
+    };
+    int poll_rc = zsock_poll(&pfd, 1, 0);
+    return (poll_rc == 0);
+}
@@ -77,6 +77,8 @@ struct edgehog_device
     edgehog_ft_t *file_transfer;
     /** @brief Semaphore used to synchronize an OTA or File Transfer operation. */
     struct k_sem sync_ota_ft_sem;
+    /** @brief Number of OTA operations waiting for sync_ota_ft_sem, transfers wait for them. */
+    atomic_t ota_waiting;
     /** @brief User-provided storage partitions for telemetry. */
     edgehog_storage_partition_t *storage_partitions;
     /** @brief Length of user-provided storage partitions. */
@@ -14,6 +14,7 @@
 
 #include "edgehog_device/device.h"
 #include "edgehog_device/file_transfer.h"
+#include "file_transfer/scheduler.h"
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/uuid.h>
@@ -48,6 +49,9 @@ enum edgehog_ft_location_type
     EDGEHOG_FT_LOCATION_TYPE_UNSUPPORTED,
 };
 
+/** @brief File transfer service, only defined when CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER is set. */
+typedef struct edgehog_ft edgehog_ft_t;
+
 /** @brief Wrapper for file transfer messages sent through the message queue. */
 typedef struct
 {
@@ -71,24 +75,88 @@ typedef struct
     edgehog_ft_type_t type;
     /** @brief Total expected decompressed file size in bytes (server-to-device transfers). */
     int64_t file_size_bytes;
+    /** @brief Uptime in ms at which the request has been queued. */
+    int64_t enqueued_ms;
+    /** @brief Scheduling priority, from the target and the size of the transfer. */
+    enum edgehog_ft_priority priority;
+    /** @brief Receive buffer lent by the worker performing the transfer, NULL if not dispatched. */
+    uint8_t *recv_buf;
+    /** @brief Size of the lent receive buffer. */
+    size_t recv_buf_size;
 } edgehog_ft_msg_t;
 
-/** @brief Data structure for the file transfer service. */
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
+/** @brief Capacity of the pending requests, each worker can add one past the queue size. */
+#define EDGEHOG_FT_PENDING_SIZE                                                                    \
+    (CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_QUEUE_SIZE + CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_WORKERS)
+
+/** @brief Worker of the file transfer service. */
 typedef struct
 {
-    /** @brief Message queue used to pass transfer requests to the service thread. */
-    struct k_msgq msgq;
-    /** @brief File transfer service thread, peeks the msgq and performs transfers if present. */
+    /** @brief Thread of the worker, performs the transfers dispatched from the msgq. */
     struct k_thread thread;
-    /** @brief Run state for the file transfer service thread. */
+    /** @brief Set while the worker performs a transfer. */
+    bool busy;
+    /** @brief Location type of the transfer in progress. */
+    enum edgehog_ft_location_type target_type;
+    /**
+     * @brief Hash of the target of the transfer in progress, its mount point or its stream.
+     *
+     * @details A hash is kept as the location of the request is freed by the transfer handler.
+     */
+    uint32_t target_hash;
+} edgehog_ft_worker_t;
+
+/** @brief Time spent by the transfer requests waiting for a worker. */
+typedef struct
+{
+    /** @brief Number of transfers dispatched to a worker. */
+    uint32_t transfers;
+    /** @brief Sum of the queue wait times of the dispatched transfers. */
+    int64_t total_wait_ms;
+    /** @brief Longest queue wait time of a dispatched transfer. */
+    int64_t max_wait_ms;
+} edgehog_ft_queue_stats_t;
+
+/** @brief Data structure for the file transfer service. */
+struct edgehog_ft
+{
+    /** @brief Message queue used to pass transfer requests to the workers. */
+    struct k_msgq msgq;
+    /** @brief Workers performing the transfers concurrently. */
+    edgehog_ft_worker_t workers[CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_WORKERS];
+    /** @brief Run state for the file transfer workers. */
     atomic_t thread_state;
+    /** @brief Protects the worker targets, the pending requests and the queue statistics. */
+    struct k_mutex lock;
+    /**
+     * @brief Requests moved from the msgq and waiting for a worker.
+     *
+     * @details The runnable request with the highest priority, raised while it waits, is
+     * dispatched first, the earliest enqueued one on ties.
+     */
+    edgehog_ft_msg_t pending[EDGEHOG_FT_PENDING_SIZE];
+    /** @brief Number of pending requests. */
+    size_t pending_len;
+    /** @brief Queue wait time statistics. */
+    edgehog_ft_queue_stats_t queue_stats;
+    /** @brief Protects active_transfers and the ownership of the OTA/file transfer semaphore. */
+    struct k_mutex ota_lock;
+    /**
+     * @brief Number of transfers in progress.
+     *
+     * @details The first transfer to start takes the OTA/file transfer semaphore on behalf of all
+     * the workers, the last one to complete gives it back. None is added while an OTA waits.
+     */
+    size_t active_transfers;
     /** @brief File transfer callbacks registered by the user. */
     edgehog_ft_cbks_t cbks;
     /** @brief The file system partitions explicitly allowed for file transfers. */
     edgehog_ft_filesystem_partition_t *partitions;
     /** @brief The length of the partitions array. */
     size_t partitions_len;
-} edgehog_ft_t;
+};
+#endif
 
 /**
  * @brief Publishes the file transfer capabilities for the Edgehog device.
@@ -114,7 +182,7 @@ edgehog_ft_t *edgehog_ft_new(
 void edgehog_ft_destroy(edgehog_ft_t *file_transfer);
 
 /**
- * @brief Starts the file transfer background service/thread.
+ * @brief Starts the file transfer background service/workers.
  * @param device A valid Edgehog device handle.
  * @return EDGEHOG_RESULT_OK on success, otherwise an error code.
  */
@@ -123,20 +191,29 @@ edgehog_result_t edgehog_ft_start(edgehog_device_handle_t device);
 /**
  * @brief Signals the file transfer service to stop processing and wait for termination.
  * @param file_transfer The file transfer context to stop.
- * @param timeout Maximum time to wait for the thread to terminate.
+ * @param timeout Maximum time to wait for all the workers to terminate.
  * @return EDGEHOG_RESULT_OK on successful stop, otherwise an error code.
  */
 edgehog_result_t edgehog_ft_stop(edgehog_ft_t *file_transfer, k_timeout_t timeout);
 
 /**
- * @brief Checks if the file transfer service thread is currently running.
+ * @brief Checks if the file transfer service workers are currently running.
  * @param file_transfer The file transfer context to check.
  * @return true if running, false otherwise.
  */
 bool edgehog_ft_is_running(edgehog_ft_t *file_transfer);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
+/**
+ * @brief Get a snapshot of the queue wait time statistics.
+ * @param file_transfer The file transfer context.
+ * @param stats Struct to fill with the current statistics.
+ */
+void edgehog_ft_get_queue_stats(edgehog_ft_t *file_transfer, edgehog_ft_queue_stats_t *stats);
+#endif
+
 /**
- * @brief Processes a file transfer event and enqueues it for the handler thread.
+ * @brief Processes a file transfer event and enqueues it for the workers.
  *
  * @param device A valid Edgehog device handle.
  * @param object_event A valid Astarte datastream object event containing the transfer parameters.
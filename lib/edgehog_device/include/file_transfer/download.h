@@ -24,6 +24,24 @@ typedef struct
     edgehog_result_t (*file_append_next_entry)(void *ctx, const char *name_len);
     /** @brief Appends a chunk of data to the storage backend. */
     edgehog_result_t (*file_append_chunk)(void *ctx, const uint8_t *chunk_data, size_t chunk_size);
+    /**
+     * @brief Writes a chunk of data at an offset of a non TAR file (optional, used for parallel
+     * range downloads). Calls on the same context must be serialized by the caller.
+     */
+    edgehog_result_t (*file_write_at)(
+        void *ctx, size_t offset, const uint8_t *chunk_data, size_t chunk_size);
+    /**
+     * @brief Reads back a chunk of data at an offset of a non TAR file (optional, used to compute
+     * the digest of a parallel range download). Returns the number of bytes read in read_size.
+     */
+    edgehog_result_t (*file_read_at)(
+        void *ctx, size_t offset, uint8_t *buffer, size_t buffer_size, size_t *read_size);
+    /**
+     * @brief Discards the data written so far to a non TAR file, so that the next append starts
+     * from its beginning (optional, used when a parallel range download falls back to a single
+     * connection).
+     */
+    edgehog_result_t (*file_rewind)(void *ctx);
     /** @brief Finalizes and closes the file transfer successfully. */
     edgehog_result_t (*file_complete)(void *ctx);
     /** @brief Aborts the transfer and cleans up resources (e.g., deletes partial file). */
@@ -0,0 +1,49 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILE_TRANSFER_DOWNLOAD_RANGES_H
+#define FILE_TRANSFER_DOWNLOAD_RANGES_H
+
+/**
+ * @file file_transfer/download_ranges.h
+ * @brief Parallel range downloads for server-to-device file transfers.
+ */
+
+#include "file_transfer/download.h"
+#include "file_transfer/utils.h"
+
+/**
+ * @brief Check if a server-to-device transfer can be downloaded through parallel range requests.
+ * @details Only non compressed and non archived transfers toward the file system, with a known
+ * size larger than CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARALLEL_DOWNLOAD_MIN_SIZE, are eligible.
+ *
+ * @param msg The server-to-device message payload.
+ * @param file_cbks The write callbacks of the transfer destination.
+ * @return true if the transfer can be split in parallel ranges, false otherwise.
+ */
+bool edgehog_ft_download_ranges_supported(
+    const edgehog_ft_msg_t *msg, const edgehog_ft_file_write_cbks_t *file_cbks);
+
+/**
+ * @brief Download a file through parallel range requests.
+ * @details The file is split in CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARALLEL_DOWNLOAD_CONNECTIONS
+ * ranges, each downloaded by its own thread and written at its offset in the destination.
+ * Once all the ranges have been received, the file is read back in order to update the digest
+ * of the transfer, which should then be verified by the caller.
+ *
+ * When the server does not support range requests, or another parallel download is running,
+ * fallback is set and the destination is rewound so that the transfer can be performed over a
+ * single connection.
+ *
+ * @param[inout] data The HTTP callback data of the transfer.
+ * @param[in] msg The server-to-device message payload.
+ * @param[out] fallback Set when the transfer should be performed over a single connection.
+ * @return EDGEHOG_RESULT_OK on success or fallback, an edgehog_result_t otherwise.
+ */
+edgehog_result_t edgehog_ft_download_ranges(
+    edgehog_ft_http_cbk_data_t *data, const edgehog_ft_msg_t *msg, bool *fallback);
+
+#endif // FILE_TRANSFER_DOWNLOAD_RANGES_H
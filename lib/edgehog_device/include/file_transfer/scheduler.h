@@ -0,0 +1,68 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILE_TRANSFER_SCHEDULER_H
+#define FILE_TRANSFER_SCHEDULER_H
+
+/**
+ * @file file_transfer/scheduler.h
+ * @brief Scheduling of the file transfer requests waiting for a worker.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Scheduling priorities for file transfers.
+ */
+enum edgehog_ft_priority
+{
+    /** @brief Uploads from the filesystem, such as logs, which can be long. */
+    EDGEHOG_FT_PRIORITY_LOW = 0,
+    /** @brief Large or unsized downloads and stream uploads. */
+    EDGEHOG_FT_PRIORITY_NORMAL,
+    /** @brief Small downloads, such as configuration files. */
+    EDGEHOG_FT_PRIORITY_HIGH,
+};
+
+/** @brief Scheduling information of a request waiting for a worker. */
+typedef struct
+{
+    /** @brief Scheduling priority, from the target and the size of the transfer. */
+    enum edgehog_ft_priority priority;
+    /** @brief Uptime in ms at which the request has been queued. */
+    int64_t enqueued_ms;
+} edgehog_ft_sched_entry_t;
+
+/**
+ * @brief Get the scheduling information of a waiting request.
+ *
+ * @param[in] index Index of the request.
+ * @param[in] user_data User data passed to edgehog_ft_scheduler_select.
+ * @param[out] entry Filled with the scheduling information of the request.
+ * @return True if the request is runnable, false if it has to keep waiting.
+ */
+typedef bool (*edgehog_ft_sched_entry_cbk_t)(
+    size_t index, void *user_data, edgehog_ft_sched_entry_t *entry);
+
+/**
+ * @brief Select the waiting request to dispatch.
+ *
+ * @details The priority of each request is raised by one level every
+ * CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PRIORITY_AGING_MS spent waiting, so that no request starves.
+ * Requests with the same aged priority are dispatched in enqueue time order.
+ *
+ * @param[in] count Number of waiting requests.
+ * @param[in] now_ms Current uptime in ms.
+ * @param[in] entry_cbk Callback returning the scheduling information of each request.
+ * @param[in] user_data User data passed to the callback.
+ * @return Index of the selected request, count if no request is runnable.
+ */
+size_t edgehog_ft_scheduler_select(
+    size_t count, int64_t now_ms, edgehog_ft_sched_entry_cbk_t entry_cbk, void *user_data);
+
+#endif // FILE_TRANSFER_SCHEDULER_H
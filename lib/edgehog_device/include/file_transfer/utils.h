@@ -25,6 +25,8 @@
 
 /** @brief HTTP request timeout duration in milliseconds. */
 #define EDGEHOG_FT_HTTP_REQ_TIMEOUT_MS (60 * 1000)
+/** @brief Delay in milliseconds before resuming an interrupted download. */
+#define EDGEHOG_FT_RESUME_DELAY_MS 2000
 
 /** @brief Size for the output buffer used to temporarely store the compressed chunk. */
 #define EDGEHOG_FT_COMPRESSED_OUT_BUFFER_SIZE 1024
@@ -54,6 +56,10 @@ typedef struct
     size_t transferred_bytes;
     /** @brief The total expected bytes to be processed */
     size_t total_bytes;
+    /** @brief Bytes of the remote file processed so far, where a resumed download starts from */
+    size_t received_bytes;
+    /** @brief Bytes of the response body received during the current download attempt */
+    size_t attempt_bytes;
     /** @brief The number of bytes at the last progress report */
     atomic_t last_reported_bytes;
     /** @brief The expected digest string for verification (e.g., "sha256:...") */
@@ -142,6 +148,16 @@ void edgehog_ft_http_cbk_data_destroy(edgehog_ft_http_cbk_data_t *data);
 void edgehog_ft_update_progress(
     edgehog_ft_http_cbk_data_t *data, size_t chunk_size, bool last_chunk);
 
+/**
+ * @brief Logs the throughput of a completed download.
+ * @details Used to compare the single connection and parallel range download paths.
+ *
+ * @param bytes Number of bytes downloaded.
+ * @param elapsed_ms Duration of the download in milliseconds.
+ * @param connections Number of connections the download has been performed over.
+ */
+void edgehog_ft_log_throughput(size_t bytes, int64_t elapsed_ms, int connections);
+
 /**
  * @brief Send the final response or error result for a file transfer operation.
  *
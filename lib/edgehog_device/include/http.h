@@ -27,6 +27,14 @@ typedef struct
     size_t chunk_size;
     /** @brief Size of the response. */
     size_t response_size;
+    /**
+     * @brief Offset of the response body within the requested resource.
+     *
+     * @details Non zero only for partial responses to a range request, the full size of the
+     * resource is range_offset + response_size. A zero offset for a request with a non zero
+     * range_start means that the server ignored the range and is sending the whole resource.
+     */
+    size_t range_offset;
     /** @brief Identify the last chunk of the response. */
     bool last_chunk;
 } edgehog_http_response_chunk_t;
@@ -74,7 +82,40 @@ typedef struct
     const char **header_fields;
     /** @brief Timeout to use for the HTTP operations in ms. */
     int32_t timeout_ms;
-    /** @brief Callback for a chunk response event. */
+    /** @brief Offset of the first byte to request, when non zero a range request is made. */
+    size_t range_start;
+    /** @brief Number of bytes to request starting from range_start, zero to request up to the end
+     * of the resource. When non zero a range request is made even for a zero range_start. */
+    size_t range_size;
+    /**
+     * @brief Optional buffer lent by the caller to receive the response.
+     *
+     * @details The socket receives straight into this buffer and the chunks passed to the
+     * response callback point inside it, so a caller lending a suitably aligned buffer can consume
+     * them in place. When NULL a buffer of CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE
+     * bytes is allocated for the request.
+     */
+    uint8_t *recv_buf;
+    /** @brief Size of the lent receive buffer, ignored when recv_buf is NULL. */
+    size_t recv_buf_size;
+    /**
+     * @brief Optional buffer receiving the ETag header of the response, quotes included.
+     *
+     * @details Set to an empty string when the server doesn't send an ETag or when it doesn't fit
+     * in the buffer.
+     */
+    char *etag;
+    /** @brief Size of the ETag buffer, ignored when etag is NULL. */
+    size_t etag_size;
+    /** @brief Set to the status code of the response, zero when no response has been received. */
+    uint16_t status_code;
+    /**
+     * @brief Set to the delay requested by the Retry-After header of the response, in seconds.
+     *
+     * @details Zero when the server doesn't send the header or sends it as an HTTP date.
+     */
+    uint32_t retry_after_s;
+    /** @brief Callback for a chunk response event, optional for HEAD requests. */
     edgehog_http_response_cbk_t response_cbk;
     /** @brief User data passed to the callback function. */
     void *user_data;
@@ -89,14 +130,35 @@ typedef struct
     const char **header_fields;
     /** @brief Timeout to use for the HTTP operations in ms. */
     int32_t timeout_ms;
-    /** @brief Size of the data transmitted by the HTTP PUT request. */
+    /** @brief Size of the data transmitted by the HTTP PUT request, ignored when chunked. */
     size_t payload_size;
+    /**
+     * @brief Send the payload with chunked transfer encoding.
+     * @details To be used when the size of the payload is not known before the upload, each
+     * chunk returned by the payload callback is then sent as an HTTP chunk.
+     */
+    bool chunked;
     /** @brief Callback for a chunk payload event. */
     edgehog_http_payload_cbk_t payload_cbk;
     /** @brief User data passed to the callback function. */
     void *user_data;
 } edgehog_http_put_data_t;
 
+/** @brief Statistics collected by the HTTP client. */
+typedef struct
+{
+    /** @brief Requests served by an idle connection taken from the keep-alive pool. */
+    uint32_t pool_hits;
+    /** @brief Requests that required opening a new connection, zero without the pool. */
+    uint32_t pool_misses;
+    /** @brief Host name resolutions served by the DNS cache. */
+    uint32_t dns_cache_hits;
+    /** @brief Host name resolutions that required a DNS lookup, zero without the DNS cache. */
+    uint32_t dns_cache_misses;
+    /** @brief Estimated lookup time saved by the DNS cache, in ms. */
+    uint64_t dns_time_saved_ms;
+} edgehog_http_stats_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -109,6 +171,17 @@ extern "C" {
  */
 edgehog_result_t edgehog_http_get(edgehog_http_get_data_t *data);
 
+/**
+ * @brief Perform an HTTP HEAD request.
+ *
+ * @details Used to read the headers of a resource without downloading it, the range and the
+ * receive buffer fields of the request data are ignored.
+ *
+ * @param[in] data Pointer to the HTTP request data.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+edgehog_result_t edgehog_http_head(edgehog_http_get_data_t *data);
+
 /**
  * @brief Perform an HTTP PUT request.
  *
@@ -117,6 +190,38 @@ edgehog_result_t edgehog_http_get(edgehog_http_get_data_t *data);
  */
 edgehog_result_t edgehog_http_put(edgehog_http_put_data_t *data);
 
+/**
+ * @brief Check if a failed request is worth retrying.
+ *
+ * @details Requests without a response or answered with a 5xx status can succeed later, as well
+ * as the 408, 425 and 429 client errors. The other 4xx statuses are definitive.
+ *
+ * @param[in] status_code Status code of the response, zero if no response has been received.
+ * @return True if the request can be retried.
+ */
+bool edgehog_http_is_retryable_status(uint16_t status_code);
+
+/**
+ * @brief Close all the idle connections kept open for reuse.
+ *
+ * @details Connections currently in use by a request are not affected.
+ */
+void edgehog_http_close_idle_connections(void);
+
+/**
+ * @brief Get a snapshot of the HTTP client statistics.
+ *
+ * @param[out] stats Struct to fill with the current statistics.
+ */
+void edgehog_http_get_stats(edgehog_http_stats_t *stats);
+
+/**
+ * @brief Remove all the entries stored in the DNS cache.
+ *
+ * @details The cache is also flushed automatically on network interface changes.
+ */
+void edgehog_http_flush_dns_cache(void);
+
 #ifdef __cplusplus
 }
 #endif
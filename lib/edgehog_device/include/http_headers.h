@@ -0,0 +1,118 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef HTTP_HEADERS_H
+#define HTTP_HEADERS_H
+
+/**
+ * @file http_headers.h
+ * @brief Tracking of the HTTP response headers used by the HTTP client.
+ *
+ * @details The HTTP parser reports the name and the value of a header through one or more
+ * callbacks each, as a header can be split between two reads of the socket. The pieces are
+ * accumulated and a header is parsed once complete: when the name of the following header starts
+ * or when all the headers have been received.
+ *
+ * The tracked headers are Content-Range, ETag and Retry-After. A header whose value doesn't fit
+ * in HTTP_HEADERS_VALUE_SIZE bytes, or that is malformed, is ignored with a warning.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Size of the buffer for the header names, fitting the longest tracked one. */
+#define HTTP_HEADERS_FIELD_SIZE 16
+/** @brief Size of the buffer for the header values. */
+#define HTTP_HEADERS_VALUE_SIZE 128
+
+/** @brief Headers tracked by the HTTP client. */
+typedef enum
+{
+    /** @brief Header not tracked, its value is discarded. */
+    HTTP_HEADER_UNTRACKED = 0,
+    /** @brief Content-Range header. */
+    HTTP_HEADER_CONTENT_RANGE,
+    /** @brief ETag header. */
+    HTTP_HEADER_ETAG,
+    /** @brief Retry-After header. */
+    HTTP_HEADER_RETRY_AFTER,
+} http_header_t;
+
+/** @brief Data struct for the tracked headers of a response. */
+typedef struct
+{
+    /** @brief Name of the header being received. */
+    char field[HTTP_HEADERS_FIELD_SIZE];
+    /** @brief Bytes of the name received so far. */
+    size_t field_len;
+    /** @brief Set when the name doesn't fit the buffer, so it's not a tracked header. */
+    bool field_overflow;
+    /** @brief Value of the header being received. */
+    char value[HTTP_HEADERS_VALUE_SIZE];
+    /** @brief Bytes of the value received so far. */
+    size_t value_len;
+    /** @brief Set when the value doesn't fit the buffer. */
+    bool value_overflow;
+    /** @brief Set while receiving a value, the next name then starts a new header. */
+    bool in_value;
+    /** @brief Header whose value is being received. */
+    http_header_t header;
+    /** @brief Buffer receiving the ETag of the response, NULL if not requested. */
+    char *etag;
+    /** @brief Size of the ETag buffer. */
+    size_t etag_size;
+    /** @brief Set when a valid Content-Range header has been received. */
+    bool content_range_found;
+    /** @brief Start of the range returned by the server in the Content-Range header. */
+    size_t content_range_start;
+    /** @brief Delay requested by the Retry-After header, in seconds, zero when absent. */
+    uint32_t retry_after_s;
+} http_headers_t;
+
+/**
+ * @brief Initialize the tracked headers for a new response.
+ *
+ * @param[out] headers Tracked headers.
+ * @param[out] etag Buffer receiving the ETag of the response, NULL if not requested.
+ * @param[in] etag_size Size of the ETag buffer.
+ */
+void http_headers_init(http_headers_t *headers, char *etag, size_t etag_size);
+
+/**
+ * @brief Process a piece of the name of a header.
+ *
+ * @param[inout] headers Tracked headers.
+ * @param[in] at Piece of the name.
+ * @param[in] length Length of the piece.
+ */
+void http_headers_on_field(http_headers_t *headers, const char *at, size_t length);
+
+/**
+ * @brief Process a piece of the value of a header.
+ *
+ * @param[inout] headers Tracked headers.
+ * @param[in] at Piece of the value.
+ * @param[in] length Length of the piece.
+ */
+void http_headers_on_value(http_headers_t *headers, const char *at, size_t length);
+
+/**
+ * @brief Parse the last header once all the headers have been received.
+ *
+ * @param[inout] headers Tracked headers.
+ */
+void http_headers_on_complete(http_headers_t *headers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_HEADERS_H
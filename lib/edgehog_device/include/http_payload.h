@@ -0,0 +1,46 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef HTTP_PAYLOAD_H
+#define HTTP_PAYLOAD_H
+
+/**
+ * @file http_payload.h
+ * @brief Upload of HTTP request payloads, with or without chunked transfer encoding.
+ */
+
+#include "edgehog_device/result.h"
+#include "http.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Send a request payload, fetching its chunks from a user callback.
+ *
+ * @details With chunked transfer encoding each non empty chunk is framed with its length and
+ * the payload is terminated with the last chunk and an empty trailer. Empty chunks are skipped,
+ * as a zero length chunk would terminate the payload.
+ *
+ * @param[in] sock The connected socket descriptor.
+ * @param[in] chunked Set when the payload is sent with chunked transfer encoding.
+ * @param[in] payload_cbk Callback returning the chunks of the payload.
+ * @param[in] user_data User data passed to the callback.
+ * @param[out] result Result of the upload, the error of the callback when it fails.
+ * @return The total number of bytes sent, framing included, or a negative value on error.
+ */
+int http_payload_send(int sock, bool chunked, edgehog_http_payload_cbk_t payload_cbk,
+    void *user_data, edgehog_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_PAYLOAD_H
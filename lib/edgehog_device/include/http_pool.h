@@ -0,0 +1,103 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef HTTP_POOL_H
+#define HTTP_POOL_H
+
+/**
+ * @file http_pool.h
+ * @brief Keep-alive pool of the idle HTTP connections.
+ *
+ * @details Idle connections are stored with the host and port they are connected to, and closed
+ * once idle for CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE_IDLE_TIMEOUT_MS. When the pool is
+ * full the connection idle for the longest time is closed to make room for a new one.
+ *
+ * @note The pool is not thread safe, the caller serializes the accesses to it.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum size of a host name stored in the pool. */
+#define HTTP_POOL_HOST_SIZE 128
+/** @brief Maximum size of a port stored in the pool. */
+#define HTTP_POOL_PORT_SIZE 6
+
+/** @brief An idle connection stored in the keep-alive pool. */
+typedef struct
+{
+    /** @brief Flag marking the slot as holding an idle connection. */
+    bool in_use;
+    /** @brief The connected socket. */
+    int sock;
+    /** @brief Host the socket is connected to. */
+    char host[HTTP_POOL_HOST_SIZE];
+    /** @brief Port the socket is connected to. */
+    char port[HTTP_POOL_PORT_SIZE];
+    /** @brief Uptime in ms at which the connection has been returned to the pool. */
+    int64_t idle_since_ms;
+} http_pool_entry_t;
+
+/** @brief Data struct for the keep-alive pool. */
+typedef struct
+{
+    /** @brief Idle connections. */
+    http_pool_entry_t entries[CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE_POOL_SIZE];
+} http_pool_t;
+
+/**
+ * @brief Take an idle connection to a server out of the pool.
+ *
+ * @details Expired connections, and connections closed by the server while idle, are closed and
+ * never returned.
+ *
+ * @param[inout] pool Keep-alive pool.
+ * @param[in] host Host of the server.
+ * @param[in] port Port of the server.
+ * @param[in] now_ms Current uptime in ms.
+ * @return -1 if no usable connection is present, a connected socket otherwise.
+ */
+int http_pool_take(http_pool_t *pool, const char *host, const char *port, int64_t now_ms);
+
+/**
+ * @brief Store an idle connection in the pool, evicting the oldest one if full.
+ *
+ * @details The socket is closed when the host name doesn't fit the pool.
+ *
+ * @param[inout] pool Keep-alive pool.
+ * @param[in] sock The connected socket to store.
+ * @param[in] host Host the socket is connected to.
+ * @param[in] port Port the socket is connected to.
+ * @param[in] now_ms Current uptime in ms.
+ */
+void http_pool_put(http_pool_t *pool, int sock, const char *host, const char *port, int64_t now_ms);
+
+/**
+ * @brief Close the connections idle since more than the configured timeout.
+ *
+ * @param[inout] pool Keep-alive pool.
+ * @param[in] now_ms Current uptime in ms.
+ * @return Time in ms after which the next connection will expire, -1 if the pool is empty.
+ */
+int64_t http_pool_evict_expired(http_pool_t *pool, int64_t now_ms);
+
+/**
+ * @brief Close all the connections in the pool.
+ *
+ * @param[inout] pool Keep-alive pool.
+ */
+void http_pool_close_all(http_pool_t *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_POOL_H
@@ -18,6 +18,43 @@
 #include <zephyr/dfu/flash_img.h>
 #include <zephyr/kernel.h>
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+#include "file_transfer/decompression.h"
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+#include "ota_delta.h"
+#endif
+#include "ota_image.h"
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+#include "ztar/unpack.h"
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+#include <psa/crypto.h>
+#endif
+
+/** @brief Size of the buffer holding the ETag of the OTA image, quotes and terminator included. */
+#define OTA_ETAG_SIZE 80
+
+#if defined(CONFIG_MCUBOOT_BOOTLOADER_MODE_DIRECT_XIP)                                            \
+    || defined(CONFIG_MCUBOOT_BOOTLOADER_MODE_DIRECT_XIP_WITH_REVERT)                             \
+    || defined(CONFIG_MCUBOOT_BOOTLOADER_MODE_RAM_LOAD)
+/** @brief Set when MCUboot boots the newest image of the two slots, updates go to the other one. */
+#define OTA_SLOT_SELECTION
+#endif
+
+#if defined(CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION) || defined(CONFIG_EDGEHOG_DEVICE_OTA_DELTA)     \
+    || defined(CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE)
+/** @brief Set when the OTA image can be encoded, the encoding is detected from its first bytes. */
+#define OTA_ENCODING_DETECTION
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+/** @brief Bytes at the start of the download needed to detect its encoding, up to the TAR magic. */
+#define OTA_ENCODING_PROBE_SIZE (offsetof(ztar_header_t, magic) + ZTAR_HEADER_FIELD_MAGIC_LEN)
+#else
+/** @brief Bytes at the start of the download needed to detect its encoding, up to the LZ4 size. */
+#define OTA_ENCODING_PROBE_SIZE 14
+#endif
+#endif
+
 /**
  * @brief OTA Request data.
  *
@@ -29,8 +66,33 @@ typedef struct
     char *uuid;
     /** @brief OTA download url. */
     char *download_url;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STAGED
+    /** @brief Set when the image has already been staged before a reboot. */
+    bool staged;
+#endif
 } ota_request_t;
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STATS
+/** @brief Timing of an OTA update, logged at the end of the download. */
+typedef struct
+{
+    /** @brief Uptime at the start of the OTA update. */
+    int64_t start_ms;
+    /** @brief Uptime at the start of the current download attempt. */
+    int64_t attempt_start_ms;
+    /** @brief Uptime of the first chunk of the current attempt, zero until it is received. */
+    int64_t first_byte_ms;
+    /** @brief Time between the first request and its first chunk, negative until received. */
+    int64_t ttfb_ms;
+    /** @brief Time from the first chunk of each attempt until all its chunks are written. */
+    int64_t transfer_ms;
+    /** @brief Time spent erasing the secondary slot. */
+    int64_t erase_ms;
+    /** @brief Bytes of the download received over all the attempts. */
+    size_t bytes;
+} ota_stats_t;
+#endif
+
 /**
  * @brief OTA Thread data.
  *
@@ -46,8 +108,98 @@ typedef struct
     size_t download_size;
     /** @brief Size of the OTA image. */
     size_t image_size;
+    /** @brief Bytes of the image passed to the flash writer, where a new attempt resumes from. */
+    size_t received_size;
+    /** @brief Bytes of the response body processed during the current download attempt. */
+    size_t attempt_received_size;
+    /** @brief Bytes persisted in flash at the time of the last download checkpoint. */
+    size_t checkpoint_size;
+#ifdef OTA_ENCODING_DETECTION
+    /** @brief First bytes of the download, gathered across chunks to detect the encoding. */
+    uint8_t probe_buf[OTA_ENCODING_PROBE_SIZE];
+    /** @brief Bytes held in the probe buffer. */
+    size_t probe_size;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PROGRESSIVE_ERASE
+    /** @brief Bytes at the beginning of the secondary slot erased for the current download. */
+    size_t erased_size;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_SKIP_IDENTICAL_SECTORS
+    /** @brief Set when the sectors of the image are compared with the secondary slot. */
+    bool compare_sectors;
+    /** @brief Bytes of the sector being received held in the sector buffer. */
+    size_t sector_buf_size;
+    /** @brief Sectors erased and programmed during the current OTA update. */
+    uint32_t sectors_written;
+    /** @brief Sectors skipped during the current OTA update as the slot already held them. */
+    uint32_t sectors_skipped;
+#endif
     /** @brief Last download percentage sent to the server. */
     uint8_t last_perc_sent;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE
+    /** @brief Download percentage published by the pipeline thread for the OTA thread. */
+    atomic_t download_perc;
+#endif
+    /** @brief Status code of the response to the last download attempt, zero if none. */
+    uint16_t http_status;
+    /** @brief Delay before the next attempt requested by the server, in seconds. */
+    uint32_t retry_after_s;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STATS
+    /** @brief Timing of the OTA update. */
+    ota_stats_t stats;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    /** @brief Set when the image is downloaded as an LZ4 frame. */
+    bool compressed;
+    /** @brief Size of the compressed image. */
+    size_t compressed_size;
+    /** @brief Result of the last write of decompressed data. */
+    edgehog_result_t decompressed_write_result;
+    /** @brief Decompression context of a compressed image. */
+    file_transfer_decompression_ctx_t decomp_ctx;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    /** @brief Set when the image is reconstructed from a delta patch. */
+    bool delta;
+    /** @brief Context of the delta patch applier. */
+    ota_delta_ctx_t delta_ctx;
+    /** @brief Result of the last write of patched data. */
+    edgehog_result_t patched_write_result;
+#endif
+    /** @brief MCUboot image being written, non zero only for the members of a bundle. */
+    uint8_t image_index;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    /** @brief Set when the download is a TAR bundle of several images. */
+    bool bundle;
+    /** @brief Unpacking context of a bundle. */
+    ztar_unpack_t bundle_ctx;
+    /** @brief Set while the member of the bundle being unpacked is not an image. */
+    bool bundle_skip;
+    /** @brief Mask of the images written from the bundle. */
+    uint8_t bundle_images;
+    /** @brief Size of the bundle download. */
+    size_t bundle_size;
+    /** @brief Result of the last write of bundle data. */
+    edgehog_result_t bundle_result;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+    /** @brief Running hash of the image written to the secondary slot. */
+    psa_hash_operation_t hash_operation;
+    /** @brief Bytes of the image passed to the running hash. */
+    size_t hash_offset;
+#endif
+    /** @brief First bytes of the image, holding the MCUboot header. */
+    uint8_t header_buf[OTA_IMAGE_HEADER_SIZE];
+    /** @brief MCUboot header of the image, valid when header_valid is set. */
+    ota_image_header_t image_header;
+    /** @brief Set when the first bytes of the image are a valid MCUboot header. */
+    bool header_valid;
+    /** @brief Set when the image has been rejected by the validation of its header. */
+    bool header_rejected;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT
+    /** @brief ETag of the OTA image returned by the server, empty if none. */
+    char etag[OTA_ETAG_SIZE];
+#endif
     /** @brief OTA thread running state. */
     atomic_t ota_run_state;
 } ota_thread_data_t;
@@ -0,0 +1,60 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_BUNDLE_H
+#define OTA_BUNDLE_H
+
+/**
+ * @file ota_bundle.h
+ * @brief Unpacking of an OTA bundle, a TAR archive holding several MCUboot images.
+ *
+ * @details The members named image-<N>, with an optional suffix, are written to the secondary
+ * slot of MCUboot image N as they are unpacked, the other members are skipped.
+ */
+
+#include "edgehog_device/result.h"
+#include "ota.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Check if the OTA download is a TAR bundle of images.
+ *
+ * @param[in] data First bytes of the download.
+ * @param[in] size Number of bytes available.
+ * @return true if the data starts with a USTAR header, false otherwise.
+ */
+bool ota_bundle_is_bundle(const uint8_t *data, size_t size);
+
+/**
+ * @brief Start unpacking a TAR bundle of images.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_bundle_start(ota_thread_data_t *thread_data);
+
+/**
+ * @brief Unpack a chunk of a TAR bundle of images.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] data Chunk of the bundle.
+ * @param[in] size Size of the chunk.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_bundle_write(ota_thread_data_t *thread_data, const uint8_t *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OTA_BUNDLE_H
@@ -0,0 +1,102 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_CHECKPOINT_H
+#define OTA_CHECKPOINT_H
+
+/**
+ * @file ota_checkpoint.h
+ * @brief Checkpoints of the OTA download, used to resume it after a reboot.
+ *
+ * @details A checkpoint records how much of the image has been persisted in the secondary slot.
+ * A new one is saved every CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT_INTERVAL bytes, the download is
+ * resumed from the start of the flash page holding the last one.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/uuid.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief OTA download checkpoint.
+ *
+ * @details Progress of an OTA download persisted in Edgehog settings, used to resume the download
+ * after a reboot.
+ */
+typedef struct
+{
+    /** @brief UUID of the OTA request the checkpoint belongs to. */
+    char uuid[UUID_STR_LEN];
+    /** @brief Hash of the download URL of the OTA request. */
+    uint32_t url_hash;
+    /** @brief Total size of the OTA image. */
+    uint32_t image_size;
+    /** @brief Bytes of the image persisted in the secondary slot. */
+    uint32_t bytes_written;
+    /** @brief Absolute flash offset of the next write. */
+    uint32_t flash_offset;
+} ota_checkpoint_t;
+
+/**
+ * @brief Fill a checkpoint of the running download.
+ *
+ * @param[out] checkpoint Checkpoint to fill.
+ * @param[in] uuid UUID of the OTA request.
+ * @param[in] url_hash Hash of the download URL of the OTA request.
+ * @param[in] image_size Total size of the OTA image.
+ * @param[in] flash_area Flash area of the secondary slot.
+ * @param[in] persisted_size Bytes of the image persisted in the secondary slot.
+ */
+void ota_checkpoint_init(ota_checkpoint_t *checkpoint, const char *uuid, uint32_t url_hash,
+    size_t image_size, const struct flash_area *flash_area, size_t persisted_size);
+
+/**
+ * @brief Check if a checkpoint belongs to an OTA request and can be resumed.
+ *
+ * @param[in] checkpoint Checkpoint loaded from Edgehog settings.
+ * @param[in] uuid UUID of the OTA request.
+ * @param[in] url_hash Hash of the download URL of the OTA request.
+ * @return true if the download of the request can resume from the checkpoint, false otherwise.
+ */
+bool ota_checkpoint_matches(
+    const ota_checkpoint_t *checkpoint, const char *uuid, uint32_t url_hash);
+
+/**
+ * @brief Check if enough data has been persisted since the last checkpoint to save a new one.
+ *
+ * @param[in] checkpoint_size Bytes persisted at the time of the last checkpoint.
+ * @param[in] persisted_size Bytes of the image persisted in the secondary slot.
+ * @param[in] image_size Total size of the OTA image.
+ * @return true if a new checkpoint should be saved, false otherwise.
+ */
+bool ota_checkpoint_is_due(size_t checkpoint_size, size_t persisted_size, size_t image_size);
+
+/**
+ * @brief Get the number of bytes of the image kept in the secondary slot when resuming.
+ *
+ * @details Data could have been written after the checkpoint, the download resumes from the start
+ * of the flash page containing it.
+ *
+ * @param[in] checkpoint Checkpoint of the download.
+ * @param[in] flash_area Flash area of the secondary slot.
+ * @param[out] resume_size Bytes of the image kept in the slot.
+ * @return true if the download can resume from the checkpoint, false if it has to restart.
+ */
+bool ota_checkpoint_get_resume_size(const ota_checkpoint_t *checkpoint,
+    const struct flash_area *flash_area, size_t *resume_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OTA_CHECKPOINT_H
@@ -0,0 +1,165 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_DELTA_H
+#define OTA_DELTA_H
+
+/**
+ * @file ota_delta.h
+ * @brief Streaming applier of delta OTA patches.
+ *
+ * @details A delta patch reconstructs the new image from the image running in the primary slot.
+ * It is made of a header followed by a sequence of bsdiff-style records, all integers are little
+ * endian:
+ * - header: magic, source size, target size, reserved word, SHA-256 of the source image and
+ *   SHA-256 of the target image.
+ * - record: diff length, extra length and signed source seek, followed by diff length bytes to
+ *   add to the source image bytes at the source cursor, and by extra length bytes copied as they
+ *   are. The source cursor is then moved by the seek.
+ *
+ * The patch is applied as it is received, using a fixed amount of RAM.
+ */
+
+#include "edgehog_device/result.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <psa/crypto.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Magic number at the beginning of a delta patch, "EHDP" in little endian. */
+#define OTA_DELTA_MAGIC 0x50444845U
+/** @brief Size of the SHA-256 hashes stored in the patch header. */
+#define OTA_DELTA_HASH_SIZE 32
+/** @brief Size of the patch header. */
+#define OTA_DELTA_HEADER_SIZE (4 * sizeof(uint32_t) + 2 * OTA_DELTA_HASH_SIZE)
+/** @brief Size of a record control block. */
+#define OTA_DELTA_CONTROL_SIZE (3 * sizeof(uint32_t))
+/** @brief Size of the buffer used to read the source image. */
+#define OTA_DELTA_SOURCE_BUF_SIZE 256
+
+/**
+ * @typedef ota_delta_write_cbk_t
+ * @brief Callback used when a chunk of the reconstructed image is ready to be written.
+ *
+ * @param[in] data Pointer to the reconstructed data.
+ * @param[in] size Size of the reconstructed data.
+ * @param[inout] user_data User specified data passed during initialization.
+ * @return 0 if successful, otherwise a negative error code.
+ */
+typedef int (*ota_delta_write_cbk_t)(const uint8_t *data, size_t size, void *user_data);
+
+/** @brief States of the patch parser. */
+typedef enum
+{
+    /** @brief Receiving the patch header. */
+    OTA_DELTA_STATE_HEADER = 0,
+    /** @brief Receiving the control block of a record. */
+    OTA_DELTA_STATE_CONTROL,
+    /** @brief Receiving the diff bytes of a record. */
+    OTA_DELTA_STATE_DIFF,
+    /** @brief Receiving the extra bytes of a record. */
+    OTA_DELTA_STATE_EXTRA,
+} ota_delta_state_t;
+
+/** @brief Data struct for a delta patch context instance. */
+typedef struct
+{
+    /** @brief Current state of the patch parser. */
+    ota_delta_state_t state;
+    /** @brief Buffer accumulating the header and the control blocks. */
+    uint8_t header_buf[OTA_DELTA_HEADER_SIZE];
+    /** @brief Bytes accumulated in the header buffer. */
+    size_t header_len;
+    /** @brief Buffer used to read the source image and build the reconstructed data. */
+    uint8_t source_buf[OTA_DELTA_SOURCE_BUF_SIZE] __aligned(4);
+    /** @brief Flash area of the source image. */
+    const struct flash_area *source_area;
+    /** @brief Size of the source image. */
+    size_t source_size;
+    /** @brief Size of the target image. */
+    size_t target_size;
+    /** @brief Expected SHA-256 of the target image. */
+    uint8_t target_hash[OTA_DELTA_HASH_SIZE];
+    /** @brief Position of the source cursor. */
+    size_t source_offset;
+    /** @brief Bytes of the target image reconstructed so far. */
+    size_t target_offset;
+    /** @brief Remaining diff bytes of the current record. */
+    size_t diff_left;
+    /** @brief Remaining extra bytes of the current record. */
+    size_t extra_left;
+    /** @brief Source seek to apply at the end of the current record. */
+    int32_t seek;
+    /** @brief Hash of the reconstructed image. */
+    psa_hash_operation_t hash_operation;
+    /** @brief Callback for writing the reconstructed image. */
+    ota_delta_write_cbk_t write_cbk;
+    /** @brief User data passed to the write callback. */
+    void *user_data;
+} ota_delta_ctx_t;
+
+/**
+ * @brief Check if a download starts with a delta patch.
+ *
+ * @param[in] data First bytes of the download.
+ * @param[in] size Number of bytes available.
+ * @return true if the data is the beginning of a delta patch, false otherwise.
+ */
+bool ota_delta_is_patch(const uint8_t *data, size_t size);
+
+/**
+ * @brief Initialize a delta patch context.
+ *
+ * @param[out] ctx Context to initialize.
+ * @param[in] source_area_id Flash area holding the source image.
+ * @param[in] write_cbk Callback to execute when reconstructed data is ready.
+ * @param[in] user_data User specified data to pass to the callback.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_delta_init(ota_delta_ctx_t *ctx, uint8_t source_area_id,
+    ota_delta_write_cbk_t write_cbk, void *user_data);
+
+/**
+ * @brief Apply a chunk of the patch.
+ *
+ * @details Once the header has been received the source image is verified against its hash,
+ * a mismatch returns EDGEHOG_RESULT_OTA_INVALID_IMAGE.
+ *
+ * @param[inout] ctx Delta patch context.
+ * @param[in] data Chunk of the patch.
+ * @param[in] size Size of the chunk.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_delta_process(ota_delta_ctx_t *ctx, const uint8_t *data, size_t size);
+
+/**
+ * @brief Check that the patch has been fully applied and the target image matches its hash.
+ *
+ * @param[inout] ctx Delta patch context.
+ * @return EDGEHOG_RESULT_OK on success, EDGEHOG_RESULT_OTA_INVALID_IMAGE otherwise.
+ */
+edgehog_result_t ota_delta_finish(ota_delta_ctx_t *ctx);
+
+/**
+ * @brief Release the resources of a delta patch context.
+ *
+ * @param[inout] ctx Delta patch context.
+ */
+void ota_delta_free(ota_delta_ctx_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTA_DELTA_H */
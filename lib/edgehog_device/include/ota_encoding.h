@@ -0,0 +1,94 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_ENCODING_H
+#define OTA_ENCODING_H
+
+/**
+ * @file ota_encoding.h
+ * @brief Detection and decoding of the encoded OTA downloads.
+ *
+ * @details An OTA image can be downloaded compressed as an LZ4 frame, as a delta patch of the
+ * running image or as a TAR bundle of images, a compressed download wrapping one of the other
+ * two. The encoding is detected from the first bytes of the download.
+ */
+
+#include "edgehog_device/result.h"
+#include "http.h"
+#include "ota.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @typedef ota_encoding_write_cbk_t
+ * @brief Callback writing a chunk of the download once its encoding is known.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] response_chunk Chunk of the HTTP response.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+typedef edgehog_result_t (*ota_encoding_write_cbk_t)(
+    ota_thread_data_t *thread_data, edgehog_http_response_chunk_t *response_chunk);
+
+/**
+ * @brief Gather the first bytes of the download and detect the encoding of the image from them.
+ *
+ * @details The magic numbers of the encodings can be split across chunks. The bytes are held
+ * back until OTA_ENCODING_PROBE_SIZE of them, or the whole download, have been received, then
+ * they are written followed by the rest of the chunk.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] response_chunk Chunk of the HTTP response.
+ * @param[in] write_cbk Callback writing the gathered bytes and the rest of the chunk.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_encoding_probe(ota_thread_data_t *thread_data,
+    edgehog_http_response_chunk_t *response_chunk, ota_encoding_write_cbk_t write_cbk);
+
+/**
+ * @brief Check if the image is downloaded in an encoded form.
+ *
+ * @param[in] thread_data OTA thread data.
+ * @return true if the image is encoded, false otherwise.
+ */
+bool ota_encoding_is_encoded(const ota_thread_data_t *thread_data);
+
+/**
+ * @brief Decode a chunk of an encoded image download into the secondary slot.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] response_chunk Chunk of the HTTP response.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_encoding_write_chunk(
+    ota_thread_data_t *thread_data, edgehog_http_response_chunk_t *response_chunk);
+
+/**
+ * @brief Discard a partially downloaded encoded image so that the download restarts.
+ *
+ * @details The decoding state can't be restored, so the whole image is downloaded again.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_encoding_restart(ota_thread_data_t *thread_data);
+
+/**
+ * @brief Release the decoding contexts of an encoded image.
+ *
+ * @param[inout] thread_data OTA thread data.
+ */
+void ota_encoding_free(ota_thread_data_t *thread_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OTA_ENCODING_H
@@ -0,0 +1,208 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_FLASH_H
+#define OTA_FLASH_H
+
+/**
+ * @file ota_flash.h
+ * @brief Flash slots of the OTA images and writer of the downloaded image.
+ *
+ * @details The MCUboot header of the image is collected and validated while it is written, and
+ * with CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH the image is hashed on the fly.
+ */
+
+#include "edgehog_device/result.h"
+#include "ota.h"
+
+#include <zephyr/storage/flash_map.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the receive buffer of the OTA download.
+ *
+ * @details The buffer is lent to the HTTP client during the download, it is aligned so that the
+ * image can be written to flash straight from it. Before the download starts it is used to read
+ * back the secondary slot.
+ *
+ * @param[out] size Size of the buffer.
+ * @return Pointer to the buffer.
+ */
+uint8_t *ota_flash_get_recv_buf(size_t *size);
+
+/**
+ * @brief Get the number of MCUboot images that can be updated.
+ *
+ * @return Number of image pairs, one unless CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE is enabled.
+ */
+uint8_t ota_flash_get_images_count(void);
+
+/**
+ * @brief Get the flash area of the running image.
+ *
+ * @return Flash area ID of the slot the running image has been booted from.
+ */
+uint8_t ota_flash_get_running_area_id(void);
+
+/**
+ * @brief Get the flash area the OTA image is downloaded to.
+ *
+ * @details With the MCUboot direct-XIP and RAM-load modes this is the slot not holding the
+ * running image, otherwise it is always the secondary slot.
+ *
+ * @return Flash area ID of the slot receiving the update.
+ */
+uint8_t ota_flash_get_upload_area_id(void);
+
+/**
+ * @brief Get the flash area of the running version of an MCUboot image.
+ *
+ * @param[in] image_index Index of the MCUboot image.
+ * @return Flash area ID of the slot the image runs from.
+ */
+uint8_t ota_flash_get_image_running_area_id(uint8_t image_index);
+
+/**
+ * @brief Get the flash area a new version of an MCUboot image is downloaded to.
+ *
+ * @param[in] image_index Index of the MCUboot image.
+ * @return Flash area ID of the slot receiving the update of the image.
+ */
+uint8_t ota_flash_get_image_upload_area_id(uint8_t image_index);
+
+/**
+ * @brief Get the MCUboot images written by the OTA download.
+ *
+ * @param[in] thread_data OTA thread data.
+ * @return Mask of the image indexes, only image 0 unless the download was a bundle.
+ */
+uint8_t ota_flash_get_images(const ota_thread_data_t *thread_data);
+
+/**
+ * @brief Write a chunk of the image to the secondary slot.
+ *
+ * @details Whole write blocks received in the lent receive buffer are written to flash straight
+ * from it when the stream flash buffer is empty, the rest goes through the stream flash buffer.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] data Chunk of the image to write.
+ * @param[in] size Size of the chunk.
+ * @param[in] flush Flush the stream flash buffer after the write.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+int ota_flash_write(ota_thread_data_t *thread_data, const uint8_t *data, size_t size, bool flush);
+
+/**
+ * @brief Advance the write position of the flash stream over data already in the upload slot.
+ *
+ * @details Accounts for data written outside of the stream flash API or kept from an interrupted
+ * download. The stream flash API has no call for it, this is the only place updating the
+ * stream flash context directly.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] size Number of bytes to advance by.
+ * @return 0 upon success, -EINVAL if data is pending in the stream flash buffer, -ENOMEM if the
+ * position would exceed the slot.
+ */
+int ota_flash_advance_stream(ota_thread_data_t *thread_data, size_t size);
+
+/**
+ * @brief Prepare the secondary slot for a new download.
+ *
+ * @details With CONFIG_EDGEHOG_DEVICE_OTA_PROGRESSIVE_ERASE only the MCUboot trailer is erased,
+ * the pages of the image are erased by the writes reaching them. Otherwise the whole slot is
+ * erased.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_flash_erase_slot(ota_thread_data_t *thread_data);
+
+/**
+ * @brief Erase a range of the secondary slot, accounting the time spent in the OTA stats.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] offset Offset in the slot of the first byte to erase.
+ * @param[in] size Number of bytes to erase.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+int ota_flash_erase(ota_thread_data_t *thread_data, size_t offset, size_t size);
+
+#if defined(CONFIG_EDGEHOG_DEVICE_OTA_PROGRESSIVE_ERASE)                                          \
+    || defined(CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT)
+/**
+ * @brief Erase the flash pages of the secondary slot holding the MCUboot trailer.
+ *
+ * @param[in] flash_area Flash area of the secondary slot.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+int ota_flash_erase_trailer(const struct flash_area *flash_area);
+
+/**
+ * @brief Get the offset of the first flash page of the secondary slot holding the MCUboot trailer.
+ *
+ * @param[in] flash_area Flash area of the secondary slot.
+ * @param[out] trailer_start Offset in the slot of the first page of the trailer.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+int ota_flash_get_trailer_start(const struct flash_area *flash_area, size_t *trailer_start);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+/**
+ * @brief Start a new running hash of the image.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_flash_start_hash(ota_thread_data_t *thread_data);
+
+/**
+ * @brief Hash the beginning of the image already written to the secondary slot.
+ *
+ * @details The MCUboot header of the image is collected from the slot as well.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] size Bytes of the image to hash.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_flash_hash_slot(ota_thread_data_t *thread_data, size_t size);
+
+/**
+ * @brief Compare the running hash of the downloaded image with its MCUboot hash TLV.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @return EDGEHOG_RESULT_OK if the hashes match, EDGEHOG_RESULT_OTA_INVALID_IMAGE if the image is
+ * corrupted or truncated, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_flash_verify_hash(ota_thread_data_t *thread_data);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+/**
+ * @brief Resume writing the secondary slot after the data kept from an interrupted download.
+ *
+ * @details The data following the resume point is erased, or left to the progressive erase. The
+ * image header, and with CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH the running hash, are rebuilt
+ * from the data kept in the slot.
+ *
+ * @note The flash image context should be already initialized.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] resume_size Bytes of the image kept in the slot.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_flash_resume(ota_thread_data_t *thread_data, size_t resume_size);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OTA_FLASH_H
@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_IMAGE_H
+#define OTA_IMAGE_H
+
+/**
+ * @file ota_image.h
+ * @brief Parsing of the header and of the TLVs of MCUboot images.
+ *
+ * @details An MCUboot image starts with a header of OTA_IMAGE_HEADER_SIZE bytes, padded to the
+ * header size it declares, followed by the image body and by the protected and unprotected TLV
+ * areas. The SHA-256 TLV of the unprotected area is computed on the header, the body and the
+ * protected TLVs.
+ */
+
+#include "edgehog_device/result.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/dfu/mcuboot.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Size of the fixed part of the MCUboot image header. */
+#define OTA_IMAGE_HEADER_SIZE 32
+/** @brief Size of the SHA-256 hash of the image. */
+#define OTA_IMAGE_HASH_SIZE 32
+/** @brief Image flag set when the image is copied to RAM at the load address before running. */
+#define OTA_IMAGE_F_RAM_LOAD 0x00000020U
+
+/** @brief Fields of an MCUboot image header. */
+typedef struct
+{
+    /** @brief Address the image is loaded to, for images that are not executed in place. */
+    uint32_t load_addr;
+    /** @brief Size of the header, including the padding before the image body. */
+    uint16_t hdr_size;
+    /** @brief Size of the protected TLV area, zero if there are no protected TLVs. */
+    uint16_t protect_tlv_size;
+    /** @brief Size of the image body. */
+    uint32_t img_size;
+    /** @brief Image flags. */
+    uint32_t flags;
+    /** @brief Version of the image. */
+    struct mcuboot_img_sem_ver version;
+} ota_image_header_t;
+
+/**
+ * @brief Parse an MCUboot image header.
+ *
+ * @param[in] data First bytes of the image.
+ * @param[in] size Number of bytes available, at least OTA_IMAGE_HEADER_SIZE.
+ * @param[out] header Parsed header.
+ * @return EDGEHOG_RESULT_OK on success, EDGEHOG_RESULT_OTA_INVALID_IMAGE if the data is not an
+ * MCUboot image header.
+ */
+edgehog_result_t ota_image_parse_header(
+    const uint8_t *data, size_t size, ota_image_header_t *header);
+
+/**
+ * @brief Read and parse the header of the image stored in a flash area.
+ *
+ * @param[in] area_id Flash area holding the image.
+ * @param[out] header Parsed header.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_image_read_header(uint8_t area_id, ota_image_header_t *header);
+
+/**
+ * @brief Get the size of the part of the image covered by its hash.
+ *
+ * @param[in] header Header of the image.
+ * @return Size of the header, the body and the protected TLVs.
+ */
+size_t ota_image_hashed_size(const ota_image_header_t *header);
+
+/**
+ * @brief Compare two image versions.
+ *
+ * @param[in] a First version.
+ * @param[in] b Second version.
+ * @return A negative value if a is older than b, zero if they are equal, a positive value if a
+ * is newer than b. The build number is compared last.
+ */
+int ota_image_compare_versions(
+    const struct mcuboot_img_sem_ver *a, const struct mcuboot_img_sem_ver *b);
+
+/**
+ * @brief Get the total size of the image stored in a flash area, TLVs included.
+ *
+ * @param[in] area_id Flash area holding the image.
+ * @param[in] header Header of the image.
+ * @param[out] size Size of the image.
+ * @return EDGEHOG_RESULT_OK on success, EDGEHOG_RESULT_OTA_INVALID_IMAGE if the TLV area is
+ * malformed, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_image_read_size(
+    uint8_t area_id, const ota_image_header_t *header, size_t *size);
+
+/**
+ * @brief Read the SHA-256 TLV of the image stored in a flash area.
+ *
+ * @param[in] area_id Flash area holding the image.
+ * @param[in] header Header of the image.
+ * @param[out] hash SHA-256 of the image stored in its TLVs.
+ * @param[out] found Set to false when the image is hashed with another algorithm.
+ * @return EDGEHOG_RESULT_OK on success, EDGEHOG_RESULT_OTA_INVALID_IMAGE if the TLV area is
+ * malformed, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_image_read_hash(uint8_t area_id, const ota_image_header_t *header,
+    uint8_t hash[OTA_IMAGE_HASH_SIZE], bool *found);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTA_IMAGE_H */
@@ -0,0 +1,78 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_PIPELINE_H
+#define OTA_PIPELINE_H
+
+/**
+ * @file ota_pipeline.h
+ * @brief Pipeline decoupling the reception of the OTA image from its write to flash.
+ *
+ * @details Chunks received by the HTTP client are copied in one of
+ * CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE_BUFFERS buffers and processed in order by a dedicated writer
+ * thread, so that the socket keeps being read while a flash page is erased or programmed.
+ * The receiving thread only blocks when all the buffers are waiting to be written.
+ */
+
+#include "edgehog_device/result.h"
+#include "http.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @typedef ota_pipeline_process_cbk_t
+ * @brief Callback processing a chunk of the image in the writer thread.
+ *
+ * @param[in] response_chunk Chunk of the HTTP response, its data is stored in a pipeline buffer.
+ * @param[inout] user_data User specified data passed to ota_pipeline_start.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+typedef edgehog_result_t (*ota_pipeline_process_cbk_t)(
+    edgehog_http_response_chunk_t *response_chunk, void *user_data);
+
+/**
+ * @brief Start the writer thread of the pipeline.
+ *
+ * @param[in] process_cbk Callback processing each chunk.
+ * @param[in] user_data User specified data passed to the callback.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+edgehog_result_t ota_pipeline_start(ota_pipeline_process_cbk_t process_cbk, void *user_data);
+
+/**
+ * @brief Queue a chunk of the image to be processed by the writer thread.
+ *
+ * @details The chunk data is copied, waiting for a free buffer if all of them are in use.
+ *
+ * @param[in] response_chunk Chunk of the HTTP response.
+ * @return EDGEHOG_RESULT_OK on success, the error of a previously processed chunk otherwise.
+ */
+edgehog_result_t ota_pipeline_push(const edgehog_http_response_chunk_t *response_chunk);
+
+/**
+ * @brief Wait for all the queued chunks to be processed.
+ *
+ * @details Logs the time spent by the writer thread waiting for the network and by the receiving
+ * thread waiting for the flash since the last drain, and resets the error state.
+ *
+ * @return EDGEHOG_RESULT_OK if all the chunks have been processed, the first error otherwise.
+ */
+edgehog_result_t ota_pipeline_drain(void);
+
+/**
+ * @brief Stop the writer thread of the pipeline.
+ *
+ * @note Queued chunks are processed before the thread stops.
+ */
+void ota_pipeline_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTA_PIPELINE_H */
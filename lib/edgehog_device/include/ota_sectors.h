@@ -0,0 +1,50 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_SECTORS_H
+#define OTA_SECTORS_H
+
+/**
+ * @file ota_sectors.h
+ * @brief Write of the OTA image skipping the flash sectors the secondary slot already holds.
+ *
+ * @details Each sector of the image is collected in a buffer and compared with the content of
+ * the slot, it is erased and programmed only when they differ. An update differing from the
+ * previous image in a few sectors only wears those.
+ */
+
+#include "ota.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Prepare the comparison of the image sectors with the secondary slot for a new write.
+ *
+ * @details The comparison is disabled when a flash page of the slot doesn't fit the sector
+ * buffer, or isn't a multiple of the write block size the last sector is padded to.
+ *
+ * @param[inout] thread_data OTA thread data.
+ */
+void ota_sectors_start_compare(ota_thread_data_t *thread_data);
+
+/**
+ * @brief Write a chunk of the image to the secondary slot one flash sector at a time.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] data Chunk of the image to write.
+ * @param[in] size Size of the chunk.
+ * @param[in] flush Write the partial sector left in the buffer.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+int ota_sectors_write(ota_thread_data_t *thread_data, const uint8_t *data, size_t size, bool flush);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OTA_SECTORS_H
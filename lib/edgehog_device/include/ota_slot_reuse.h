@@ -0,0 +1,71 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_SLOT_REUSE_H
+#define OTA_SLOT_REUSE_H
+
+/**
+ * @file ota_slot_reuse.h
+ * @brief Reuse of the image left in the secondary slot by a previous OTA request.
+ */
+
+#include "ota.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Image stored in the secondary slot.
+ *
+ * @details Identifies the last image fully downloaded and verified, so that a retried OTA
+ * request for the same image can skip the download.
+ */
+typedef struct
+{
+    /** @brief Hash of the download URL of the image. */
+    uint32_t url_hash;
+    /** @brief ETag of the image returned by the server. */
+    char etag[OTA_ETAG_SIZE];
+    /** @brief SHA-256 of the image, as stored in its hash TLV. */
+    uint8_t image_hash[OTA_IMAGE_HASH_SIZE];
+} ota_slot_record_t;
+
+/**
+ * @brief Check if the secondary slot already holds the image of the OTA request.
+ *
+ * @details The image is reused when it has been downloaded from the same URL, the server still
+ * returns the same ETag for it, and the content of the slot matches its hash TLV.
+ *
+ * @note The flash image context should be already initialized.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] record Image stored in the secondary slot, as loaded from Edgehog settings.
+ * @param[in] url_hash Hash of the download URL of the OTA request.
+ * @return true if the download can be skipped, false otherwise.
+ */
+bool ota_slot_reuse_is_image_present(
+    ota_thread_data_t *thread_data, const ota_slot_record_t *record, uint32_t url_hash);
+
+/**
+ * @brief Get the identity of the image just written to the secondary slot.
+ *
+ * @param[in] thread_data OTA thread data.
+ * @param[in] url_hash Hash of the download URL of the OTA request.
+ * @param[out] record Image stored in the secondary slot.
+ * @return true if the image can be reused by a later request, false otherwise.
+ */
+bool ota_slot_reuse_get_record(
+    const ota_thread_data_t *thread_data, uint32_t url_hash, ota_slot_record_t *record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OTA_SLOT_REUSE_H
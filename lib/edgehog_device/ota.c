@@ -13,6 +13,19 @@
 #include "edgehog_private.h"
 #include "generated_interfaces.h"
 #include "http.h"
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+#include "ota_checkpoint.h"
+#endif
+#ifdef OTA_ENCODING_DETECTION
+#include "ota_encoding.h"
+#endif
+#include "ota_flash.h"
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE
+#include "ota_pipeline.h"
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT
+#include "ota_slot_reuse.h"
+#endif
 #include "settings.h"
 #include "system_time.h"
 
@@ -21,10 +34,14 @@
 #include <zephyr/device.h>
 #include <zephyr/dfu/flash_img.h>
 #include <zephyr/dfu/mcuboot.h>
-#include <zephyr/drivers/flash.h>
+#include <zephyr/net/http/status.h>
+#include <zephyr/random/random.h>
 #include <zephyr/storage/flash_map.h>
 #include <zephyr/sys/reboot.h>
-#include <zephyr/version.h>
+
+#ifdef CONFIG_MCUBOOT_BOOTLOADER_MODE_DIRECT_XIP_WITH_REVERT
+#include <bootutil/bootutil_public.h>
+#endif
 
 #include "log.h"
 EDGEHOG_LOG_MODULE_REGISTER(ota, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
@@ -37,25 +54,40 @@ EDGEHOG_LOG_MODULE_REGISTER(ota, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
 #define MAX_OTA_RETRY 5
 #define OTA_PROGRESS_PERC 100
 #define OTA_PROGRESS_PERC_ROUNDING_STEP 10
-#define OTA_ATTEMPS_DELAY_MS 2000
+#define OTA_RETRY_CANCEL_POLL_MS 1000
+#define BYTES_PER_KIB 1024
 #define OTA_REBOOT_MAX_DELAY_S 60
 
-#define SLOT0_LABEL slot0_partition
-#define SLOT1_LABEL slot1_partition
-
-#if KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(4, 4, 0)
-#define FLASH_AREA_IMAGE_PRIMARY PARTITION_ID(SLOT0_LABEL)
-#define FLASH_AREA_IMAGE_SECONDARY PARTITION_ID(SLOT1_LABEL)
-#else
-#define FLASH_AREA_IMAGE_PRIMARY FIXED_PARTITION_ID(SLOT0_LABEL)
-#define FLASH_AREA_IMAGE_SECONDARY FIXED_PARTITION_ID(SLOT1_LABEL)
+#if defined(OTA_SLOT_SELECTION) || defined(CONFIG_MCUBOOT_BOOTLOADER_MODE_OVERWRITE_ONLY)
+// No swap state is left after the reboot, the running image tells if the update booted
+#define OTA_SWAPLESS
 #endif
 
 #define OTA_KEY "ota"
 #define OTA_STATE_KEY "state"
 #define OTA_REQUEST_ID_KEY "req_id"
+#define OTA_URL_KEY "url"
+#define OTA_CHECKPOINT_KEY "ckpt"
+#define OTA_SLOT_KEY "slot"
+#define OTA_DEPLOY_KEY "deploy"
+#define OTA_IMAGES_KEY "images"
+
+#define FNV1A_32_OFFSET_BASIS 2166136261U
+#define FNV1A_32_PRIME 16777619U
 
 #define THREAD_STACK_SIZE 8192
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STAGED
+// Staged downloads run in the background of the application
+#define THREAD_PRIORITY CONFIG_EDGEHOG_DEVICE_OTA_STAGED_THREAD_PRIORITY
+// Without the zbus channel nor a maintenance window a staged image would never be activated
+#if !defined(CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT)                                                \
+    && (CONFIG_EDGEHOG_DEVICE_OTA_STAGED_WINDOW_START < 0)
+#error "Staged OTA updates need CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT or a maintenance window"
+#endif
+#else
+#define THREAD_PRIORITY K_HIGHEST_THREAD_PRIO
+#endif
+#define MINUTES_PER_DAY (24 * 60)
 #define OTA_STATE_RUN_BIT (1)
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
@@ -83,6 +115,8 @@ typedef enum
     OTA_STATE_IN_PROGRESS = 2,
     /** @brief The OTA machine is in Reboot state. */
     OTA_STATE_REBOOT = 3,
+    /** @brief The OTA machine is waiting for the activation of a staged image. */
+    OTA_STATE_STAGED = 4,
 } ota_state_t;
 
 /**
@@ -110,6 +144,23 @@ typedef enum
     OTA_EVENT_FAILURE = 8
 } ota_event_t;
 
+#ifdef OTA_SWAPLESS
+/**
+ * @brief Image deployed before the reboot.
+ *
+ * @details Compared with the running image after the reboot, to check that MCUboot booted it.
+ */
+typedef struct
+{
+    /** @brief Version of the image. */
+    struct mcuboot_img_sem_ver version;
+    /** @brief SHA-256 of the image, as stored in its hash TLV. */
+    uint8_t image_hash[OTA_IMAGE_HASH_SIZE];
+    /** @brief Flag set when the image has a SHA-256 TLV. */
+    bool hash_found;
+} ota_deploy_record_t;
+#endif
+
 /**
  * @brief OTA settings data.
  *
@@ -121,6 +172,30 @@ typedef struct
     char uuid[UUID_STR_LEN];
     /** @brief OTA state. */
     uint8_t ota_state;
+    /** @brief Download URL of the OTA request, dynamically allocated when found. */
+    char *url;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+    /** @brief Last download checkpoint. */
+    ota_checkpoint_t checkpoint;
+    /** @brief Flag set when a checkpoint has been found. */
+    bool checkpoint_found;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT
+    /** @brief Image stored in the secondary slot. */
+    ota_slot_record_t slot_record;
+    /** @brief Flag set when the image stored in the secondary slot is known. */
+    bool slot_record_found;
+#endif
+#ifdef OTA_SWAPLESS
+    /** @brief Image deployed before the reboot. */
+    ota_deploy_record_t deploy_record;
+    /** @brief Flag set when the deployed image is known. */
+    bool deploy_record_found;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    /** @brief Mask of the images deployed together, zero when only image 0 has been deployed. */
+    uint8_t images;
+#endif
 } ota_settings_t;
 
 /************************************************
@@ -142,11 +217,140 @@ static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3)
  */
 static void wait_for_reboot(void);
 
+/**
+ * @brief Take the OTA/file transfer semaphore, waiting for the file transfers in progress.
+ *
+ * @details No new file transfer is started while the OTA waits, so the wait is bounded by the
+ * transfers already running, at most one per file transfer worker.
+ *
+ * @param[in] edgehog_dev Edgehog device handle.
+ */
+static void take_ota_ft_sem(edgehog_device_handle_t edgehog_dev);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STAGED
+/**
+ * @brief Verify the images staged in the secondary slots before a reboot.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @return EDGEHOG_RESULT_OK if the staged images are intact, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t restore_staged_image(ota_thread_data_t *thread_data);
+
+/**
+ * @brief Wait for the activation of the staged image.
+ *
+ * @details The image is activated by the application through an EDGEHOG_OTA_ACTIVATE_EVENT on the
+ * OTA zbus channel, or at the start of the daily maintenance window. File transfers are allowed
+ * while waiting.
+ *
+ * @param[in] edgehog_dev Edgehog device handle.
+ * @return EDGEHOG_RESULT_OK when the image has been activated, EDGEHOG_RESULT_OTA_CANCELED if the
+ * OTA update has been canceled in the meantime.
+ */
+static edgehog_result_t wait_for_activation(edgehog_device_handle_t edgehog_dev);
+
+/**
+ * @brief Check if the current time is in the daily maintenance window.
+ *
+ * @details The window is in minutes of the UTC day, computed from system_time_current_ms. Without
+ * a synchronized realtime clock the time counts from the epoch at boot, so the uptime is taken as
+ * the time of day.
+ *
+ * @return true if the staged image can be activated now, false otherwise.
+ */
+static bool is_in_maintenance_window(void);
+#endif
+
+/**
+ * @brief Request MCUboot to boot the downloaded images at the next reboot.
+ *
+ * @details The headers of all the images are checked before any request is made, so that a
+ * missing image doesn't leave the others pending.
+ *
+ * @param[in] images Mask of the images to boot.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+static int request_images_boot(uint8_t images);
+
+/**
+ * @brief Request MCUboot to boot a downloaded image at the next reboot.
+ *
+ * @details The request depends on the MCUboot mode: a swap for test, a permanent overwrite, or
+ * nothing at all when MCUboot boots the newest image of the two slots.
+ *
+ * @param[in] image_index Index of the MCUboot image.
+ * @param[in] upload_area_id Flash area holding the downloaded image.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+static int request_image_boot(uint8_t image_index, uint8_t upload_area_id);
+
+#ifndef OTA_SWAPLESS
+/**
+ * @brief Check if MCUboot swapped all the images deployed before the reboot.
+ *
+ * @param[in] images Mask of the deployed images.
+ * @return true if every image has been swapped and is waiting for its confirmation.
+ */
+static bool are_images_swapped(uint8_t images);
+#endif
+
+/**
+ * @brief Confirm the images deployed before the reboot, so that MCUboot doesn't revert them.
+ *
+ * @param[in] images Mask of the deployed images.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+static int confirm_images(uint8_t images);
+
+#ifdef OTA_SWAPLESS
+/**
+ * @brief Store the version and the hash of the image about to be booted.
+ *
+ * @param[in] upload_area_id Flash area holding the downloaded image.
+ */
+static void save_deploy_record(uint8_t upload_area_id);
+
+/**
+ * @brief Check if the running image is the one deployed before the reboot.
+ *
+ * @param[in] ota_settings OTA settings holding the deploy record.
+ * @return true if MCUboot booted the deployed image, false otherwise.
+ */
+static bool is_deployed_image_running(const ota_settings_t *ota_settings);
+#endif
+
 /**
  * @brief Callback used when download data is received from the server.
  */
 static edgehog_result_t http_download_payload_cbk(
     edgehog_http_response_chunk_t *response_chunk, void *user_data);
+/**
+ * @brief Detect the encoding of the image and write a downloaded chunk to the secondary slot.
+ *
+ * @details Runs in the pipeline thread when CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE is enabled.
+ *
+ * @param[in] response_chunk Chunk of the HTTP response.
+ * @param[inout] user_data Thread data of the OTA.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t process_image_chunk(
+    edgehog_http_response_chunk_t *response_chunk, void *user_data);
+/**
+ * @brief Publish the download progress when it crosses a rounding step.
+ *
+ * @param[in] edgehog_device Handle to the Edgehog device instance.
+ */
+static void report_download_progress(edgehog_device_handle_t edgehog_device);
+/**
+ * @brief Compute the download progress from the counters of the image writer.
+ *
+ * @details Runs where the chunks are written, in the pipeline thread when
+ * CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE is enabled.
+ *
+ * @param[in] thread_data OTA thread data.
+ * @return Percentage rounded down to the rounding step, negative if the total size is unknown.
+ */
+static int get_download_perc(const ota_thread_data_t *thread_data);
 /**
  * @brief Publish an OTA update event to Astarte.
  *
@@ -172,6 +376,66 @@ static edgehog_result_t edgehog_ota_event_update(
 static edgehog_result_t perform_ota(edgehog_device_handle_t edgehog_device);
 static edgehog_result_t perform_ota_attempt(edgehog_device_handle_t edgehog_device);
 
+/**
+ * @brief Check if a failed download attempt can succeed when retried.
+ *
+ * @details Client errors other than timeouts and rate limiting are returned again by the server
+ * for the same request, retrying them only delays the failure of the update.
+ *
+ * @param[in] thread_data Data of the OTA thread.
+ * @return True if the download should be attempted again, false otherwise.
+ */
+static bool is_ota_attempt_retryable(const ota_thread_data_t *thread_data);
+
+/**
+ * @brief Compute the delay before the next download attempt.
+ *
+ * @details Exponential backoff with equal jitter, capped to
+ * CONFIG_EDGEHOG_DEVICE_OTA_RETRY_MAX_DELAY_MS. A Retry-After sent with a 429 or 503 response
+ * replaces the backoff, the jitter is still added to spread the devices paced together.
+ *
+ * @param[in] thread_data Data of the OTA thread.
+ * @param[in] attempt Index of the failed attempt, starting from zero.
+ * @return Delay in milliseconds.
+ */
+static uint32_t get_ota_retry_delay_ms(const ota_thread_data_t *thread_data, uint8_t attempt);
+
+/**
+ * @brief Wait before the next download attempt, returning early if the OTA is canceled.
+ *
+ * @param[in] thread_data Data of the OTA thread.
+ * @param[in] delay_ms Delay in milliseconds.
+ * @return False if the OTA has been canceled during the wait, true otherwise.
+ */
+static bool wait_ota_retry(ota_thread_data_t *thread_data, uint32_t delay_ms);
+
+/**
+ * @brief Log the timing of the OTA update.
+ *
+ * @param[in] thread_data OTA thread data.
+ */
+static void log_ota_stats(const ota_thread_data_t *thread_data);
+
+/**
+ * @brief Write a chunk of an uncompressed image download to the secondary slot.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] response_chunk Chunk of the HTTP response.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t write_image_chunk(
+    ota_thread_data_t *thread_data, edgehog_http_response_chunk_t *response_chunk);
+
+/**
+ * @brief Write a downloaded chunk to the secondary slot, decoding it if the image is encoded.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] response_chunk Chunk of the HTTP response.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t write_response_chunk(
+    ota_thread_data_t *thread_data, edgehog_http_response_chunk_t *response_chunk);
+
 /**
  * @brief Handle an OTA cancel operation event.
  *
@@ -195,6 +459,69 @@ static edgehog_result_t edgehog_ota_event_cancel(
 static int ota_settings_loader(
     const char *key, size_t len, settings_read_cb read_cb, void *cb_arg, void *param);
 
+/**
+ * @brief Compute the FNV-1a hash of a download URL.
+ *
+ * @param[in] url The URL to hash.
+ * @return The 32 bits hash of the URL.
+ */
+static uint32_t hash_url(const char *url);
+
+/**
+ * @brief Check if the checkpoint stored in the OTA settings matches an OTA request.
+ *
+ * @param[in] ota_settings OTA settings loaded from Edgehog settings.
+ * @param[in] uuid UUID of the OTA request.
+ * @param[in] url Download URL of the OTA request.
+ * @return true if the checkpoint can be used to resume the request, false otherwise.
+ */
+static bool is_checkpoint_valid(
+    const ota_settings_t *ota_settings, const char *uuid, const char *url);
+
+/**
+ * @brief Restore the download progress from the checkpoint of the current OTA request.
+ *
+ * @note The flash image context should be already initialized.
+ *
+ * @param[inout] thread_data OTA thread data to update with the restored progress.
+ * @return true if the download can resume from the checkpoint, false otherwise.
+ */
+static bool restore_checkpoint(ota_thread_data_t *thread_data);
+
+/**
+ * @brief Save a download checkpoint when enough data has been persisted since the last one.
+ *
+ * @param[inout] thread_data OTA thread data of the running download.
+ */
+static void update_checkpoint(ota_thread_data_t *thread_data);
+
+/**
+ * @brief Delete the download checkpoint and the URL of the OTA request from Edgehog settings.
+ */
+static void clear_checkpoint(void);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT
+/**
+ * @brief Check if the secondary slot already holds the image of the OTA request.
+ *
+ * @details The image is reused when it has been downloaded from the same URL, the server still
+ * returns the same ETag for it, and the content of the slot matches its hash TLV.
+ *
+ * @note The flash image context should be already initialized.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @return true if the download can be skipped, false otherwise.
+ */
+static bool is_image_in_secondary_slot(ota_thread_data_t *thread_data);
+
+/**
+ * @brief Store the identity of the image just written to the secondary slot.
+ *
+ * @param[in] thread_data OTA thread data.
+ */
+static void save_slot_record(const ota_thread_data_t *thread_data);
+#endif
+
 /************************************************
  *         Global functions definitions         *
  ***********************************************/
@@ -206,6 +533,13 @@ void edgehog_ota_init(edgehog_device_handle_t edgehog_dev)
         return;
     }
 
+    // The OTA state is loaded on each connection, nothing to do if an update is already running
+    if (atomic_test_bit(
+            &edgehog_dev->ota_thread.ota_thread_data.ota_run_state, OTA_STATE_RUN_BIT)) {
+        EDGEHOG_LOG_DBG("OTA update in progress, skipping OTA init");
+        return;
+    }
+
     memset(&edgehog_dev->ota_thread, 0, sizeof(ota_thread_t));
 
     // Step 1 check if an UUID is present in Edgehog settings. If not there is no need to continue
@@ -215,6 +549,7 @@ void edgehog_ota_init(edgehog_device_handle_t edgehog_dev)
     edgehog_result_t res = edgehog_settings_load("ota", ota_settings_loader, &ota_settings);
     if (res != EDGEHOG_RESULT_OK) {
         EDGEHOG_LOG_ERR("Edgehog Settings load failed");
+        free(ota_settings.url);
         return;
     }
 
@@ -223,6 +558,46 @@ void edgehog_ota_init(edgehog_device_handle_t edgehog_dev)
         goto end;
     }
 
+    // Step 2 check if the download has been interrupted by a reboot, and resume it if possible.
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+    if ((ota_settings.ota_state == OTA_STATE_IN_PROGRESS)
+        && is_checkpoint_valid(&ota_settings, ota_settings.uuid, ota_settings.url)) {
+        EDGEHOG_LOG_INF("Resuming interrupted OTA download from byte %u",
+            ota_settings.checkpoint.bytes_written);
+        ota_request_t ota_request = {
+            .download_url = ota_settings.url,
+            .uuid = ota_settings.uuid,
+        };
+        res = edgehog_ota_event_update(edgehog_dev, &ota_request);
+        free(ota_settings.url);
+        if (res == EDGEHOG_RESULT_OK) {
+            return;
+        }
+        EDGEHOG_LOG_ERR("Unable to resume the OTA update: %d", res);
+        ota_settings.url = NULL;
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STAGED
+    // A staged image keeps waiting for its activation across reboots
+    if (ota_settings.ota_state == OTA_STATE_STAGED) {
+        EDGEHOG_LOG_INF("Restoring the staged OTA image");
+        ota_request_t ota_request = {
+            .download_url = ota_settings.url ? ota_settings.url : "",
+            .uuid = ota_settings.uuid,
+            .staged = true,
+        };
+        res = edgehog_ota_event_update(edgehog_dev, &ota_request);
+        free(ota_settings.url);
+        if (res == EDGEHOG_RESULT_OK) {
+            return;
+        }
+        EDGEHOG_LOG_ERR("Unable to restore the staged OTA update: %d", res);
+        ota_settings.url = NULL;
+    }
+#endif
+
     // Step 3 check if the OTA update state is reboot. If not notify astarte of the error.
 
     if (ota_settings.ota_state != OTA_STATE_REBOOT) {
@@ -232,23 +607,30 @@ void edgehog_ota_init(edgehog_device_handle_t edgehog_dev)
         goto end;
     }
 
-    int swap_type = mcuboot_swap_type();
-    if (swap_type != BOOT_SWAP_TYPE_NONE) {
-        EDGEHOG_LOG_ERR(
-            "Unable to swap the contents to slot 1. Swap type:%s", swap_type_str(swap_type));
+    uint8_t images = BIT(0);
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    if (ota_settings.images != 0) {
+        images = ota_settings.images;
+    }
+#endif
+
+#ifdef OTA_SWAPLESS
+    if ((images & BIT(0)) && !is_deployed_image_running(&ota_settings)) {
+        EDGEHOG_LOG_ERR("MCUboot didn't boot the deployed OTA image");
         pub_ota_event(edgehog_dev->astarte_device, ota_settings.uuid, OTA_EVENT_FAILURE, 0,
             EDGEHOG_RESULT_OTA_SWAP_FAIL, "");
         goto end;
     }
-
-    if (boot_is_img_confirmed()) {
-        EDGEHOG_LOG_ERR("Boot Image is alredy confirmed, it is not an OTA update process");
+#else
+    // The images deployed together are either all confirmed or all left to be reverted
+    if (!are_images_swapped(images)) {
         pub_ota_event(edgehog_dev->astarte_device, ota_settings.uuid, OTA_EVENT_FAILURE, 0,
             EDGEHOG_RESULT_OTA_SWAP_FAIL, "");
         goto end;
     }
+#endif
 
-    int ret = boot_write_img_confirmed();
+    int ret = confirm_images(images);
     if (ret < 0) {
         EDGEHOG_LOG_ERR("Couldn't confirm this image: %d", ret);
         pub_ota_event(edgehog_dev->astarte_device, ota_settings.uuid, OTA_EVENT_FAILURE, 0,
@@ -262,6 +644,14 @@ void edgehog_ota_init(edgehog_device_handle_t edgehog_dev)
         EDGEHOG_RESULT_OK, "");
 
 end:
+    free(ota_settings.url);
+    clear_checkpoint();
+#ifdef OTA_SWAPLESS
+    edgehog_settings_delete(OTA_KEY, OTA_DEPLOY_KEY);
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    edgehog_settings_delete(OTA_KEY, OTA_IMAGES_KEY);
+#endif
     edgehog_settings_delete(OTA_KEY, OTA_REQUEST_ID_KEY);
     ota_settings.ota_state = OTA_STATE_IDLE;
     edgehog_settings_save(
@@ -368,6 +758,9 @@ static edgehog_result_t edgehog_ota_event_update(
         goto fail;
     }
     strncpy(ota_thread_data->ota_request.download_url, ota_request->download_url, ota_url_len + 1);
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STAGED
+    ota_thread_data->ota_request.staged = ota_request->staged;
+#endif
 
     if (atomic_test_and_set_bit(&ota_thread_data->ota_run_state, OTA_STATE_RUN_BIT)) {
         EDGEHOG_LOG_ERR("Unable to set OTA RUN BIT");
@@ -379,7 +772,7 @@ static edgehog_result_t edgehog_ota_event_update(
     memset(thread_handle, 0, sizeof(struct k_thread));
 
     k_tid_t thread_id = k_thread_create(thread_handle, ota_thread_stack, THREAD_STACK_SIZE,
-        ota_thread_entry_point, edgehog_device, NULL, NULL, K_HIGHEST_THREAD_PRIO, 0, K_NO_WAIT);
+        ota_thread_entry_point, edgehog_device, NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
 
     if (!thread_id) {
         EDGEHOG_LOG_ERR("OTA update thread creation failed.");
@@ -420,7 +813,7 @@ static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3)
     const char *req_uuid = ota_thread_data->ota_request.uuid;
 
     // before performing the OTA update, check if there is a File Transfer ongoing operation
-    k_sem_take(&edgehog_dev->sync_ota_ft_sem, K_FOREVER);
+    take_ota_ft_sem(edgehog_dev);
 
     // Step 1 acknowledge the valid update request and notify the start of the download
     // operation.
@@ -445,9 +838,23 @@ static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3)
 
     EDGEHOG_LOG_INF("DOWNLOAD_AND_DEPLOY");
     uint8_t ota_state = OTA_STATE_IN_PROGRESS;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STAGED
+    if (ota_thread_data->ota_request.staged) {
+        edgehog_result = restore_staged_image(ota_thread_data);
+    } else {
+        edgehog_settings_save(OTA_KEY, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
+        edgehog_result = perform_ota(edgehog_dev);
+        clear_checkpoint();
+    }
+    if (edgehog_result == EDGEHOG_RESULT_OK) {
+        edgehog_result = wait_for_activation(edgehog_dev);
+    }
+#else
     edgehog_settings_save(OTA_KEY, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
 
     edgehog_result = perform_ota(edgehog_dev);
+    clear_checkpoint();
+#endif
     if (edgehog_result == EDGEHOG_RESULT_OK) {
         pub_ota_event(
             edgehog_dev->astarte_device, req_uuid, OTA_EVENT_DEPLOYING, 0, EDGEHOG_RESULT_OK, "");
@@ -455,21 +862,12 @@ static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3)
         ota_state = OTA_STATE_REBOOT;
         edgehog_settings_save(OTA_KEY, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
 
-        struct mcuboot_img_header hdr;
-        memset(&hdr, 0, sizeof(struct mcuboot_img_header));
-
-        int err = boot_read_bank_header(FLASH_AREA_IMAGE_SECONDARY, &hdr, sizeof(hdr));
-        if (err) {
-            EDGEHOG_LOG_ERR(
-                "Failed to read sec area (%u) header: %d", FLASH_AREA_IMAGE_SECONDARY, err);
-            pub_ota_event(edgehog_dev->astarte_device, req_uuid, OTA_EVENT_FAILURE, 0,
-                EDGEHOG_RESULT_OTA_INTERNAL_ERROR, "");
-            goto selfdestruct;
-        }
-
-        err = boot_request_upgrade(BOOT_UPGRADE_TEST);
+        uint8_t images = ota_flash_get_images(ota_thread_data);
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+        edgehog_settings_save(OTA_KEY, OTA_IMAGES_KEY, &images, sizeof(images));
+#endif
+        int err = request_images_boot(images);
         if (err) {
-            EDGEHOG_LOG_ERR("Failed to mark the image in slot 1 as pending %d", err);
             pub_ota_event(edgehog_dev->astarte_device, req_uuid, OTA_EVENT_FAILURE, 0,
                 EDGEHOG_RESULT_OTA_INTERNAL_ERROR, "");
             goto selfdestruct;
@@ -499,6 +897,9 @@ selfdestruct:
 
     free(ota_thread_data->ota_request.uuid);
     free(ota_thread_data->ota_request.download_url);
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    edgehog_settings_delete(OTA_KEY, OTA_IMAGES_KEY);
+#endif
     edgehog_settings_delete(OTA_KEY, OTA_REQUEST_ID_KEY);
     ota_state = OTA_STATE_IDLE;
     edgehog_settings_save(OTA_KEY, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
@@ -526,65 +927,457 @@ static void wait_for_reboot(void)
 #endif
 }
 
-static edgehog_result_t perform_ota(edgehog_device_handle_t edgehog_device)
+static void take_ota_ft_sem(edgehog_device_handle_t edgehog_dev)
 {
-    edgehog_result_t edgehog_result = EDGEHOG_RESULT_OK;
+    atomic_inc(&edgehog_dev->ota_waiting);
+    k_sem_take(&edgehog_dev->sync_ota_ft_sem, K_FOREVER);
+    atomic_dec(&edgehog_dev->ota_waiting);
+}
 
-    astarte_device_handle_t astarte_device = edgehog_device->astarte_device;
-    ota_thread_data_t *thread_data = &edgehog_device->ota_thread.ota_thread_data;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STAGED
+static edgehog_result_t restore_staged_image(ota_thread_data_t *thread_data)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    ota_settings_t ota_settings = { 0 };
+    edgehog_settings_load(OTA_KEY, ota_settings_loader, &ota_settings);
+    free(ota_settings.url);
+    thread_data->bundle_images = ota_settings.images;
+#endif
+    uint8_t images = ota_flash_get_images(thread_data);
 
-    int err = boot_erase_img_bank(FLASH_AREA_IMAGE_SECONDARY);
-    if (err) {
-        EDGEHOG_LOG_ERR("Failed to erase second slot: %d", err);
-        return EDGEHOG_RESULT_OTA_ERASE_SECOND_SLOT_ERROR;
-    }
+    uint8_t images_count = ota_flash_get_images_count();
+    edgehog_result_t edgehog_result = EDGEHOG_RESULT_OK;
+    for (uint8_t i = 0; (i < images_count) && (edgehog_result == EDGEHOG_RESULT_OK); i++) {
+        if (!(images & BIT(i))) {
+            continue;
+        }
+        int err = flash_img_init_id(&thread_data->flash_ctx, ota_flash_get_image_upload_area_id(i));
+        if (err) {
+            EDGEHOG_LOG_ERR("Unable to init flash area: %d", err);
+            return EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+        }
 
-    err = flash_img_init(&thread_data->flash_ctx);
-    if (err) {
-        EDGEHOG_LOG_ERR("Unable to init flash area: %d", err);
-        return EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+        ota_image_header_t header = { 0 };
+        edgehog_result = ota_image_read_header(thread_data->flash_ctx.flash_area->fa_id, &header);
+        if (edgehog_result == EDGEHOG_RESULT_OK) {
+            edgehog_result = ota_flash_hash_slot(thread_data, ota_image_hashed_size(&header));
+        }
+        if (edgehog_result == EDGEHOG_RESULT_OK) {
+            edgehog_result = ota_flash_verify_hash(thread_data);
+        }
+        psa_hash_abort(&thread_data->hash_operation);
     }
+    return edgehog_result;
+}
 
-    // Step 1 set the request ID to the received uuid in Settings
-    edgehog_result = edgehog_settings_save(
-        OTA_KEY, OTA_REQUEST_ID_KEY, thread_data->ota_request.uuid, UUID_STR_LEN);
-    if (edgehog_result != EDGEHOG_RESULT_OK) {
-        EDGEHOG_LOG_ERR("Unable to write OTA req_uuid into Edgehog Settings, OTA canceled");
-        return edgehog_result;
-    }
-    // Step 2 attempt OTA operation for MAX_OTA_RETRY tries
+static edgehog_result_t wait_for_activation(edgehog_device_handle_t edgehog_dev)
+{
+    ota_thread_data_t *thread_data = &edgehog_dev->ota_thread.ota_thread_data;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    // The staged images are verified again if the device reboots before their activation
+    uint8_t images = ota_flash_get_images(thread_data);
+    edgehog_settings_save(OTA_KEY, OTA_IMAGES_KEY, &images, sizeof(images));
+#endif
+    uint8_t ota_state = OTA_STATE_STAGED;
+    edgehog_settings_save(OTA_KEY, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
+    EDGEHOG_LOG_INF("OTA image staged, waiting for its activation");
 
-    for (uint8_t update_attempts = 0; update_attempts < MAX_OTA_RETRY; update_attempts++) {
-        pub_ota_event(astarte_device, thread_data->ota_request.uuid, OTA_EVENT_DOWNLOADING, 0,
-            EDGEHOG_RESULT_OK, "");
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT
+    edgehog_ota_chan_event_t ota_chan_event = { .event = EDGEHOG_OTA_STAGED_EVENT };
+    zbus_chan_pub(&edgehog_ota_chan, &ota_chan_event, K_SECONDS(1));
+#endif
 
-        edgehog_result = perform_ota_attempt(edgehog_device);
+    // The staged image doesn't need the flash or the network, file transfers can run meanwhile
+    k_sem_give(&edgehog_dev->sync_ota_ft_sem);
 
-        if (edgehog_result == EDGEHOG_RESULT_OK || edgehog_result == EDGEHOG_RESULT_OTA_CANCELED) {
+    edgehog_result_t edgehog_result = EDGEHOG_RESULT_OK;
+    while (!is_in_maintenance_window()) {
+        if (!atomic_test_bit(&thread_data->ota_run_state, OTA_STATE_RUN_BIT)) {
+            EDGEHOG_LOG_INF("Staged OTA update canceled");
+            edgehog_result = EDGEHOG_RESULT_OTA_CANCELED;
             break;
         }
-
-        k_msleep(update_attempts * OTA_ATTEMPS_DELAY_MS);
-        pub_ota_event(
-            astarte_device, thread_data->ota_request.uuid, OTA_EVENT_ERROR, 0, edgehog_result, "");
-        EDGEHOG_LOG_WRN("! OTA FAILED, ATTEMPT #%d !", update_attempts);
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT
+        const struct zbus_channel *chan = NULL;
+        edgehog_ota_chan_event_t ota = { 0 };
+        if ((zbus_sub_wait(&edgehog_ota_internal_subscriber, &chan, K_SECONDS(1)) == 0)
+            && (&edgehog_ota_chan == chan) && (zbus_chan_read(chan, &ota, K_SECONDS(1)) == 0)
+            && (ota.event == EDGEHOG_OTA_ACTIVATE_EVENT)) {
+            EDGEHOG_LOG_INF("Staged OTA image activation received");
+            break;
+        }
+#else
+        k_sleep(K_SECONDS(1));
+#endif
     }
 
+    take_ota_ft_sem(edgehog_dev);
     return edgehog_result;
 }
 
-static edgehog_result_t perform_ota_attempt(edgehog_device_handle_t edgehog_device)
+static bool is_in_maintenance_window(void)
 {
-    ota_thread_data_t *thread_data = &edgehog_device->ota_thread.ota_thread_data;
-
-    const char *header_fields[] = { 0 };
+#if CONFIG_EDGEHOG_DEVICE_OTA_STAGED_WINDOW_START >= 0
+    int64_t timestamp_ms = 0;
+    if (system_time_current_ms(&timestamp_ms) != EDGEHOG_RESULT_OK) {
+        return false;
+    }
+    int64_t minute_of_day = (timestamp_ms / MSEC_PER_SEC / SEC_PER_MIN) % MINUTES_PER_DAY;
+    int64_t window_minute = (minute_of_day - CONFIG_EDGEHOG_DEVICE_OTA_STAGED_WINDOW_START
+                                + MINUTES_PER_DAY)
+        % MINUTES_PER_DAY;
+    return window_minute < CONFIG_EDGEHOG_DEVICE_OTA_STAGED_WINDOW_LENGTH;
+#else
+    return false;
+#endif
+}
+#endif
 
-    edgehog_http_get_data_t http_get_data = { .url = thread_data->ota_request.download_url,
+static int request_images_boot(uint8_t images)
+{
+    for (uint8_t i = 0; i < ota_flash_get_images_count(); i++) {
+        if (!(images & BIT(i))) {
+            continue;
+        }
+        struct mcuboot_img_header hdr;
+        memset(&hdr, 0, sizeof(struct mcuboot_img_header));
+
+        uint8_t upload_area_id = ota_flash_get_image_upload_area_id(i);
+        int err = boot_read_bank_header(upload_area_id, &hdr, sizeof(hdr));
+        if (err) {
+            EDGEHOG_LOG_ERR("Failed to read sec area (%u) header: %d", upload_area_id, err);
+            return err;
+        }
+    }
+
+#ifdef OTA_SWAPLESS
+    if (images & BIT(0)) {
+        save_deploy_record(ota_flash_get_upload_area_id());
+    }
+#endif
+
+    for (uint8_t i = 0; i < ota_flash_get_images_count(); i++) {
+        if (!(images & BIT(i))) {
+            continue;
+        }
+        uint8_t upload_area_id = ota_flash_get_image_upload_area_id(i);
+        int err = request_image_boot(i, upload_area_id);
+        if (err) {
+            EDGEHOG_LOG_ERR(
+                "Failed to mark the image in area %u as pending %d", upload_area_id, err);
+            return err;
+        }
+    }
+    return 0;
+}
+
+static int request_image_boot(uint8_t image_index, uint8_t upload_area_id)
+{
+#if defined(CONFIG_MCUBOOT_BOOTLOADER_MODE_OVERWRITE_ONLY)
+    ARG_UNUSED(upload_area_id);
+    // The running image is overwritten and can't be reverted, a test swap would be meaningless
+    return boot_request_upgrade_multi(image_index, BOOT_UPGRADE_PERMANENT);
+#elif defined(CONFIG_MCUBOOT_BOOTLOADER_MODE_DIRECT_XIP_WITH_REVERT)
+    ARG_UNUSED(image_index);
+    // The image is booted in place and reverted if it doesn't confirm itself
+    const struct flash_area *flash_area = NULL;
+    int err = flash_area_open(upload_area_id, &flash_area);
+    if (err) {
+        return err;
+    }
+    err = boot_set_next(flash_area, false, false);
+    flash_area_close(flash_area);
+    return err;
+#elif defined(OTA_SLOT_SELECTION)
+    ARG_UNUSED(image_index);
+    ARG_UNUSED(upload_area_id);
+    // MCUboot boots the slot holding the newest image, nothing to request
+    return 0;
+#else
+    ARG_UNUSED(upload_area_id);
+    return boot_request_upgrade_multi(image_index, BOOT_UPGRADE_TEST);
+#endif
+}
+
+#ifndef OTA_SWAPLESS
+static bool are_images_swapped(uint8_t images)
+{
+    for (uint8_t i = 0; i < ota_flash_get_images_count(); i++) {
+        if (!(images & BIT(i))) {
+            continue;
+        }
+        int swap_type = mcuboot_swap_type_multi(i);
+        if (swap_type != BOOT_SWAP_TYPE_NONE) {
+            EDGEHOG_LOG_ERR("Unable to swap the contents of image %u. Swap type:%s", i,
+                swap_type_str(swap_type));
+            return false;
+        }
+    }
+
+    if ((images & BIT(0)) && boot_is_img_confirmed()) {
+        EDGEHOG_LOG_ERR("Boot Image is alredy confirmed, it is not an OTA update process");
+        return false;
+    }
+    return true;
+}
+#endif
+
+static int confirm_images(uint8_t images)
+{
+    int ret = 0;
+    // Images overwritten or booted without revert support are confirmed by MCUboot
+    if ((images & BIT(0)) && !boot_is_img_confirmed()) {
+        ret = boot_write_img_confirmed();
+    }
+    for (uint8_t i = 1; (i < ota_flash_get_images_count()) && (ret >= 0); i++) {
+        if (images & BIT(i)) {
+            ret = boot_write_img_confirmed_multi(i);
+        }
+    }
+    return ret;
+}
+
+#ifdef OTA_SWAPLESS
+static void save_deploy_record(uint8_t upload_area_id)
+{
+    ota_deploy_record_t record = { 0 };
+    ota_image_header_t header = { 0 };
+    if ((ota_image_read_header(upload_area_id, &header) != EDGEHOG_RESULT_OK)
+        || (ota_image_read_hash(upload_area_id, &header, record.image_hash, &record.hash_found)
+            != EDGEHOG_RESULT_OK)) {
+        EDGEHOG_LOG_WRN("Unable to read the deployed OTA image, only its version will be checked");
+        record.hash_found = false;
+    }
+    record.version = header.version;
+
+    if (edgehog_settings_save(OTA_KEY, OTA_DEPLOY_KEY, &record, sizeof(record))
+        != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_WRN("Unable to store the deployed OTA image");
+    }
+}
+
+static bool is_deployed_image_running(const ota_settings_t *ota_settings)
+{
+    if (!ota_settings->deploy_record_found) {
+        EDGEHOG_LOG_ERR("No deployed OTA image found in Edgehog settings");
+        return false;
+    }
+
+    const ota_deploy_record_t *record = &ota_settings->deploy_record;
+    uint8_t running_area_id = ota_flash_get_running_area_id();
+    ota_image_header_t header = { 0 };
+    if ((ota_image_read_header(running_area_id, &header) != EDGEHOG_RESULT_OK)
+        || (ota_image_compare_versions(&header.version, &record->version) != 0)) {
+        return false;
+    }
+    if (!record->hash_found) {
+        return true;
+    }
+
+    uint8_t running_hash[OTA_IMAGE_HASH_SIZE] = { 0 };
+    bool found = false;
+    return (ota_image_read_hash(running_area_id, &header, running_hash, &found)
+               == EDGEHOG_RESULT_OK)
+        && found && (memcmp(running_hash, record->image_hash, sizeof(running_hash)) == 0);
+}
+#endif
+
+static edgehog_result_t perform_ota(edgehog_device_handle_t edgehog_device)
+{
+    edgehog_result_t edgehog_result = EDGEHOG_RESULT_OK;
+
+    astarte_device_handle_t astarte_device = edgehog_device->astarte_device;
+    ota_thread_data_t *thread_data = &edgehog_device->ota_thread.ota_thread_data;
+
+    int err = flash_img_init_id(&thread_data->flash_ctx, ota_flash_get_upload_area_id());
+    if (err) {
+        EDGEHOG_LOG_ERR("Unable to init flash area: %d", err);
+        return EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_SKIP_IDENTICAL_SECTORS
+    thread_data->sectors_written = 0;
+    thread_data->sectors_skipped = 0;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STATS
+    memset(&thread_data->stats, 0, sizeof(thread_data->stats));
+    thread_data->stats.start_ms = k_uptime_get();
+    thread_data->stats.ttfb_ms = -1;
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT
+    // A retried OTA request can find its image already in the secondary slot
+    bool image_present = is_image_in_secondary_slot(thread_data);
+#else
+    bool image_present = false;
+#endif
+
+    if (!image_present && !restore_checkpoint(thread_data)) {
+        edgehog_result = ota_flash_erase_slot(thread_data);
+        if (edgehog_result != EDGEHOG_RESULT_OK) {
+            return edgehog_result;
+        }
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+        edgehog_result = ota_flash_start_hash(thread_data);
+        if (edgehog_result != EDGEHOG_RESULT_OK) {
+            return edgehog_result;
+        }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+        // Store the URL to be able to resume the download after a reboot
+        edgehog_result = edgehog_settings_save(OTA_KEY, OTA_URL_KEY,
+            thread_data->ota_request.download_url, strlen(thread_data->ota_request.download_url));
+        if (edgehog_result != EDGEHOG_RESULT_OK) {
+            EDGEHOG_LOG_WRN("Unable to store the OTA URL, the download won't survive a reboot");
+        }
+#endif
+    }
+
+    // Step 1 set the request ID to the received uuid in Settings
+    edgehog_result = edgehog_settings_save(
+        OTA_KEY, OTA_REQUEST_ID_KEY, thread_data->ota_request.uuid, UUID_STR_LEN);
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_ERR("Unable to write OTA req_uuid into Edgehog Settings, OTA canceled");
+        return edgehog_result;
+    }
+
+    if (image_present) {
+        EDGEHOG_LOG_INF("OTA image already in the secondary slot, skipping the download");
+        return EDGEHOG_RESULT_OK;
+    }
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE
+    edgehog_result = ota_pipeline_start(process_image_chunk, thread_data);
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_ERR("Unable to start the OTA pipeline");
+        return edgehog_result;
+    }
+#endif
+
+    // Step 2 attempt OTA operation for MAX_OTA_RETRY tries
+
+    for (uint8_t update_attempts = 0; update_attempts < MAX_OTA_RETRY; update_attempts++) {
+        pub_ota_event(astarte_device, thread_data->ota_request.uuid, OTA_EVENT_DOWNLOADING, 0,
+            EDGEHOG_RESULT_OK, "");
+
+        edgehog_result = perform_ota_attempt(edgehog_device);
+
+        if (edgehog_result == EDGEHOG_RESULT_OK || edgehog_result == EDGEHOG_RESULT_OTA_CANCELED) {
+            break;
+        }
+
+        // Following attempts resume writing the secondary slot, which is not possible if the
+        // written content can't be trusted
+        if ((edgehog_result == EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR)
+            || (edgehog_result == EDGEHOG_RESULT_OTA_INVALID_IMAGE)) {
+            break;
+        }
+
+        if (!is_ota_attempt_retryable(thread_data)) {
+            EDGEHOG_LOG_ERR("OTA download rejected with HTTP status %u", thread_data->http_status);
+            break;
+        }
+
+        pub_ota_event(
+            astarte_device, thread_data->ota_request.uuid, OTA_EVENT_ERROR, 0, edgehog_result, "");
+        EDGEHOG_LOG_WRN("! OTA FAILED, ATTEMPT #%d !", update_attempts);
+
+        if ((update_attempts + 1 < MAX_OTA_RETRY)
+            && !wait_ota_retry(thread_data, get_ota_retry_delay_ms(thread_data, update_attempts))) {
+            edgehog_result = EDGEHOG_RESULT_OTA_CANCELED;
+            break;
+        }
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE
+    ota_pipeline_stop();
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_SKIP_IDENTICAL_SECTORS
+    EDGEHOG_LOG_INF("OTA wrote %u flash sectors, skipped %u already holding the image",
+        thread_data->sectors_written, thread_data->sectors_skipped);
+#endif
+    log_ota_stats(thread_data);
+#ifdef OTA_ENCODING_DETECTION
+    ota_encoding_free(thread_data);
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+    psa_hash_abort(&thread_data->hash_operation);
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT
+    if (edgehog_result == EDGEHOG_RESULT_OK) {
+        save_slot_record(thread_data);
+    }
+#endif
+
+    return edgehog_result;
+}
+
+static edgehog_result_t perform_ota_attempt(edgehog_device_handle_t edgehog_device)
+{
+    ota_thread_data_t *thread_data = &edgehog_device->ota_thread.ota_thread_data;
+
+    const char *header_fields[] = { 0 };
+
+#ifdef OTA_ENCODING_DETECTION
+    if (ota_encoding_is_encoded(thread_data)) {
+        edgehog_result_t restart_result = ota_encoding_restart(thread_data);
+        if (restart_result != EDGEHOG_RESULT_OK) {
+            return restart_result;
+        }
+    }
+#endif
+
+    // Resume the download from the first byte not yet written, a previous attempt could have
+    // been interrupted halfway through the image
+    thread_data->attempt_received_size = 0;
+#ifdef OTA_ENCODING_DETECTION
+    thread_data->probe_size = 0;
+#endif
+    if (thread_data->received_size > 0) {
+        EDGEHOG_LOG_INF("Resuming OTA download from byte %zu", thread_data->received_size);
+    }
+
+    size_t recv_buf_size = 0;
+    uint8_t *recv_buf = ota_flash_get_recv_buf(&recv_buf_size);
+    edgehog_http_get_data_t http_get_data = { .url = thread_data->ota_request.download_url,
         .timeout_ms = OTA_REQ_TIMEOUT_MS,
         .header_fields = header_fields,
+        .range_start = thread_data->received_size,
+        .recv_buf = recv_buf,
+        .recv_buf_size = recv_buf_size,
         .response_cbk = http_download_payload_cbk,
         .user_data = edgehog_device };
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT
+    http_get_data.etag = thread_data->etag;
+    http_get_data.etag_size = sizeof(thread_data->etag);
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STATS
+    thread_data->stats.attempt_start_ms = k_uptime_get();
+    thread_data->stats.first_byte_ms = 0;
+#endif
     edgehog_result_t edgehog_result = edgehog_http_get(&http_get_data);
+    thread_data->http_status = http_get_data.status_code;
+    thread_data->retry_after_s = http_get_data.retry_after_s;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE
+    // Wait for the queued chunks to be written, a flash error takes precedence over the
+    // network error it caused
+    edgehog_result_t pipeline_result = ota_pipeline_drain();
+    if (pipeline_result != EDGEHOG_RESULT_OK) {
+        edgehog_result = pipeline_result;
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STATS
+    // The transfer ends once the last chunk has been written, queued chunks included
+    if (thread_data->stats.first_byte_ms != 0) {
+        thread_data->stats.transfer_ms += k_uptime_get() - thread_data->stats.first_byte_ms;
+        if (thread_data->stats.ttfb_ms < 0) {
+            thread_data->stats.ttfb_ms
+                = thread_data->stats.first_byte_ms - thread_data->stats.attempt_start_ms;
+        }
+    }
+#endif
 
     if (!atomic_test_bit(&thread_data->ota_run_state, OTA_STATE_RUN_BIT)) {
         EDGEHOG_LOG_DBG("OTA canceled");
@@ -595,13 +1388,95 @@ static edgehog_result_t perform_ota_attempt(edgehog_device_handle_t edgehog_devi
         return edgehog_result;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    // Each image of the bundle has been verified once unpacked
+    if (thread_data->bundle) {
+        if (thread_data->bundle_images == 0) {
+            EDGEHOG_LOG_ERR("The OTA bundle holds no image");
+            return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+        }
+        return EDGEHOG_RESULT_OK;
+    }
+#endif
+
     thread_data->download_size = flash_img_bytes_written(&thread_data->flash_ctx);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    // Without a content size in the frame header the image size is known once fully decompressed
+    if (thread_data->compressed && (thread_data->image_size == 0)) {
+        thread_data->image_size = thread_data->received_size;
+    }
+#endif
+
     if (thread_data->download_size <= 0 || thread_data->download_size != thread_data->image_size) {
         return EDGEHOG_RESULT_NETWORK_ERROR;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+    // Catch corrupted images now rather than after MCUboot refuses them on reboot
+    return ota_flash_verify_hash(thread_data);
+#else
     return EDGEHOG_RESULT_OK;
+#endif
+}
+
+static bool is_ota_attempt_retryable(const ota_thread_data_t *thread_data)
+{
+    return edgehog_http_is_retryable_status(thread_data->http_status);
+}
+
+static uint32_t get_ota_retry_delay_ms(const ota_thread_data_t *thread_data, uint8_t attempt)
+{
+    const uint32_t max_delay_ms = CONFIG_EDGEHOG_DEVICE_OTA_RETRY_MAX_DELAY_MS;
+    uint32_t backoff_ms = CONFIG_EDGEHOG_DEVICE_OTA_RETRY_BASE_DELAY_MS;
+    for (uint8_t i = 0; (i < attempt) && (backoff_ms < max_delay_ms); i++) {
+        backoff_ms *= 2;
+    }
+    backoff_ms = MIN(backoff_ms, max_delay_ms);
+    uint32_t jitter_ms = sys_rand32_get() % (backoff_ms / 2 + 1);
+
+    if (((thread_data->http_status == HTTP_429_TOO_MANY_REQUESTS)
+            || (thread_data->http_status == HTTP_503_SERVICE_UNAVAILABLE))
+        && (thread_data->retry_after_s > 0) && (CONFIG_EDGEHOG_DEVICE_OTA_RETRY_AFTER_MAX_S > 0)) {
+        uint32_t retry_after_s
+            = MIN(thread_data->retry_after_s, CONFIG_EDGEHOG_DEVICE_OTA_RETRY_AFTER_MAX_S);
+        EDGEHOG_LOG_INF("OTA server requested to retry after %u s", retry_after_s);
+        return retry_after_s * MSEC_PER_SEC + jitter_ms;
+    }
+
+    // Equal jitter, at least half of the backoff is always waited
+    return backoff_ms - jitter_ms;
+}
+
+static bool wait_ota_retry(ota_thread_data_t *thread_data, uint32_t delay_ms)
+{
+    EDGEHOG_LOG_INF("Next OTA download attempt in %u ms", delay_ms);
+    int64_t end_ms = k_uptime_get() + delay_ms;
+    while (atomic_test_bit(&thread_data->ota_run_state, OTA_STATE_RUN_BIT)) {
+        int64_t remaining_ms = end_ms - k_uptime_get();
+        if (remaining_ms <= 0) {
+            return true;
+        }
+        k_msleep((int32_t) MIN(remaining_ms, OTA_RETRY_CANCEL_POLL_MS));
+    }
+    EDGEHOG_LOG_DBG("OTA canceled");
+    return false;
+}
+
+static void log_ota_stats(const ota_thread_data_t *thread_data)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STATS
+    const ota_stats_t *stats = &thread_data->stats;
+    int64_t throughput_kib_s = (stats->transfer_ms > 0)
+        ? ((int64_t) stats->bytes * MSEC_PER_SEC / stats->transfer_ms / BYTES_PER_KIB)
+        : 0;
+    EDGEHOG_LOG_INF("OTA stats: ttfb %lld ms, %zu bytes in %lld ms, %lld KiB/s, erase %lld ms, "
+                    "total %lld ms",
+        stats->ttfb_ms, stats->bytes, stats->transfer_ms, throughput_kib_s, stats->erase_ms,
+        k_uptime_get() - stats->start_ms);
+#else
+    ARG_UNUSED(thread_data);
+#endif
 }
 
 static edgehog_result_t http_download_payload_cbk(
@@ -623,28 +1498,160 @@ static edgehog_result_t http_download_payload_cbk(
         return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
     }
 
-    int ret = flash_img_buffered_write(&ota_thread_data->flash_ctx,
-        response_chunk->chunk_start_addr, response_chunk->chunk_size, response_chunk->last_chunk);
-    if (ret < 0) {
-        EDGEHOG_LOG_ERR("Flash write error: %d", ret);
-        EDGEHOG_LOG_ERR("Errno: %s\n", strerror(errno));
-        return EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STATS
+    if (ota_thread_data->stats.first_byte_ms == 0) {
+        ota_thread_data->stats.first_byte_ms = k_uptime_get();
+    }
+    ota_thread_data->stats.bytes += response_chunk->chunk_size;
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE
+    // The chunk is written to flash by the pipeline thread while the next one is received
+    edgehog_result_t edgehog_result = ota_pipeline_push(response_chunk);
+#else
+    edgehog_result_t edgehog_result = process_image_chunk(response_chunk, ota_thread_data);
+#endif
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        return edgehog_result;
+    }
+
+    report_download_progress(edgehog_device);
+
+    return EDGEHOG_RESULT_OK;
+}
+
+static edgehog_result_t process_image_chunk(
+    edgehog_http_response_chunk_t *response_chunk, void *user_data)
+{
+    ota_thread_data_t *thread_data = (ota_thread_data_t *) user_data;
+    edgehog_result_t edgehog_result = EDGEHOG_RESULT_OK;
+
+#ifdef OTA_ENCODING_DETECTION
+    if ((thread_data->received_size == 0) && (thread_data->attempt_received_size == 0)) {
+        edgehog_result = ota_encoding_probe(thread_data, response_chunk, write_response_chunk);
+    } else
+#endif
+    {
+        edgehog_result = write_response_chunk(thread_data, response_chunk);
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE
+    // The counters are updated by this thread, the receiving thread only reads the percentage
+    int download_perc = get_download_perc(thread_data);
+    if (download_perc >= 0) {
+        atomic_set(&thread_data->download_perc, download_perc);
+    }
+#endif
+
+    return edgehog_result;
+}
+
+static edgehog_result_t write_response_chunk(
+    ota_thread_data_t *thread_data, edgehog_http_response_chunk_t *response_chunk)
+{
+#ifdef OTA_ENCODING_DETECTION
+    edgehog_result_t edgehog_result = ota_encoding_is_encoded(thread_data)
+        ? ota_encoding_write_chunk(thread_data, response_chunk)
+        : write_image_chunk(thread_data, response_chunk);
+#else
+    edgehog_result_t edgehog_result = write_image_chunk(thread_data, response_chunk);
+#endif
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        // The header rejection surfaces as a write error through the decoders
+        return thread_data->header_rejected ? EDGEHOG_RESULT_OTA_INVALID_IMAGE : edgehog_result;
     }
+    update_checkpoint(thread_data);
+
+    return EDGEHOG_RESULT_OK;
+}
 
-    ota_thread_data->image_size = response_chunk->response_size;
-    ota_thread_data->download_size = flash_img_bytes_written(&ota_thread_data->flash_ctx);
-    int read_perc = (int) (OTA_PROGRESS_PERC * ota_thread_data->download_size
-        / response_chunk->response_size);
-    int read_perc_rounded = read_perc - (read_perc % OTA_PROGRESS_PERC_ROUNDING_STEP);
+static void report_download_progress(edgehog_device_handle_t edgehog_device)
+{
+    ota_thread_data_t *ota_thread_data = &edgehog_device->ota_thread.ota_thread_data;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE
+    // The chunks are written by the pipeline thread, which publishes the resulting progress
+    int read_perc_rounded = (int) atomic_get(&ota_thread_data->download_perc);
+#else
+    int read_perc_rounded = get_download_perc(ota_thread_data);
+#endif
+    if (read_perc_rounded < 0) {
+        return;
+    }
 
     if (read_perc_rounded != ota_thread_data->last_perc_sent) {
         pub_ota_event(edgehog_device->astarte_device, ota_thread_data->ota_request.uuid,
             OTA_EVENT_DOWNLOADING, read_perc_rounded, EDGEHOG_RESULT_OK, "");
-        EDGEHOG_LOG_DBG("Downloading %d%% chunk %d written %d size %d \n", read_perc_rounded,
-            response_chunk->chunk_size, ota_thread_data->download_size,
-            response_chunk->response_size);
+        EDGEHOG_LOG_DBG("Downloading %d%%", read_perc_rounded);
         ota_thread_data->last_perc_sent = read_perc_rounded;
     }
+}
+
+static int get_download_perc(const ota_thread_data_t *thread_data)
+{
+    // Bytes processed and total size on which the download progress is computed
+    size_t progress_size = thread_data->received_size;
+    size_t progress_total = thread_data->image_size;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    // Fall back on the compressed size when the size of the decoded image is unknown
+    if (thread_data->compressed && (thread_data->image_size == 0)) {
+        progress_size = thread_data->attempt_received_size;
+        progress_total = thread_data->compressed_size;
+    }
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    // The images of a bundle are reported as a whole
+    if (thread_data->bundle) {
+        progress_size = thread_data->attempt_received_size;
+        progress_total = thread_data->bundle_size;
+    }
+#endif
+
+    if (progress_total == 0) {
+        return -1;
+    }
+    int read_perc = (int) (OTA_PROGRESS_PERC * progress_size / progress_total);
+    return read_perc - (read_perc % OTA_PROGRESS_PERC_ROUNDING_STEP);
+}
+
+static edgehog_result_t write_image_chunk(
+    ota_thread_data_t *thread_data, edgehog_http_response_chunk_t *response_chunk)
+{
+    size_t image_size = response_chunk->range_offset + response_chunk->response_size;
+    if ((thread_data->received_size > 0) && (thread_data->image_size != image_size)) {
+        EDGEHOG_LOG_ERR("OTA image size changed between attempts: %zu != %zu",
+            thread_data->image_size, image_size);
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+    thread_data->image_size = image_size;
+
+    // When the server ignores the range request the image is sent from the beginning, skip the
+    // part already written to flash
+    uint8_t *write_start = response_chunk->chunk_start_addr;
+    size_t write_size = response_chunk->chunk_size;
+    size_t chunk_offset = response_chunk->range_offset + thread_data->attempt_received_size;
+    thread_data->attempt_received_size += response_chunk->chunk_size;
+    if (chunk_offset < thread_data->received_size) {
+        size_t skip_size = MIN(thread_data->received_size - chunk_offset, write_size);
+        write_start += skip_size;
+        write_size -= skip_size;
+    } else if (chunk_offset > thread_data->received_size) {
+        EDGEHOG_LOG_ERR("Gap in the OTA download, expected offset %zu received %zu",
+            thread_data->received_size, chunk_offset);
+        return EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+    }
+
+    // Flush only when the whole image has been received, flushing a partially received image
+    // would pad the last write block and prevent resuming the download
+    bool flush = response_chunk->last_chunk
+        && ((thread_data->received_size + write_size) == image_size);
+    int ret = ota_flash_write(thread_data, write_start, write_size, flush);
+    if (ret < 0) {
+        EDGEHOG_LOG_ERR("Flash write error: %d", ret);
+        EDGEHOG_LOG_ERR("Errno: %s\n", strerror(errno));
+        return EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+    }
+    thread_data->received_size += write_size;
 
     return EDGEHOG_RESULT_OK;
 }
@@ -671,6 +1678,7 @@ static edgehog_result_t edgehog_ota_event_cancel(
 
     ota_settings_t ota_settings = { 0 };
     res = edgehog_settings_load("ota", ota_settings_loader, &ota_settings);
+    free(ota_settings.url);
     if (res != EDGEHOG_RESULT_OK) {
         EDGEHOG_LOG_ERR("Edgehog Settings load failed");
         pub_ota_event(edgehog_dev->astarte_device, request_uuid, OTA_EVENT_FAILURE, 0,
@@ -824,8 +1832,6 @@ static void pub_ota_event(astarte_device_handle_t astarte_device, const char *re
 static int ota_settings_loader(
     const char *key, size_t len, settings_read_cb read_cb, void *cb_arg, void *param)
 {
-    ARG_UNUSED(len);
-
     const char *next = NULL;
     ota_settings_t *dest = (ota_settings_t *) param;
 
@@ -851,7 +1857,216 @@ static int ota_settings_loader(
 
             return 0;
         }
+
+        if (strncmp(key, OTA_URL_KEY, key_len) == 0) {
+            free(dest->url);
+            dest->url = (char *) calloc(len + 1, sizeof(char));
+            if (!dest->url) {
+                EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
+                return -ENOMEM;
+            }
+            int res = read_cb(cb_arg, dest->url, len);
+            if (res < 0) {
+                EDGEHOG_LOG_ERR("Unable to read ota url from settings: %d", res);
+                free(dest->url);
+                dest->url = NULL;
+                return res;
+            }
+
+            return 0;
+        }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+        if (strncmp(key, OTA_CHECKPOINT_KEY, key_len) == 0) {
+            if (len != sizeof(dest->checkpoint)) {
+                EDGEHOG_LOG_WRN("Ignoring ota checkpoint with unexpected size %zu", len);
+                return 0;
+            }
+            int res = read_cb(cb_arg, &(dest->checkpoint), sizeof(dest->checkpoint));
+            if (res < 0) {
+                EDGEHOG_LOG_ERR("Unable to read ota checkpoint from settings: %d", res);
+                return res;
+            }
+            dest->checkpoint_found = true;
+
+            return 0;
+        }
+#endif
+
+#ifdef OTA_SWAPLESS
+        if (strncmp(key, OTA_DEPLOY_KEY, key_len) == 0) {
+            if (len != sizeof(dest->deploy_record)) {
+                EDGEHOG_LOG_WRN("Ignoring ota deploy record with unexpected size %zu", len);
+                return 0;
+            }
+            int res = read_cb(cb_arg, &(dest->deploy_record), sizeof(dest->deploy_record));
+            if (res < 0) {
+                EDGEHOG_LOG_ERR("Unable to read ota deploy record from settings: %d", res);
+                return res;
+            }
+            dest->deploy_record_found = true;
+
+            return 0;
+        }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+        if (strncmp(key, OTA_IMAGES_KEY, key_len) == 0) {
+            int res = read_cb(cb_arg, &(dest->images), sizeof(dest->images));
+            if (res < 0) {
+                EDGEHOG_LOG_ERR("Unable to read ota images from settings: %d", res);
+                return res;
+            }
+
+            return 0;
+        }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT
+        if (strncmp(key, OTA_SLOT_KEY, key_len) == 0) {
+            if (len != sizeof(dest->slot_record)) {
+                EDGEHOG_LOG_WRN("Ignoring ota slot record with unexpected size %zu", len);
+                return 0;
+            }
+            int res = read_cb(cb_arg, &(dest->slot_record), sizeof(dest->slot_record));
+            if (res < 0) {
+                EDGEHOG_LOG_ERR("Unable to read ota slot record from settings: %d", res);
+                return res;
+            }
+            dest->slot_record_found = true;
+
+            return 0;
+        }
+#endif
     }
 
     return -ENOENT;
 }
+
+static uint32_t hash_url(const char *url)
+{
+    uint32_t hash = FNV1A_32_OFFSET_BASIS;
+    for (const char *c = url; *c != '\0'; c++) {
+        hash ^= (uint8_t) *c;
+        hash *= FNV1A_32_PRIME;
+    }
+    return hash;
+}
+
+static bool is_checkpoint_valid(
+    const ota_settings_t *ota_settings, const char *uuid, const char *url)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+    if (!ota_settings->checkpoint_found || !url) {
+        return false;
+    }
+    return ota_checkpoint_matches(&ota_settings->checkpoint, uuid, hash_url(url));
+#else
+    ARG_UNUSED(ota_settings);
+    ARG_UNUSED(uuid);
+    ARG_UNUSED(url);
+    return false;
+#endif
+}
+
+static bool restore_checkpoint(ota_thread_data_t *thread_data)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+    ota_settings_t ota_settings = { 0 };
+    edgehog_result_t res = edgehog_settings_load(OTA_KEY, ota_settings_loader, &ota_settings);
+    bool valid = (res == EDGEHOG_RESULT_OK)
+        && is_checkpoint_valid(&ota_settings, thread_data->ota_request.uuid,
+            thread_data->ota_request.download_url);
+    free(ota_settings.url);
+    if (!valid) {
+        return false;
+    }
+
+    const ota_checkpoint_t *checkpoint = &ota_settings.checkpoint;
+    size_t resume_size = 0;
+    if (!ota_checkpoint_get_resume_size(
+            checkpoint, thread_data->flash_ctx.flash_area, &resume_size)) {
+        return false;
+    }
+    // Data could have been written after the checkpoint, the rest of the slot is erased, or left
+    // to the progressive erase
+    if (ota_flash_resume(thread_data, resume_size) != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_WRN("Unable to resume writing the secondary slot, discarding the checkpoint");
+        return false;
+    }
+    thread_data->checkpoint_size = resume_size;
+    thread_data->image_size = checkpoint->image_size;
+    EDGEHOG_LOG_INF("OTA download restored from checkpoint at byte %zu", resume_size);
+    return true;
+#else
+    ARG_UNUSED(thread_data);
+    return false;
+#endif
+}
+
+static void update_checkpoint(ota_thread_data_t *thread_data)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+#ifdef OTA_ENCODING_DETECTION
+    // An encoded download can't be resumed, there is no point in saving its progress
+    if (ota_encoding_is_encoded(thread_data)) {
+        return;
+    }
+#endif
+    size_t persisted_size = flash_img_bytes_written(&thread_data->flash_ctx);
+    if (!ota_checkpoint_is_due(thread_data->checkpoint_size, persisted_size,
+            thread_data->image_size)) {
+        return;
+    }
+
+    ota_checkpoint_t checkpoint = { 0 };
+    ota_checkpoint_init(&checkpoint, thread_data->ota_request.uuid,
+        hash_url(thread_data->ota_request.download_url), thread_data->image_size,
+        thread_data->flash_ctx.flash_area, persisted_size);
+
+    edgehog_result_t res
+        = edgehog_settings_save(OTA_KEY, OTA_CHECKPOINT_KEY, &checkpoint, sizeof(checkpoint));
+    if (res != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_WRN("Unable to save the OTA download checkpoint");
+        return;
+    }
+    thread_data->checkpoint_size = persisted_size;
+    EDGEHOG_LOG_DBG("OTA download checkpoint saved at byte %zu", persisted_size);
+#else
+    ARG_UNUSED(thread_data);
+#endif
+}
+
+static void clear_checkpoint(void)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+    edgehog_settings_delete(OTA_KEY, OTA_CHECKPOINT_KEY);
+    edgehog_settings_delete(OTA_KEY, OTA_URL_KEY);
+#endif
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT
+static bool is_image_in_secondary_slot(ota_thread_data_t *thread_data)
+{
+    ota_settings_t ota_settings = { 0 };
+    edgehog_result_t res = edgehog_settings_load(OTA_KEY, ota_settings_loader, &ota_settings);
+    free(ota_settings.url);
+    return (res == EDGEHOG_RESULT_OK) && ota_settings.slot_record_found
+        && ota_slot_reuse_is_image_present(thread_data, &ota_settings.slot_record,
+            hash_url(thread_data->ota_request.download_url));
+}
+
+static void save_slot_record(const ota_thread_data_t *thread_data)
+{
+    ota_slot_record_t record = { 0 };
+    if (!ota_slot_reuse_get_record(
+            thread_data, hash_url(thread_data->ota_request.download_url), &record)) {
+        return;
+    }
+
+    if (edgehog_settings_save(OTA_KEY, OTA_SLOT_KEY, &record, sizeof(record))
+        != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_WRN("Unable to store the OTA image of the secondary slot");
+    }
+}
+#endif
@@ -0,0 +1,253 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_bundle.h"
+
+#include "ota_flash.h"
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_SKIP_IDENTICAL_SECTORS
+#include "ota_sectors.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/sys/util.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_bundle, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define OTA_BUNDLE_MEMBER_PREFIX "image-"
+#define DECIMAL_BASE 10
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Get the MCUboot image index from the name of a member of a bundle.
+ *
+ * @param[in] file_name Name of the member, images are named image-<N> with an optional suffix.
+ * @param[out] image_index Index of the MCUboot image.
+ * @return true if the member is an image, false otherwise.
+ */
+static bool parse_bundle_member_name(const char *file_name, uint8_t *image_index);
+
+/**
+ * @brief Prepare the secondary slot of the image stored in the next member of a bundle.
+ *
+ * @param[in] header TAR header of the member.
+ * @param[inout] user_data OTA thread data.
+ * @return 0 on success, -1 on error.
+ */
+static int bundle_on_file_start(const ztar_header_t *header, void *user_data);
+
+/**
+ * @brief Write a chunk of the image stored in a member of a bundle.
+ *
+ * @param[in] header TAR header of the member.
+ * @param[in] data Chunk of the image.
+ * @param[in] size Size of the chunk.
+ * @param[inout] user_data OTA thread data.
+ * @return 0 on success, -1 on error.
+ */
+static int bundle_on_file_data(
+    const ztar_header_t *header, const uint8_t *data, size_t size, void *user_data);
+
+/**
+ * @brief Flush and verify the image stored in a member of a bundle.
+ *
+ * @param[in] header TAR header of the member.
+ * @param[inout] user_data OTA thread data.
+ * @return 0 on success, -1 on error.
+ */
+static int bundle_on_file_end(const ztar_header_t *header, void *user_data);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+bool ota_bundle_is_bundle(const uint8_t *data, size_t size)
+{
+    size_t magic_offset = offsetof(ztar_header_t, magic);
+    return (size >= (magic_offset + ZTAR_HEADER_FIELD_MAGIC_LEN))
+        && (memcmp(data + magic_offset, "ustar\0", ZTAR_HEADER_FIELD_MAGIC_LEN) == 0);
+}
+
+edgehog_result_t ota_bundle_start(ota_thread_data_t *thread_data)
+{
+    ztar_unpack_callbacks_t cbks = { .on_file_start = bundle_on_file_start,
+        .on_file_data = bundle_on_file_data,
+        .on_file_end = bundle_on_file_end };
+    if (ztar_unpack_init(&thread_data->bundle_ctx, cbks, thread_data) != ZTAR_RESULT_OK) {
+        EDGEHOG_LOG_ERR("Unable to initialize the OTA bundle unpacking");
+        return EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+    }
+    thread_data->bundle = true;
+    thread_data->bundle_skip = true;
+    thread_data->bundle_images = 0;
+    // The size of each image is read from its TAR header
+    thread_data->image_size = 0;
+    EDGEHOG_LOG_INF("Downloading OTA bundle");
+    return EDGEHOG_RESULT_OK;
+}
+
+edgehog_result_t ota_bundle_write(ota_thread_data_t *thread_data, const uint8_t *data, size_t size)
+{
+    thread_data->bundle_result = EDGEHOG_RESULT_OK;
+    ztar_result_t zres = ztar_unpack_process(&thread_data->bundle_ctx, data, size);
+    // The trailer can be followed by the zero padding of the last TAR record
+    if ((zres == ZTAR_RESULT_OK) || (zres == ZTAR_RESULT_ARCHIVE_EXAHUSTED)) {
+        return EDGEHOG_RESULT_OK;
+    }
+    if (thread_data->bundle_result != EDGEHOG_RESULT_OK) {
+        return thread_data->bundle_result;
+    }
+    EDGEHOG_LOG_ERR("Unable to unpack the OTA bundle: %d", zres);
+    return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static bool parse_bundle_member_name(const char *file_name, uint8_t *image_index)
+{
+    const char *base_name = strrchr(file_name, '/');
+    base_name = base_name ? base_name + 1 : file_name;
+    size_t prefix_len = strlen(OTA_BUNDLE_MEMBER_PREFIX);
+    if (strncmp(base_name, OTA_BUNDLE_MEMBER_PREFIX, prefix_len) != 0) {
+        return false;
+    }
+
+    const char *number = base_name + prefix_len;
+    char *end = NULL;
+    unsigned long index = strtoul(number, &end, DECIMAL_BASE);
+    if ((end == number) || ((*end != '\0') && (*end != '.')) || (index > UINT8_MAX)) {
+        return false;
+    }
+    *image_index = (uint8_t) index;
+    return true;
+}
+
+static int bundle_on_file_start(const ztar_header_t *header, void *user_data)
+{
+    ota_thread_data_t *thread_data = (ota_thread_data_t *) user_data;
+    thread_data->bundle_skip = true;
+
+    char file_name[ZTAR_FILE_NAME_BUFF_SIZE] = { 0 };
+    ztar_filetype_t type = ZTAR_UNSUPPORTED;
+    size_t size = 0;
+    if ((ztar_unpack_get_file_name(header, file_name) != ZTAR_RESULT_OK)
+        || (ztar_unpack_get_file_type(header, &type) != ZTAR_RESULT_OK)
+        || (ztar_unpack_get_file_size(header, &size) != ZTAR_RESULT_OK)) {
+        thread_data->bundle_result = EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+        return -1;
+    }
+
+    uint8_t image_index = 0;
+    if ((type != ZTAR_REGULAR_FILE) || !parse_bundle_member_name(file_name, &image_index)) {
+        EDGEHOG_LOG_WRN("Skipping the OTA bundle member %s", file_name);
+        return 0;
+    }
+    if ((image_index >= ota_flash_get_images_count())
+        || (thread_data->bundle_images & BIT(image_index))) {
+        EDGEHOG_LOG_ERR("No slot for the OTA bundle member %s", file_name);
+        thread_data->bundle_result = EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+        return -1;
+    }
+
+    int err = flash_img_init_id(
+        &thread_data->flash_ctx, ota_flash_get_image_upload_area_id(image_index));
+    if (err) {
+        EDGEHOG_LOG_ERR("Unable to init flash area: %d", err);
+        thread_data->bundle_result = EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+        return -1;
+    }
+    if (size > thread_data->flash_ctx.flash_area->fa_size) {
+        EDGEHOG_LOG_ERR("OTA bundle member %s too large: %zu", file_name, size);
+        thread_data->bundle_result = EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+        return -1;
+    }
+    EDGEHOG_LOG_INF("Writing OTA bundle member %s to image %u", file_name, image_index);
+
+    // The slot of image 0 has been erased before the download started
+    if (image_index != 0) {
+        edgehog_result_t edgehog_result = ota_flash_erase_slot(thread_data);
+        if (edgehog_result != EDGEHOG_RESULT_OK) {
+            thread_data->bundle_result = edgehog_result;
+            return -1;
+        }
+    }
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PROGRESSIVE_ERASE
+    thread_data->erased_size = 0;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_SKIP_IDENTICAL_SECTORS
+    ota_sectors_start_compare(thread_data);
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+    edgehog_result_t hash_result = ota_flash_start_hash(thread_data);
+    if (hash_result != EDGEHOG_RESULT_OK) {
+        thread_data->bundle_result = hash_result;
+        return -1;
+    }
+#endif
+
+    thread_data->image_index = image_index;
+    thread_data->image_size = size;
+    thread_data->received_size = 0;
+    thread_data->bundle_images |= BIT(image_index);
+    thread_data->bundle_skip = false;
+    return 0;
+}
+
+static int bundle_on_file_data(
+    const ztar_header_t *header, const uint8_t *data, size_t size, void *user_data)
+{
+    ARG_UNUSED(header);
+    ota_thread_data_t *thread_data = (ota_thread_data_t *) user_data;
+    if (thread_data->bundle_skip) {
+        return 0;
+    }
+
+    int ret = ota_flash_write(thread_data, data, size, false);
+    if (ret < 0) {
+        EDGEHOG_LOG_ERR("Flash write error: %d", ret);
+        thread_data->bundle_result = EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+        return -1;
+    }
+    thread_data->received_size += size;
+    return 0;
+}
+
+static int bundle_on_file_end(const ztar_header_t *header, void *user_data)
+{
+    ARG_UNUSED(header);
+    ota_thread_data_t *thread_data = (ota_thread_data_t *) user_data;
+    if (thread_data->bundle_skip) {
+        return 0;
+    }
+
+    int ret = ota_flash_write(thread_data, NULL, 0, true);
+    if (ret < 0) {
+        EDGEHOG_LOG_ERR("Flash write error: %d", ret);
+        thread_data->bundle_result = EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+        return -1;
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+    thread_data->bundle_result = ota_flash_verify_hash(thread_data);
+#else
+    if (!thread_data->header_valid) {
+        EDGEHOG_LOG_ERR("The OTA bundle member is not an MCUboot image");
+        thread_data->bundle_result = EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+#endif
+    return (thread_data->bundle_result == EDGEHOG_RESULT_OK) ? 0 : -1;
+}
@@ -0,0 +1,64 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_checkpoint.h"
+
+#include <string.h>
+
+#include <zephyr/drivers/flash.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_checkpoint, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void ota_checkpoint_init(ota_checkpoint_t *checkpoint, const char *uuid, uint32_t url_hash,
+    size_t image_size, const struct flash_area *flash_area, size_t persisted_size)
+{
+    memset(checkpoint, 0, sizeof(ota_checkpoint_t));
+    strncpy(checkpoint->uuid, uuid, UUID_STR_LEN - 1);
+    checkpoint->url_hash = url_hash;
+    checkpoint->image_size = (uint32_t) image_size;
+    checkpoint->bytes_written = (uint32_t) persisted_size;
+    checkpoint->flash_offset = (uint32_t) (flash_area->fa_off + persisted_size);
+}
+
+bool ota_checkpoint_matches(
+    const ota_checkpoint_t *checkpoint, const char *uuid, uint32_t url_hash)
+{
+    return (strncmp(checkpoint->uuid, uuid, UUID_STR_LEN) == 0)
+        && (checkpoint->url_hash == url_hash) && (checkpoint->bytes_written > 0)
+        && (checkpoint->bytes_written < checkpoint->image_size);
+}
+
+bool ota_checkpoint_is_due(size_t checkpoint_size, size_t persisted_size, size_t image_size)
+{
+    // Only the data flushed to flash survives a reboot
+    return (persisted_size >= (checkpoint_size + CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT_INTERVAL))
+        && (persisted_size < image_size);
+}
+
+bool ota_checkpoint_get_resume_size(const ota_checkpoint_t *checkpoint,
+    const struct flash_area *flash_area, size_t *resume_size)
+{
+    if ((checkpoint->image_size > flash_area->fa_size)
+        || (checkpoint->flash_offset != (flash_area->fa_off + checkpoint->bytes_written))) {
+        EDGEHOG_LOG_WRN("OTA checkpoint doesn't match the secondary slot layout, discarding it");
+        return false;
+    }
+
+    struct flash_pages_info page_info = { 0 };
+    int err = flash_get_page_info_by_offs(
+        flash_area_get_device(flash_area), checkpoint->flash_offset, &page_info);
+    if (err) {
+        EDGEHOG_LOG_ERR("Unable to get the flash page info: %d", err);
+        return false;
+    }
+    *resume_size = page_info.start_offset - flash_area->fa_off;
+    return *resume_size > 0;
+}
@@ -0,0 +1,362 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_delta.h"
+
+#include <string.h>
+
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_delta, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define HEADER_MAGIC_OFFSET 0
+#define HEADER_SOURCE_SIZE_OFFSET 4
+#define HEADER_TARGET_SIZE_OFFSET 8
+#define HEADER_SOURCE_HASH_OFFSET 16
+#define HEADER_TARGET_HASH_OFFSET (HEADER_SOURCE_HASH_OFFSET + OTA_DELTA_HASH_SIZE)
+
+#define CONTROL_DIFF_LEN_OFFSET 0
+#define CONTROL_EXTRA_LEN_OFFSET 4
+#define CONTROL_SEEK_OFFSET 8
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Accumulate bytes of the patch in the header buffer.
+ *
+ * @param[inout] ctx Delta patch context.
+ * @param[in] data Chunk of the patch.
+ * @param[in] size Size of the chunk.
+ * @param[in] needed Bytes to accumulate.
+ * @param[out] used Bytes of the chunk consumed.
+ * @return true once the needed bytes have been accumulated, false otherwise.
+ */
+static bool accumulate(
+    ota_delta_ctx_t *ctx, const uint8_t *data, size_t size, size_t needed, size_t *used);
+
+/**
+ * @brief Parse the patch header and verify the source image.
+ *
+ * @param[inout] ctx Delta patch context.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t parse_header(ota_delta_ctx_t *ctx);
+
+/**
+ * @brief Verify the content of the source flash area against the hash in the patch header.
+ *
+ * @param[inout] ctx Delta patch context.
+ * @param[in] source_hash Expected SHA-256 of the source image.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t verify_source(ota_delta_ctx_t *ctx, const uint8_t *source_hash);
+
+/**
+ * @brief Parse the control block of a record.
+ *
+ * @param[inout] ctx Delta patch context.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t parse_control(ota_delta_ctx_t *ctx);
+
+/**
+ * @brief Move to the next section of the current record, or close the record.
+ *
+ * @param[inout] ctx Delta patch context.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t advance_record(ota_delta_ctx_t *ctx);
+
+/**
+ * @brief Hash and write a chunk of the reconstructed image.
+ *
+ * @param[inout] ctx Delta patch context.
+ * @param[in] data Reconstructed data.
+ * @param[in] size Size of the reconstructed data.
+ * @return EDGEHOG_RESULT_OK on success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t output(ota_delta_ctx_t *ctx, const uint8_t *data, size_t size);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+bool ota_delta_is_patch(const uint8_t *data, size_t size)
+{
+    return (size >= sizeof(uint32_t)) && (sys_get_le32(data) == OTA_DELTA_MAGIC);
+}
+
+edgehog_result_t ota_delta_init(ota_delta_ctx_t *ctx, uint8_t source_area_id,
+    ota_delta_write_cbk_t write_cbk, void *user_data)
+{
+    if (!ctx || !write_cbk) {
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    memset(ctx, 0, sizeof(ota_delta_ctx_t));
+    ctx->state = OTA_DELTA_STATE_HEADER;
+    ctx->write_cbk = write_cbk;
+    ctx->user_data = user_data;
+
+    int err = flash_area_open(source_area_id, &ctx->source_area);
+    if (err) {
+        EDGEHOG_LOG_ERR("Unable to open the source flash area: %d", err);
+        ctx->source_area = NULL;
+        return EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+    }
+
+    psa_status_t status = psa_crypto_init();
+    if (status != PSA_SUCCESS) {
+        EDGEHOG_LOG_ERR("psa_crypto_init returned %d", status);
+        goto error;
+    }
+    ctx->hash_operation = psa_hash_operation_init();
+    status = psa_hash_setup(&ctx->hash_operation, PSA_ALG_SHA_256);
+    if (status != PSA_SUCCESS) {
+        EDGEHOG_LOG_ERR("psa_hash_setup returned %d", status);
+        goto error;
+    }
+
+    return EDGEHOG_RESULT_OK;
+
+error:
+    flash_area_close(ctx->source_area);
+    ctx->source_area = NULL;
+    return EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+}
+
+edgehog_result_t ota_delta_process(ota_delta_ctx_t *ctx, const uint8_t *data, size_t size)
+{
+    edgehog_result_t res = EDGEHOG_RESULT_OK;
+
+    while ((size > 0) && (res == EDGEHOG_RESULT_OK)) {
+        size_t used = 0;
+        switch (ctx->state) {
+            case OTA_DELTA_STATE_HEADER:
+                if (accumulate(ctx, data, size, OTA_DELTA_HEADER_SIZE, &used)) {
+                    res = parse_header(ctx);
+                }
+                break;
+            case OTA_DELTA_STATE_CONTROL:
+                if (ctx->target_offset == ctx->target_size) {
+                    EDGEHOG_LOG_ERR("Unexpected data after the end of the delta patch");
+                    return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+                }
+                if (accumulate(ctx, data, size, OTA_DELTA_CONTROL_SIZE, &used)) {
+                    res = parse_control(ctx);
+                }
+                break;
+            case OTA_DELTA_STATE_DIFF: {
+                used = MIN(MIN(size, ctx->diff_left), sizeof(ctx->source_buf));
+                int err = flash_area_read(
+                    ctx->source_area, (off_t) ctx->source_offset, ctx->source_buf, used);
+                if (err) {
+                    EDGEHOG_LOG_ERR("Unable to read the source image: %d", err);
+                    return EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+                }
+                for (size_t i = 0; i < used; i++) {
+                    ctx->source_buf[i] += data[i];
+                }
+                ctx->source_offset += used;
+                ctx->diff_left -= used;
+                res = output(ctx, ctx->source_buf, used);
+                if ((res == EDGEHOG_RESULT_OK) && (ctx->diff_left == 0)) {
+                    res = advance_record(ctx);
+                }
+                break;
+            }
+            default: // OTA_DELTA_STATE_EXTRA
+                used = MIN(size, ctx->extra_left);
+                ctx->extra_left -= used;
+                res = output(ctx, data, used);
+                if ((res == EDGEHOG_RESULT_OK) && (ctx->extra_left == 0)) {
+                    res = advance_record(ctx);
+                }
+                break;
+        }
+        data += used;
+        size -= used;
+    }
+
+    return res;
+}
+
+edgehog_result_t ota_delta_finish(ota_delta_ctx_t *ctx)
+{
+    if ((ctx->state != OTA_DELTA_STATE_CONTROL) || (ctx->header_len != 0)
+        || (ctx->target_offset != ctx->target_size)) {
+        EDGEHOG_LOG_ERR("Incomplete delta patch, reconstructed %zu of %zu bytes",
+            ctx->target_offset, ctx->target_size);
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+    psa_status_t status
+        = psa_hash_verify(&ctx->hash_operation, ctx->target_hash, sizeof(ctx->target_hash));
+    if (status != PSA_SUCCESS) {
+        EDGEHOG_LOG_ERR("Reconstructed image hash mismatch: %d", status);
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+    EDGEHOG_LOG_INF("Delta patch applied, reconstructed %zu bytes", ctx->target_size);
+    return EDGEHOG_RESULT_OK;
+}
+
+void ota_delta_free(ota_delta_ctx_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    psa_hash_abort(&ctx->hash_operation);
+    if (ctx->source_area) {
+        flash_area_close(ctx->source_area);
+        ctx->source_area = NULL;
+    }
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static bool accumulate(
+    ota_delta_ctx_t *ctx, const uint8_t *data, size_t size, size_t needed, size_t *used)
+{
+    *used = MIN(size, needed - ctx->header_len);
+    memcpy(&ctx->header_buf[ctx->header_len], data, *used);
+    ctx->header_len += *used;
+    if (ctx->header_len < needed) {
+        return false;
+    }
+    ctx->header_len = 0;
+    return true;
+}
+
+static edgehog_result_t parse_header(ota_delta_ctx_t *ctx)
+{
+    const uint8_t *header = ctx->header_buf;
+    if (sys_get_le32(&header[HEADER_MAGIC_OFFSET]) != OTA_DELTA_MAGIC) {
+        EDGEHOG_LOG_ERR("Invalid delta patch magic number");
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+    ctx->source_size = sys_get_le32(&header[HEADER_SOURCE_SIZE_OFFSET]);
+    ctx->target_size = sys_get_le32(&header[HEADER_TARGET_SIZE_OFFSET]);
+    memcpy(ctx->target_hash, &header[HEADER_TARGET_HASH_OFFSET], OTA_DELTA_HASH_SIZE);
+    if ((ctx->source_size > ctx->source_area->fa_size) || (ctx->target_size == 0)) {
+        EDGEHOG_LOG_ERR("Invalid delta patch sizes, source %zu target %zu", ctx->source_size,
+            ctx->target_size);
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+    edgehog_result_t res = verify_source(ctx, &header[HEADER_SOURCE_HASH_OFFSET]);
+    if (res != EDGEHOG_RESULT_OK) {
+        return res;
+    }
+
+    EDGEHOG_LOG_INF("Applying delta patch, source %zu bytes target %zu bytes", ctx->source_size,
+        ctx->target_size);
+    ctx->state = OTA_DELTA_STATE_CONTROL;
+    return EDGEHOG_RESULT_OK;
+}
+
+static edgehog_result_t verify_source(ota_delta_ctx_t *ctx, const uint8_t *source_hash)
+{
+    edgehog_result_t res = EDGEHOG_RESULT_OK;
+    psa_hash_operation_t source_operation = psa_hash_operation_init();
+    psa_status_t status = psa_hash_setup(&source_operation, PSA_ALG_SHA_256);
+    if (status != PSA_SUCCESS) {
+        EDGEHOG_LOG_ERR("psa_hash_setup returned %d", status);
+        return EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+    }
+
+    for (size_t offset = 0; offset < ctx->source_size; offset += sizeof(ctx->source_buf)) {
+        size_t read_size = MIN(sizeof(ctx->source_buf), ctx->source_size - offset);
+        int err = flash_area_read(ctx->source_area, (off_t) offset, ctx->source_buf, read_size);
+        if (err) {
+            EDGEHOG_LOG_ERR("Unable to read the source image: %d", err);
+            res = EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+            goto exit;
+        }
+        status = psa_hash_update(&source_operation, ctx->source_buf, read_size);
+        if (status != PSA_SUCCESS) {
+            EDGEHOG_LOG_ERR("psa_hash_update returned %d", status);
+            res = EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+            goto exit;
+        }
+    }
+
+    status = psa_hash_verify(&source_operation, source_hash, OTA_DELTA_HASH_SIZE);
+    if (status != PSA_SUCCESS) {
+        EDGEHOG_LOG_ERR("The running image doesn't match the delta patch source");
+        res = EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+exit:
+    psa_hash_abort(&source_operation);
+    return res;
+}
+
+static edgehog_result_t parse_control(ota_delta_ctx_t *ctx)
+{
+    const uint8_t *control = ctx->header_buf;
+    ctx->diff_left = sys_get_le32(&control[CONTROL_DIFF_LEN_OFFSET]);
+    ctx->extra_left = sys_get_le32(&control[CONTROL_EXTRA_LEN_OFFSET]);
+    ctx->seek = (int32_t) sys_get_le32(&control[CONTROL_SEEK_OFFSET]);
+
+    // Bound the diff length first, so that the extra length check can't overflow
+    size_t target_left = ctx->target_size - ctx->target_offset;
+    if ((ctx->diff_left > (ctx->source_size - ctx->source_offset))
+        || (ctx->diff_left > target_left) || (ctx->extra_left > (target_left - ctx->diff_left))) {
+        EDGEHOG_LOG_ERR("Delta patch record out of bounds");
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+    return advance_record(ctx);
+}
+
+static edgehog_result_t advance_record(ota_delta_ctx_t *ctx)
+{
+    if (ctx->diff_left > 0) {
+        ctx->state = OTA_DELTA_STATE_DIFF;
+        return EDGEHOG_RESULT_OK;
+    }
+    if (ctx->extra_left > 0) {
+        ctx->state = OTA_DELTA_STATE_EXTRA;
+        return EDGEHOG_RESULT_OK;
+    }
+
+    int64_t source_offset = (int64_t) ctx->source_offset + ctx->seek;
+    if ((source_offset < 0) || (source_offset > (int64_t) ctx->source_size)) {
+        EDGEHOG_LOG_ERR("Delta patch seek out of bounds");
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+    ctx->source_offset = (size_t) source_offset;
+    ctx->state = OTA_DELTA_STATE_CONTROL;
+    return EDGEHOG_RESULT_OK;
+}
+
+static edgehog_result_t output(ota_delta_ctx_t *ctx, const uint8_t *data, size_t size)
+{
+    psa_status_t status = psa_hash_update(&ctx->hash_operation, data, size);
+    if (status != PSA_SUCCESS) {
+        EDGEHOG_LOG_ERR("psa_hash_update returned %d", status);
+        return EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+    }
+
+    int ret = ctx->write_cbk(data, size, ctx->user_data);
+    if (ret < 0) {
+        return EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+    }
+    ctx->target_offset += size;
+    return EDGEHOG_RESULT_OK;
+}
@@ -0,0 +1,414 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_encoding.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+#include "ota_bundle.h"
+#endif
+#include "ota_flash.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_encoding, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define LZ4_FRAME_MAGIC 0x184D2204U
+#define LZ4_FRAME_FLG_OFFSET 4
+#define LZ4_FRAME_FLG_CONTENT_SIZE BIT(3)
+#define LZ4_FRAME_CONTENT_SIZE_OFFSET 6
+#define LZ4_FRAME_CONTENT_SIZE_LEN 8
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+BUILD_ASSERT(
+    OTA_ENCODING_PROBE_SIZE >= (LZ4_FRAME_CONTENT_SIZE_OFFSET + LZ4_FRAME_CONTENT_SIZE_LEN),
+    "The encoding probe must hold the LZ4 frame header up to the content size");
+#endif
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Detect the encoding of the image from the start of the download and prepare its decoding.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] data First bytes of the download.
+ * @param[in] size Number of bytes available.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t detect_image_encoding(
+    ota_thread_data_t *thread_data, const uint8_t *data, size_t size);
+
+/**
+ * @brief Write decoded image payload, applying it as a delta patch when the image is one.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] data Decoded payload.
+ * @param[in] size Size of the decoded payload.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t write_image_payload(
+    ota_thread_data_t *thread_data, const uint8_t *data, size_t size);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+/**
+ * @brief Decompression callback writing the decompressed image payload.
+ *
+ * @param[in] data Decompressed data.
+ * @param[in] size Size of the decompressed data.
+ * @param[inout] user_data OTA thread data.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+static int write_decompressed_data(const uint8_t *data, size_t size, void *user_data);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+/**
+ * @brief Detect a delta patch and prepare its application.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] data First bytes of the patch.
+ * @param[in] size Number of bytes available.
+ * @return EDGEHOG_RESULT_OK upon success, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t detect_image_delta(
+    ota_thread_data_t *thread_data, const uint8_t *data, size_t size);
+
+/**
+ * @brief Delta patch callback writing the reconstructed image to the secondary slot.
+ *
+ * @param[in] data Reconstructed data.
+ * @param[in] size Size of the reconstructed data.
+ * @param[inout] user_data OTA thread data.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+static int write_patched_data(const uint8_t *data, size_t size, void *user_data);
+#endif
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+edgehog_result_t ota_encoding_probe(ota_thread_data_t *thread_data,
+    edgehog_http_response_chunk_t *response_chunk, ota_encoding_write_cbk_t write_cbk)
+{
+    size_t copy_size = MIN(sizeof(thread_data->probe_buf) - thread_data->probe_size,
+        response_chunk->chunk_size);
+    memcpy(thread_data->probe_buf + thread_data->probe_size, response_chunk->chunk_start_addr,
+        copy_size);
+    thread_data->probe_size += copy_size;
+    if ((thread_data->probe_size < sizeof(thread_data->probe_buf)) && !response_chunk->last_chunk) {
+        return EDGEHOG_RESULT_OK;
+    }
+
+    edgehog_result_t edgehog_result
+        = detect_image_encoding(thread_data, thread_data->probe_buf, thread_data->probe_size);
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        return edgehog_result;
+    }
+
+    // The gathered bytes are the start of the download, the rest of the chunk follows them
+    edgehog_http_response_chunk_t probe_chunk = *response_chunk;
+    probe_chunk.chunk_start_addr = thread_data->probe_buf;
+    probe_chunk.chunk_size = thread_data->probe_size;
+    probe_chunk.last_chunk
+        = response_chunk->last_chunk && (copy_size == response_chunk->chunk_size);
+    edgehog_result = write_cbk(thread_data, &probe_chunk);
+    if ((edgehog_result != EDGEHOG_RESULT_OK) || (copy_size == response_chunk->chunk_size)) {
+        return edgehog_result;
+    }
+
+    edgehog_http_response_chunk_t rest_chunk = *response_chunk;
+    rest_chunk.chunk_start_addr += copy_size;
+    rest_chunk.chunk_size -= copy_size;
+    return write_cbk(thread_data, &rest_chunk);
+}
+
+bool ota_encoding_is_encoded(const ota_thread_data_t *thread_data)
+{
+    bool encoded = false;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    encoded = encoded || thread_data->compressed;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    encoded = encoded || thread_data->delta;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    encoded = encoded || thread_data->bundle;
+#endif
+    return encoded;
+}
+
+edgehog_result_t ota_encoding_write_chunk(
+    ota_thread_data_t *thread_data, edgehog_http_response_chunk_t *response_chunk)
+{
+    edgehog_result_t res = EDGEHOG_RESULT_OK;
+    thread_data->attempt_received_size += response_chunk->chunk_size;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    thread_data->bundle_size = response_chunk->response_size;
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    if (thread_data->compressed) {
+        thread_data->compressed_size = response_chunk->response_size;
+        int ret = file_transfer_decompression_process_chunk(&thread_data->decomp_ctx,
+            response_chunk->chunk_start_addr, response_chunk->chunk_size);
+        if (ret < 0) {
+            if (thread_data->decompressed_write_result != EDGEHOG_RESULT_OK) {
+                return thread_data->decompressed_write_result;
+            }
+            EDGEHOG_LOG_ERR("Unable to decompress the OTA image");
+            return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+        }
+    } else
+#endif
+    {
+        res = write_image_payload(
+            thread_data, response_chunk->chunk_start_addr, response_chunk->chunk_size);
+        if (res != EDGEHOG_RESULT_OK) {
+            return res;
+        }
+    }
+
+    if (!response_chunk->last_chunk) {
+        return EDGEHOG_RESULT_OK;
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    // The images of a bundle are flushed as each member ends
+    if (thread_data->bundle) {
+        if (thread_data->bundle_ctx.bytes_processed_in_trailer < ZTAR_TRAILER_SIZE) {
+            EDGEHOG_LOG_ERR("The OTA bundle is truncated");
+            return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+        }
+        return EDGEHOG_RESULT_OK;
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    if (thread_data->delta) {
+        res = ota_delta_finish(&thread_data->delta_ctx);
+        if (res != EDGEHOG_RESULT_OK) {
+            return res;
+        }
+    }
+#endif
+
+    int ret = ota_flash_write(thread_data, NULL, 0, true);
+    if (ret < 0) {
+        EDGEHOG_LOG_ERR("Flash write error: %d", ret);
+        return EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+    }
+
+    return EDGEHOG_RESULT_OK;
+}
+
+edgehog_result_t ota_encoding_restart(ota_thread_data_t *thread_data)
+{
+    EDGEHOG_LOG_INF("Restarting the encoded OTA download from the beginning");
+
+    ota_encoding_free(thread_data);
+    thread_data->received_size = 0;
+    thread_data->image_size = 0;
+    thread_data->image_index = 0;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    thread_data->bundle_images = 0;
+#endif
+
+    int err = flash_img_init_id(&thread_data->flash_ctx, ota_flash_get_upload_area_id());
+    if (err) {
+        EDGEHOG_LOG_ERR("Unable to init flash area: %d", err);
+        return EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+    }
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+    edgehog_result_t edgehog_result = ota_flash_start_hash(thread_data);
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        return edgehog_result;
+    }
+#endif
+    return ota_flash_erase_slot(thread_data);
+}
+
+void ota_encoding_free(ota_thread_data_t *thread_data)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    file_transfer_decompression_free(&thread_data->decomp_ctx);
+    thread_data->compressed = false;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    if (thread_data->delta) {
+        ota_delta_free(&thread_data->delta_ctx);
+        thread_data->delta = false;
+    }
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    // The mask of the written images is kept for their deployment
+    thread_data->bundle = false;
+#endif
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static edgehog_result_t detect_image_encoding(
+    ota_thread_data_t *thread_data, const uint8_t *data, size_t size)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    if ((size >= sizeof(uint32_t)) && (sys_get_le32(data) == LZ4_FRAME_MAGIC)) {
+        int ret = file_transfer_decompression_init(
+            &thread_data->decomp_ctx, write_decompressed_data, thread_data);
+        if (ret < 0) {
+            EDGEHOG_LOG_ERR("Unable to initialize the OTA image decompression");
+            return EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+        }
+        thread_data->compressed = true;
+        thread_data->decompressed_write_result = EDGEHOG_RESULT_OK;
+
+        // The uncompressed size is only known when the frame header carries the content size
+        thread_data->image_size = 0;
+        if ((size >= (LZ4_FRAME_CONTENT_SIZE_OFFSET + LZ4_FRAME_CONTENT_SIZE_LEN))
+            && (data[LZ4_FRAME_FLG_OFFSET] & LZ4_FRAME_FLG_CONTENT_SIZE)) {
+            uint64_t content_size = sys_get_le64(&data[LZ4_FRAME_CONTENT_SIZE_OFFSET]);
+            if (content_size > thread_data->flash_ctx.flash_area->fa_size) {
+                EDGEHOG_LOG_ERR(
+                    "Compressed OTA image too large: %llu", (unsigned long long) content_size);
+                return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+            }
+            thread_data->image_size = (size_t) content_size;
+        }
+        EDGEHOG_LOG_INF("Downloading LZ4 compressed OTA image, uncompressed size %zu",
+            thread_data->image_size);
+        return EDGEHOG_RESULT_OK;
+    }
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    if (ota_bundle_is_bundle(data, size)) {
+        return ota_bundle_start(thread_data);
+    }
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    return detect_image_delta(thread_data, data, size);
+#else
+    ARG_UNUSED(thread_data);
+    ARG_UNUSED(data);
+    ARG_UNUSED(size);
+    return EDGEHOG_RESULT_OK;
+#endif
+}
+
+static edgehog_result_t write_image_payload(
+    ota_thread_data_t *thread_data, const uint8_t *data, size_t size)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    // A compressed image can wrap a bundle, detect it from the first decompressed bytes
+    if (!thread_data->bundle && (thread_data->received_size == 0)
+        && ota_bundle_is_bundle(data, size)) {
+        edgehog_result_t res = ota_bundle_start(thread_data);
+        if (res != EDGEHOG_RESULT_OK) {
+            return res;
+        }
+    }
+    if (thread_data->bundle) {
+        return ota_bundle_write(thread_data, data, size);
+    }
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    // A compressed image can wrap a delta patch, detect it from the first decompressed bytes
+    if (!thread_data->delta && (thread_data->received_size == 0)) {
+        edgehog_result_t res = detect_image_delta(thread_data, data, size);
+        if (res != EDGEHOG_RESULT_OK) {
+            return res;
+        }
+    }
+    if (thread_data->delta) {
+        edgehog_result_t res = ota_delta_process(&thread_data->delta_ctx, data, size);
+        // The size of the reconstructed image is known once the patch header has been parsed
+        thread_data->image_size = thread_data->delta_ctx.target_size;
+        if (thread_data->patched_write_result != EDGEHOG_RESULT_OK) {
+            return thread_data->patched_write_result;
+        }
+        return res;
+    }
+#endif
+
+    if ((thread_data->image_size > 0)
+        && ((thread_data->received_size + size) > thread_data->image_size)) {
+        EDGEHOG_LOG_ERR("Decoded OTA image exceeds the declared size %zu", thread_data->image_size);
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+    int ret = ota_flash_write(thread_data, data, size, false);
+    if (ret < 0) {
+        EDGEHOG_LOG_ERR("Flash write error: %d", ret);
+        return EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+    }
+    thread_data->received_size += size;
+    return EDGEHOG_RESULT_OK;
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+static int write_decompressed_data(const uint8_t *data, size_t size, void *user_data)
+{
+    ota_thread_data_t *thread_data = (ota_thread_data_t *) user_data;
+
+    thread_data->decompressed_write_result = write_image_payload(thread_data, data, size);
+    return (thread_data->decompressed_write_result == EDGEHOG_RESULT_OK) ? 0 : -EIO;
+}
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+static edgehog_result_t detect_image_delta(
+    ota_thread_data_t *thread_data, const uint8_t *data, size_t size)
+{
+    if (!ota_delta_is_patch(data, size)) {
+        return EDGEHOG_RESULT_OK;
+    }
+
+    edgehog_result_t res = ota_delta_init(&thread_data->delta_ctx,
+        ota_flash_get_running_area_id(), write_patched_data, thread_data);
+    if (res != EDGEHOG_RESULT_OK) {
+        return res;
+    }
+    thread_data->delta = true;
+    thread_data->patched_write_result = EDGEHOG_RESULT_OK;
+    // The size of the image is read from the patch header
+    thread_data->image_size = 0;
+    EDGEHOG_LOG_INF("Downloading delta OTA patch");
+    return EDGEHOG_RESULT_OK;
+}
+
+static int write_patched_data(const uint8_t *data, size_t size, void *user_data)
+{
+    ota_thread_data_t *thread_data = (ota_thread_data_t *) user_data;
+    size_t target_size = thread_data->delta_ctx.target_size;
+
+    // Same bounds as the plain images, checked before the patched data reaches the slot
+    if ((target_size > thread_data->flash_ctx.flash_area->fa_size)
+        || ((thread_data->received_size + size) > target_size)) {
+        EDGEHOG_LOG_ERR("Patched OTA image exceeds the target size %zu", target_size);
+        thread_data->patched_write_result = EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+        return -EFBIG;
+    }
+
+    int ret = ota_flash_write(thread_data, data, size, false);
+    if (ret < 0) {
+        EDGEHOG_LOG_ERR("Flash write error: %d", ret);
+        thread_data->patched_write_result = EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+        return ret;
+    }
+    thread_data->received_size += size;
+    return 0;
+}
+#endif
@@ -0,0 +1,609 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_flash.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_SKIP_IDENTICAL_SECTORS
+#include "ota_sectors.h"
+#endif
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/dfu/mcuboot.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/version.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_flash, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define SLOT0_LABEL slot0_partition
+#define SLOT1_LABEL slot1_partition
+
+#if KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(4, 4, 0)
+#define OTA_PARTITION_ID(label) PARTITION_ID(label)
+#else
+#define OTA_PARTITION_ID(label) FIXED_PARTITION_ID(label)
+#endif
+#define FLASH_AREA_IMAGE_PRIMARY OTA_PARTITION_ID(SLOT0_LABEL)
+#define FLASH_AREA_IMAGE_SECONDARY OTA_PARTITION_ID(SLOT1_LABEL)
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+#define SLOT2_LABEL slot2_partition
+#define SLOT3_LABEL slot3_partition
+#define SLOT4_LABEL slot4_partition
+#define SLOT5_LABEL slot5_partition
+#define OTA_IMAGES_COUNT ARRAY_SIZE(ota_image_pairs)
+
+/** @brief Flash areas of an MCUboot image pair. */
+typedef struct
+{
+    /** @brief Flash area holding the running image. */
+    uint8_t primary_area_id;
+    /** @brief Flash area the new image is written to. */
+    uint8_t secondary_area_id;
+} ota_image_pair_t;
+
+/** @brief MCUboot image pairs, indexed by image number. */
+static const ota_image_pair_t ota_image_pairs[] = {
+    { FLASH_AREA_IMAGE_PRIMARY, FLASH_AREA_IMAGE_SECONDARY },
+#if DT_NODE_EXISTS(DT_NODELABEL(SLOT3_LABEL))
+    { OTA_PARTITION_ID(SLOT2_LABEL), OTA_PARTITION_ID(SLOT3_LABEL) },
+#if DT_NODE_EXISTS(DT_NODELABEL(SLOT5_LABEL))
+    { OTA_PARTITION_ID(SLOT4_LABEL), OTA_PARTITION_ID(SLOT5_LABEL) },
+#endif
+#endif
+};
+#else
+#define OTA_IMAGES_COUNT 1
+#endif
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+// Receive buffer lent to the HTTP client, aligned so that the image can be written from it
+static uint8_t ota_recv_buf[CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE] __aligned(4);
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Collect the MCUboot header from the first bytes of the image and validate it.
+ *
+ * @details With CONFIG_EDGEHOG_DEVICE_OTA_VALIDATE_HEADER an image that can't be booted is
+ * rejected as soon as its header has been received, before the rest of it is downloaded.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] offset Offset of the data in the image.
+ * @param[in] data Chunk of the image.
+ * @param[in] size Size of the chunk.
+ * @return 0 upon success, -ENOEXEC if the image has been rejected.
+ */
+static int process_image_header(
+    ota_thread_data_t *thread_data, size_t offset, const uint8_t *data, size_t size);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VALIDATE_HEADER
+/**
+ * @brief Check that the image described by its header can be booted in place of the running one.
+ *
+ * @param[in] thread_data OTA thread data, holding the parsed header.
+ * @return true if the image is acceptable, false otherwise.
+ */
+static bool is_image_header_acceptable(const ota_thread_data_t *thread_data);
+#endif
+
+/**
+ * @brief Get the start time of an erase of the secondary slot for the OTA stats.
+ *
+ * @return Uptime in milliseconds, zero without CONFIG_EDGEHOG_DEVICE_OTA_STATS.
+ */
+static inline int64_t start_erase_time(void);
+
+/**
+ * @brief Add the time elapsed since an erase of the secondary slot started to the OTA stats.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] start_ms Uptime at the start of the erase.
+ */
+static void account_erase_time(ota_thread_data_t *thread_data, int64_t start_ms);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+/**
+ * @brief Add the next bytes of the image to the running hash.
+ *
+ * @details Only the part of the image covered by the MCUboot hash TLV is hashed, its size is
+ * known once the image header has been received.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] data Chunk of the image.
+ * @param[in] size Size of the chunk.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+static int update_image_hash(ota_thread_data_t *thread_data, const uint8_t *data, size_t size);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PROGRESSIVE_ERASE
+/**
+ * @brief Erase the pages of the secondary slot not yet erased up to an offset.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] end Offset in the slot of the end of the next write.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+static int erase_image_ahead(ota_thread_data_t *thread_data, size_t end);
+#endif
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+uint8_t *ota_flash_get_recv_buf(size_t *size)
+{
+    *size = sizeof(ota_recv_buf);
+    return ota_recv_buf;
+}
+
+uint8_t ota_flash_get_images_count(void)
+{
+    return OTA_IMAGES_COUNT;
+}
+
+uint8_t ota_flash_get_running_area_id(void)
+{
+#ifdef OTA_SLOT_SELECTION
+    return boot_fetch_active_slot();
+#else
+    return FLASH_AREA_IMAGE_PRIMARY;
+#endif
+}
+
+uint8_t ota_flash_get_upload_area_id(void)
+{
+#ifdef OTA_SLOT_SELECTION
+    return (ota_flash_get_running_area_id() == FLASH_AREA_IMAGE_PRIMARY)
+        ? FLASH_AREA_IMAGE_SECONDARY
+        : FLASH_AREA_IMAGE_PRIMARY;
+#else
+    return FLASH_AREA_IMAGE_SECONDARY;
+#endif
+}
+
+uint8_t ota_flash_get_image_running_area_id(uint8_t image_index)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    if (image_index > 0) {
+        return ota_image_pairs[image_index].primary_area_id;
+    }
+#endif
+    ARG_UNUSED(image_index);
+    return ota_flash_get_running_area_id();
+}
+
+uint8_t ota_flash_get_image_upload_area_id(uint8_t image_index)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    if (image_index > 0) {
+        return ota_image_pairs[image_index].secondary_area_id;
+    }
+#endif
+    ARG_UNUSED(image_index);
+    return ota_flash_get_upload_area_id();
+}
+
+uint8_t ota_flash_get_images(const ota_thread_data_t *thread_data)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_BUNDLE
+    if (thread_data->bundle_images != 0) {
+        return thread_data->bundle_images;
+    }
+#endif
+    ARG_UNUSED(thread_data);
+    return BIT(0);
+}
+
+int ota_flash_write(ota_thread_data_t *thread_data, const uint8_t *data, size_t size, bool flush)
+{
+    struct stream_flash_ctx *stream = &thread_data->flash_ctx.stream;
+    size_t write_block_size = flash_get_write_block_size(stream->fdev);
+
+    int header_err = process_image_header(thread_data, thread_data->received_size, data, size);
+    if (header_err != 0) {
+        return header_err;
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+    int hash_err = update_image_hash(thread_data, data, size);
+    if (hash_err != 0) {
+        return hash_err;
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_SKIP_IDENTICAL_SECTORS
+    if (thread_data->compare_sectors) {
+        return ota_sectors_write(thread_data, data, size, flush);
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PROGRESSIVE_ERASE
+    // The data pending in the stream flash buffer is written together with this chunk
+    int err = erase_image_ahead(thread_data,
+        ROUND_UP(stream->bytes_written + stream->buf_bytes + size, write_block_size));
+    if (err != 0) {
+        EDGEHOG_LOG_ERR("Unable to erase the secondary slot: %d", err);
+        return err;
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DIRECT_FLASH_WRITE
+    size_t direct_size = ROUND_DOWN(size, write_block_size);
+
+    // Only possible when no data is pending in the stream flash buffer, so that the writes stay
+    // in order, and from a word aligned source as required by some flash drivers
+    if ((stream->buf_bytes == 0) && (direct_size > 0) && IS_ALIGNED(data, sizeof(uint32_t))
+        && (stream->bytes_written + direct_size <= stream->available)) {
+        int ret = flash_write(stream->fdev, (off_t) (stream->offset + stream->bytes_written),
+            data, direct_size);
+        if (ret != 0) {
+            return ret;
+        }
+        ret = ota_flash_advance_stream(thread_data, direct_size);
+        if (ret != 0) {
+            return ret;
+        }
+        data += direct_size;
+        size -= direct_size;
+    }
+#else
+    ARG_UNUSED(write_block_size);
+#endif
+
+    return flash_img_buffered_write(&thread_data->flash_ctx, data, size, flush);
+}
+
+int ota_flash_advance_stream(ota_thread_data_t *thread_data, size_t size)
+{
+    struct stream_flash_ctx *stream = &thread_data->flash_ctx.stream;
+    // Data pending in the buffer would be written at the old position
+    if (stream->buf_bytes != 0) {
+        return -EINVAL;
+    }
+    if (stream->bytes_written + size > stream->available) {
+        return -ENOMEM;
+    }
+    stream->bytes_written += size;
+    return 0;
+}
+
+edgehog_result_t ota_flash_erase_slot(ota_thread_data_t *thread_data)
+{
+    int64_t erase_start_ms = start_erase_time();
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PROGRESSIVE_ERASE
+    thread_data->erased_size = 0;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_SKIP_IDENTICAL_SECTORS
+    ota_sectors_start_compare(thread_data);
+#endif
+    // MCUboot reads the trailer at the end of the slot, which the image writes don't reach
+    int err = ota_flash_erase_trailer(thread_data->flash_ctx.flash_area);
+#else
+    int err = boot_erase_img_bank(thread_data->flash_ctx.flash_area->fa_id);
+#endif
+    account_erase_time(thread_data, erase_start_ms);
+    if (err) {
+        EDGEHOG_LOG_ERR("Failed to erase second slot: %d", err);
+        return EDGEHOG_RESULT_OTA_ERASE_SECOND_SLOT_ERROR;
+    }
+    return EDGEHOG_RESULT_OK;
+}
+
+int ota_flash_erase(ota_thread_data_t *thread_data, size_t offset, size_t size)
+{
+    int64_t erase_start_ms = start_erase_time();
+    int err = flash_area_erase(thread_data->flash_ctx.flash_area, offset, size);
+    account_erase_time(thread_data, erase_start_ms);
+    return err;
+}
+
+#if defined(CONFIG_EDGEHOG_DEVICE_OTA_PROGRESSIVE_ERASE)                                          \
+    || defined(CONFIG_EDGEHOG_DEVICE_OTA_REUSE_SECONDARY_SLOT)
+int ota_flash_erase_trailer(const struct flash_area *flash_area)
+{
+    size_t trailer_start = 0;
+    int err = ota_flash_get_trailer_start(flash_area, &trailer_start);
+    if (err) {
+        return err;
+    }
+    return flash_area_erase(flash_area, trailer_start, flash_area->fa_size - trailer_start);
+}
+
+int ota_flash_get_trailer_start(const struct flash_area *flash_area, size_t *trailer_start)
+{
+    ssize_t trailer_offset = boot_get_area_trailer_status_offset(flash_area->fa_id);
+    if (trailer_offset < 0) {
+        return (int) trailer_offset;
+    }
+    struct flash_pages_info page_info = { 0 };
+    int err = flash_get_page_info_by_offs(flash_area_get_device(flash_area),
+        (off_t) (flash_area->fa_off + trailer_offset), &page_info);
+    if (err) {
+        return err;
+    }
+    *trailer_start = page_info.start_offset - flash_area->fa_off;
+    return 0;
+}
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+edgehog_result_t ota_flash_start_hash(ota_thread_data_t *thread_data)
+{
+    psa_status_t status = psa_crypto_init();
+    if (status != PSA_SUCCESS) {
+        EDGEHOG_LOG_ERR("psa_crypto_init returned %d", status);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+    psa_hash_abort(&thread_data->hash_operation);
+    thread_data->hash_operation = psa_hash_operation_init();
+    status = psa_hash_setup(&thread_data->hash_operation, PSA_ALG_SHA_256);
+    if (status != PSA_SUCCESS) {
+        EDGEHOG_LOG_ERR("psa_hash_setup returned %d", status);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+    thread_data->hash_offset = 0;
+    return EDGEHOG_RESULT_OK;
+}
+
+edgehog_result_t ota_flash_hash_slot(ota_thread_data_t *thread_data, size_t size)
+{
+    edgehog_result_t edgehog_result = ota_flash_start_hash(thread_data);
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        return edgehog_result;
+    }
+
+    // The receive buffer is not in use before the download starts
+    for (size_t offset = 0; offset < size; offset += sizeof(ota_recv_buf)) {
+        size_t read_size = MIN(sizeof(ota_recv_buf), size - offset);
+        int err = flash_area_read(
+            thread_data->flash_ctx.flash_area, (off_t) offset, ota_recv_buf, read_size);
+        if (err || (process_image_header(thread_data, offset, ota_recv_buf, read_size) != 0)
+            || (update_image_hash(thread_data, ota_recv_buf, read_size) != 0)) {
+            return EDGEHOG_RESULT_FLASH_ERROR;
+        }
+    }
+    return EDGEHOG_RESULT_OK;
+}
+
+edgehog_result_t ota_flash_verify_hash(ota_thread_data_t *thread_data)
+{
+    if (!thread_data->header_valid) {
+        EDGEHOG_LOG_ERR("The OTA image is not an MCUboot image");
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+    if (thread_data->hash_offset < ota_image_hashed_size(&thread_data->image_header)) {
+        EDGEHOG_LOG_ERR("The OTA image is truncated, %zu of %zu bytes", thread_data->hash_offset,
+            ota_image_hashed_size(&thread_data->image_header));
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+    uint8_t expected_hash[OTA_IMAGE_HASH_SIZE] = { 0 };
+    bool found = false;
+    edgehog_result_t edgehog_result = ota_image_read_hash(thread_data->flash_ctx.flash_area->fa_id,
+        &thread_data->image_header, expected_hash, &found);
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        return edgehog_result;
+    }
+    if (!found) {
+        EDGEHOG_LOG_WRN("The OTA image has no SHA-256 TLV, leaving its check to MCUboot");
+        return EDGEHOG_RESULT_OK;
+    }
+
+    psa_status_t status = psa_hash_verify(
+        &thread_data->hash_operation, expected_hash, sizeof(expected_hash));
+    if (status != PSA_SUCCESS) {
+        EDGEHOG_LOG_ERR("The OTA image doesn't match its hash: %d", status);
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+    EDGEHOG_LOG_INF("OTA image hash verified");
+    return EDGEHOG_RESULT_OK;
+}
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT
+edgehog_result_t ota_flash_resume(ota_thread_data_t *thread_data, size_t resume_size)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+    // The running hash and the image header are lost with the reboot, rebuild them from the data
+    // already in flash
+    edgehog_result_t edgehog_result = ota_flash_hash_slot(thread_data, resume_size);
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_WRN("Unable to hash the secondary slot");
+        return edgehog_result;
+    }
+#else
+    // The image header is lost with the reboot, collect it again from the data already in flash.
+    // The receive buffer is not in use before the download starts.
+    size_t header_size = MIN(resume_size, OTA_IMAGE_HEADER_SIZE);
+    int read_err
+        = flash_area_read(thread_data->flash_ctx.flash_area, 0, ota_recv_buf, header_size);
+    if (read_err || (process_image_header(thread_data, 0, ota_recv_buf, header_size) != 0)) {
+        EDGEHOG_LOG_WRN("Unable to read the image header from the secondary slot");
+        return EDGEHOG_RESULT_FLASH_ERROR;
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PROGRESSIVE_ERASE
+    thread_data->erased_size = resume_size;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_SKIP_IDENTICAL_SECTORS
+    ota_sectors_start_compare(thread_data);
+#endif
+#else
+    size_t slot_size = thread_data->flash_ctx.flash_area->fa_size;
+    int err = ota_flash_erase(thread_data, resume_size, slot_size - resume_size);
+    if (err) {
+        EDGEHOG_LOG_ERR("Unable to erase the secondary slot from %zu: %d", resume_size, err);
+        return EDGEHOG_RESULT_OTA_ERASE_SECOND_SLOT_ERROR;
+    }
+#endif
+
+    int ret = ota_flash_advance_stream(thread_data, resume_size);
+    if (ret) {
+        EDGEHOG_LOG_ERR("Unable to resume the flash stream at %zu: %d", resume_size, ret);
+        return EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+    }
+    thread_data->received_size = resume_size;
+    return EDGEHOG_RESULT_OK;
+}
+#endif
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static int process_image_header(
+    ota_thread_data_t *thread_data, size_t offset, const uint8_t *data, size_t size)
+{
+    if (offset == 0) {
+        thread_data->header_valid = false;
+        thread_data->header_rejected = false;
+    }
+    if ((offset >= OTA_IMAGE_HEADER_SIZE) || (size == 0)) {
+        return 0;
+    }
+
+    size_t header_size = MIN(size, OTA_IMAGE_HEADER_SIZE - offset);
+    memcpy(thread_data->header_buf + offset, data, header_size);
+    if (offset + header_size < OTA_IMAGE_HEADER_SIZE) {
+        return 0;
+    }
+
+    thread_data->header_valid = (ota_image_parse_header(thread_data->header_buf,
+                                     OTA_IMAGE_HEADER_SIZE, &thread_data->image_header)
+        == EDGEHOG_RESULT_OK);
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VALIDATE_HEADER
+    if (!thread_data->header_valid || !is_image_header_acceptable(thread_data)) {
+        EDGEHOG_LOG_ERR("OTA image rejected from its header");
+        thread_data->header_rejected = true;
+        return -ENOEXEC;
+    }
+#endif
+    return 0;
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VALIDATE_HEADER
+static bool is_image_header_acceptable(const ota_thread_data_t *thread_data)
+{
+    const ota_image_header_t *header = &thread_data->image_header;
+    size_t hashed_size = ota_image_hashed_size(header);
+    if (hashed_size > thread_data->flash_ctx.flash_area->fa_size) {
+        EDGEHOG_LOG_ERR("OTA image of %zu bytes doesn't fit the secondary slot", hashed_size);
+        return false;
+    }
+    if ((thread_data->image_size > 0) && (hashed_size > thread_data->image_size)) {
+        EDGEHOG_LOG_ERR("OTA image header declares %zu bytes, the download has %zu", hashed_size,
+            thread_data->image_size);
+        return false;
+    }
+
+    ota_image_header_t running = { 0 };
+    if (ota_image_read_header(
+            ota_flash_get_image_running_area_id(thread_data->image_index), &running)
+        != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_WRN("Unable to read the running image header, skipping its comparison");
+        return true;
+    }
+    if ((header->load_addr != running.load_addr)
+        || ((header->flags & OTA_IMAGE_F_RAM_LOAD) != (running.flags & OTA_IMAGE_F_RAM_LOAD))) {
+        EDGEHOG_LOG_ERR("OTA image load address 0x%08x doesn't match the running one 0x%08x",
+            header->load_addr, running.load_addr);
+        return false;
+    }
+#ifdef OTA_SLOT_SELECTION
+    // MCUboot would keep booting the running image
+    if (ota_image_compare_versions(&header->version, &running.version) <= 0) {
+        EDGEHOG_LOG_ERR("OTA image version %u.%u.%u+%u is not newer than the running one",
+            header->version.major, header->version.minor, header->version.revision,
+            header->version.build_num);
+        return false;
+    }
+#elif defined(CONFIG_EDGEHOG_DEVICE_OTA_REJECT_SAME_VERSION)
+    if (ota_image_compare_versions(&header->version, &running.version) == 0) {
+        EDGEHOG_LOG_ERR("OTA image version %u.%u.%u+%u is already running", header->version.major,
+            header->version.minor, header->version.revision, header->version.build_num);
+        return false;
+    }
+#endif
+    return true;
+}
+#endif
+
+static inline int64_t start_erase_time(void)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STATS
+    return k_uptime_get();
+#else
+    return 0;
+#endif
+}
+
+static void account_erase_time(ota_thread_data_t *thread_data, int64_t start_ms)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STATS
+    thread_data->stats.erase_ms += k_uptime_get() - start_ms;
+#else
+    ARG_UNUSED(thread_data);
+    ARG_UNUSED(start_ms);
+#endif
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_VERIFY_HASH
+static int update_image_hash(ota_thread_data_t *thread_data, const uint8_t *data, size_t size)
+{
+    // The size of the hashed part is known once the header has been received
+    size_t hash_end = thread_data->header_valid
+        ? ota_image_hashed_size(&thread_data->image_header)
+        : OTA_IMAGE_HEADER_SIZE;
+    if (thread_data->hash_offset < hash_end) {
+        psa_status_t status = psa_hash_update(
+            &thread_data->hash_operation, data, MIN(size, hash_end - thread_data->hash_offset));
+        if (status != PSA_SUCCESS) {
+            EDGEHOG_LOG_ERR("psa_hash_update returned %d", status);
+            return -EIO;
+        }
+    }
+    thread_data->hash_offset += size;
+    return 0;
+}
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PROGRESSIVE_ERASE
+static int erase_image_ahead(ota_thread_data_t *thread_data, size_t end)
+{
+    const struct flash_area *flash_area = thread_data->flash_ctx.flash_area;
+    end = MIN(end, flash_area->fa_size);
+    if (end <= thread_data->erased_size) {
+        return 0;
+    }
+
+    // Erase up to the end of the page containing the last byte of the write
+    struct flash_pages_info page_info = { 0 };
+    int err = flash_get_page_info_by_offs(
+        flash_area_get_device(flash_area), (off_t) (flash_area->fa_off + end - 1), &page_info);
+    if (err) {
+        return err;
+    }
+    size_t erase_end = page_info.start_offset + page_info.size - flash_area->fa_off;
+    err = ota_flash_erase(
+        thread_data, thread_data->erased_size, erase_end - thread_data->erased_size);
+    if (err) {
+        return err;
+    }
+    thread_data->erased_size = erase_end;
+    return 0;
+}
+#endif
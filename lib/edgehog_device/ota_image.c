@@ -0,0 +1,213 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_image.h"
+
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_image, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define IMAGE_MAGIC 0x96f3b83dU
+#define IMAGE_TLV_INFO_MAGIC 0x6907U
+#define IMAGE_TLV_SHA256 0x10U
+
+#define HEADER_MAGIC_OFFSET 0
+#define HEADER_LOAD_ADDR_OFFSET 4
+#define HEADER_HDR_SIZE_OFFSET 8
+#define HEADER_PROTECT_TLV_SIZE_OFFSET 10
+#define HEADER_IMG_SIZE_OFFSET 12
+#define HEADER_FLAGS_OFFSET 16
+#define HEADER_VER_MAJOR_OFFSET 20
+#define HEADER_VER_MINOR_OFFSET 21
+#define HEADER_VER_REVISION_OFFSET 22
+#define HEADER_VER_BUILD_NUM_OFFSET 24
+
+/** @brief Size of the TLV area info and of each TLV header. */
+#define TLV_HEADER_SIZE 4
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Locate the unprotected TLV area of an image.
+ *
+ * @param[in] flash_area Flash area holding the image.
+ * @param[in] header Header of the image.
+ * @param[out] tlv_start Offset of the first TLV of the area.
+ * @param[out] tlv_end Offset of the end of the area, which is also the end of the image.
+ * @return EDGEHOG_RESULT_OK on success, EDGEHOG_RESULT_OTA_INVALID_IMAGE otherwise.
+ */
+static edgehog_result_t find_tlv_area(const struct flash_area *flash_area,
+    const ota_image_header_t *header, size_t *tlv_start, size_t *tlv_end);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+edgehog_result_t ota_image_parse_header(
+    const uint8_t *data, size_t size, ota_image_header_t *header)
+{
+    if (size < OTA_IMAGE_HEADER_SIZE) {
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+    if (sys_get_le32(data + HEADER_MAGIC_OFFSET) != IMAGE_MAGIC) {
+        EDGEHOG_LOG_ERR("Invalid MCUboot image magic 0x%08x", sys_get_le32(data));
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+    header->load_addr = sys_get_le32(data + HEADER_LOAD_ADDR_OFFSET);
+    header->hdr_size = sys_get_le16(data + HEADER_HDR_SIZE_OFFSET);
+    header->protect_tlv_size = sys_get_le16(data + HEADER_PROTECT_TLV_SIZE_OFFSET);
+    header->img_size = sys_get_le32(data + HEADER_IMG_SIZE_OFFSET);
+    header->flags = sys_get_le32(data + HEADER_FLAGS_OFFSET);
+    header->version.major = data[HEADER_VER_MAJOR_OFFSET];
+    header->version.minor = data[HEADER_VER_MINOR_OFFSET];
+    header->version.revision = sys_get_le16(data + HEADER_VER_REVISION_OFFSET);
+    header->version.build_num = sys_get_le32(data + HEADER_VER_BUILD_NUM_OFFSET);
+
+    if (header->hdr_size < OTA_IMAGE_HEADER_SIZE) {
+        EDGEHOG_LOG_ERR("Invalid MCUboot image header size %u", header->hdr_size);
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+    return EDGEHOG_RESULT_OK;
+}
+
+edgehog_result_t ota_image_read_header(uint8_t area_id, ota_image_header_t *header)
+{
+    const struct flash_area *flash_area = NULL;
+    int err = flash_area_open(area_id, &flash_area);
+    if (err) {
+        EDGEHOG_LOG_ERR("Unable to open flash area %u: %d", area_id, err);
+        return EDGEHOG_RESULT_FLASH_ERROR;
+    }
+
+    uint8_t data[OTA_IMAGE_HEADER_SIZE] = { 0 };
+    err = flash_area_read(flash_area, 0, data, sizeof(data));
+    flash_area_close(flash_area);
+    if (err) {
+        EDGEHOG_LOG_ERR("Unable to read the image header: %d", err);
+        return EDGEHOG_RESULT_FLASH_ERROR;
+    }
+
+    return ota_image_parse_header(data, sizeof(data), header);
+}
+
+size_t ota_image_hashed_size(const ota_image_header_t *header)
+{
+    return (size_t) header->hdr_size + header->img_size + header->protect_tlv_size;
+}
+
+int ota_image_compare_versions(
+    const struct mcuboot_img_sem_ver *a, const struct mcuboot_img_sem_ver *b)
+{
+    if (a->major != b->major) {
+        return (a->major > b->major) ? 1 : -1;
+    }
+    if (a->minor != b->minor) {
+        return (a->minor > b->minor) ? 1 : -1;
+    }
+    if (a->revision != b->revision) {
+        return (a->revision > b->revision) ? 1 : -1;
+    }
+    if (a->build_num != b->build_num) {
+        return (a->build_num > b->build_num) ? 1 : -1;
+    }
+    return 0;
+}
+
+edgehog_result_t ota_image_read_size(
+    uint8_t area_id, const ota_image_header_t *header, size_t *size)
+{
+    const struct flash_area *flash_area = NULL;
+    int err = flash_area_open(area_id, &flash_area);
+    if (err) {
+        EDGEHOG_LOG_ERR("Unable to open flash area %u: %d", area_id, err);
+        return EDGEHOG_RESULT_FLASH_ERROR;
+    }
+
+    size_t tlv_start = 0;
+    edgehog_result_t eres = find_tlv_area(flash_area, header, &tlv_start, size);
+    flash_area_close(flash_area);
+    return eres;
+}
+
+edgehog_result_t ota_image_read_hash(uint8_t area_id, const ota_image_header_t *header,
+    uint8_t hash[OTA_IMAGE_HASH_SIZE], bool *found)
+{
+    *found = false;
+
+    const struct flash_area *flash_area = NULL;
+    int err = flash_area_open(area_id, &flash_area);
+    if (err) {
+        EDGEHOG_LOG_ERR("Unable to open flash area %u: %d", area_id, err);
+        return EDGEHOG_RESULT_FLASH_ERROR;
+    }
+
+    size_t offset = 0;
+    size_t tlv_end = 0;
+    edgehog_result_t eres = find_tlv_area(flash_area, header, &offset, &tlv_end);
+    while ((eres == EDGEHOG_RESULT_OK) && (offset + TLV_HEADER_SIZE <= tlv_end)) {
+        uint8_t tlv[TLV_HEADER_SIZE] = { 0 };
+        if (flash_area_read(flash_area, (off_t) offset, tlv, sizeof(tlv)) != 0) {
+            eres = EDGEHOG_RESULT_FLASH_ERROR;
+            break;
+        }
+        uint16_t type = sys_get_le16(tlv);
+        uint16_t len = sys_get_le16(tlv + 2);
+        offset += TLV_HEADER_SIZE;
+        if (offset + len > tlv_end) {
+            EDGEHOG_LOG_ERR("MCUboot image TLV 0x%x exceeds the TLV area", type);
+            eres = EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+            break;
+        }
+        if ((type == IMAGE_TLV_SHA256) && (len == OTA_IMAGE_HASH_SIZE)) {
+            if (flash_area_read(flash_area, (off_t) offset, hash, OTA_IMAGE_HASH_SIZE) != 0) {
+                eres = EDGEHOG_RESULT_FLASH_ERROR;
+                break;
+            }
+            *found = true;
+            break;
+        }
+        offset += len;
+    }
+
+    flash_area_close(flash_area);
+    return eres;
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static edgehog_result_t find_tlv_area(const struct flash_area *flash_area,
+    const ota_image_header_t *header, size_t *tlv_start, size_t *tlv_end)
+{
+    // The unprotected TLV area follows the hashed part of the image, a body larger than the slot
+    // is rejected first as it could overflow the offset of the area
+    size_t offset = ota_image_hashed_size(header);
+    uint8_t info[TLV_HEADER_SIZE] = { 0 };
+    if ((header->img_size > flash_area->fa_size) || (offset + TLV_HEADER_SIZE > flash_area->fa_size)
+        || (flash_area_read(flash_area, (off_t) offset, info, sizeof(info)) != 0)
+        || (sys_get_le16(info) != IMAGE_TLV_INFO_MAGIC)) {
+        EDGEHOG_LOG_ERR("MCUboot image TLV area not found");
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+    // The total size of the TLV area includes its info header
+    *tlv_end = offset + sys_get_le16(info + 2);
+    if (*tlv_end > flash_area->fa_size) {
+        EDGEHOG_LOG_ERR("MCUboot image TLV area exceeds the slot");
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+    *tlv_start = offset + TLV_HEADER_SIZE;
+    return EDGEHOG_RESULT_OK;
+}
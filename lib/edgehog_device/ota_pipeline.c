@@ -0,0 +1,226 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_pipeline.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_pipeline, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define BUFFERS_COUNT CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE_BUFFERS
+#define BUFFER_SIZE CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE
+#define THREAD_STACK_SIZE CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE_STACK_SIZE
+#define THREAD_PRIORITY CONFIG_EDGEHOG_DEVICE_OTA_PIPELINE_THREAD_PRIORITY
+// The control entries (sync and stop) never wait for a free buffer
+#define ENTRIES_COUNT (BUFFERS_COUNT + 2)
+
+/** @brief Types of the entries queued to the writer thread. */
+typedef enum
+{
+    /** @brief A chunk of the image stored in a pipeline buffer. */
+    PIPELINE_ENTRY_DATA = 0,
+    /** @brief Signal the drain semaphore once all the previous entries have been processed. */
+    PIPELINE_ENTRY_SYNC,
+    /** @brief Terminate the writer thread. */
+    PIPELINE_ENTRY_STOP,
+} pipeline_entry_type_t;
+
+/** @brief Entry queued to the writer thread. */
+typedef struct
+{
+    /** @brief Type of the entry. */
+    pipeline_entry_type_t type;
+    /** @brief Index of the buffer holding the chunk data. */
+    uint8_t buffer_index;
+    /** @brief Chunk of the HTTP response, its data points to the pipeline buffer. */
+    edgehog_http_response_chunk_t response_chunk;
+} pipeline_entry_t;
+
+/** @brief Time spent waiting at each end of the pipeline. */
+typedef struct
+{
+    /** @brief Time the writer thread waited for data from the network. */
+    int64_t network_stall_ms;
+    /** @brief Time the receiving thread waited for a buffer to be written to flash. */
+    int64_t flash_stall_ms;
+    /** @brief Time the writer thread spent processing chunks. */
+    int64_t flash_busy_ms;
+    /** @brief Bytes processed by the writer thread. */
+    size_t bytes;
+} pipeline_stats_t;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static uint8_t pipeline_buffers[BUFFERS_COUNT][BUFFER_SIZE] __aligned(4);
+K_MSGQ_DEFINE(pipeline_free_msgq, sizeof(uint8_t), BUFFERS_COUNT, 1);
+K_MSGQ_DEFINE(pipeline_entries_msgq, sizeof(pipeline_entry_t), ENTRIES_COUNT, 4);
+K_SEM_DEFINE(pipeline_sync_sem, 0, 1);
+K_THREAD_STACK_DEFINE(pipeline_thread_stack, THREAD_STACK_SIZE);
+static struct k_thread pipeline_thread;
+static ota_pipeline_process_cbk_t pipeline_process_cbk;
+static void *pipeline_user_data;
+// Written by the writer thread only, read by the receiving thread
+static atomic_t pipeline_result;
+static pipeline_stats_t pipeline_stats;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Entry point of the writer thread.
+ *
+ * @param unused1 Unused parameter.
+ * @param unused2 Unused parameter.
+ * @param unused3 Unused parameter.
+ */
+static void pipeline_thread_entry(void *unused1, void *unused2, void *unused3);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+edgehog_result_t ota_pipeline_start(ota_pipeline_process_cbk_t process_cbk, void *user_data)
+{
+    if (!process_cbk) {
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    pipeline_process_cbk = process_cbk;
+    pipeline_user_data = user_data;
+    atomic_set(&pipeline_result, EDGEHOG_RESULT_OK);
+    memset(&pipeline_stats, 0, sizeof(pipeline_stats));
+
+    k_msgq_purge(&pipeline_free_msgq);
+    k_msgq_purge(&pipeline_entries_msgq);
+    k_sem_reset(&pipeline_sync_sem);
+    for (uint8_t i = 0; i < BUFFERS_COUNT; i++) {
+        k_msgq_put(&pipeline_free_msgq, &i, K_NO_WAIT);
+    }
+
+    k_tid_t thread_id = k_thread_create(&pipeline_thread, pipeline_thread_stack,
+        THREAD_STACK_SIZE, pipeline_thread_entry, NULL, NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+    if (!thread_id) {
+        EDGEHOG_LOG_ERR("OTA pipeline writer thread creation failed");
+        return EDGEHOG_RESULT_THREAD_CREATE_ERROR;
+    }
+#ifdef CONFIG_THREAD_NAME
+    k_thread_name_set(&pipeline_thread, "ota_writer");
+#endif
+
+    return EDGEHOG_RESULT_OK;
+}
+
+edgehog_result_t ota_pipeline_push(const edgehog_http_response_chunk_t *response_chunk)
+{
+    edgehog_result_t eres = (edgehog_result_t) atomic_get(&pipeline_result);
+    if (eres != EDGEHOG_RESULT_OK) {
+        return eres;
+    }
+    if (response_chunk->chunk_size > BUFFER_SIZE) {
+        EDGEHOG_LOG_ERR("Chunk of %zu bytes larger than the pipeline buffers",
+            response_chunk->chunk_size);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    uint8_t buffer_index = 0;
+    if (k_msgq_get(&pipeline_free_msgq, &buffer_index, K_NO_WAIT) != 0) {
+        // All the buffers are waiting for the flash, the socket is not read in the meantime
+        int64_t stall_start = k_uptime_get();
+        k_msgq_get(&pipeline_free_msgq, &buffer_index, K_FOREVER);
+        pipeline_stats.flash_stall_ms += k_uptime_get() - stall_start;
+    }
+
+    pipeline_entry_t entry = {
+        .type = PIPELINE_ENTRY_DATA,
+        .buffer_index = buffer_index,
+        .response_chunk = *response_chunk,
+    };
+    memcpy(pipeline_buffers[buffer_index], response_chunk->chunk_start_addr,
+        response_chunk->chunk_size);
+    entry.response_chunk.chunk_start_addr = pipeline_buffers[buffer_index];
+    k_msgq_put(&pipeline_entries_msgq, &entry, K_FOREVER);
+
+    return EDGEHOG_RESULT_OK;
+}
+
+edgehog_result_t ota_pipeline_drain(void)
+{
+    pipeline_entry_t entry = { .type = PIPELINE_ENTRY_SYNC };
+    k_msgq_put(&pipeline_entries_msgq, &entry, K_FOREVER);
+    k_sem_take(&pipeline_sync_sem, K_FOREVER);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_STATS
+    EDGEHOG_LOG_INF("OTA pipeline wrote %zu bytes in %lld ms, network stall %lld ms, flash stall "
+                    "%lld ms",
+        pipeline_stats.bytes, pipeline_stats.flash_busy_ms, pipeline_stats.network_stall_ms,
+        pipeline_stats.flash_stall_ms);
+#endif
+    memset(&pipeline_stats, 0, sizeof(pipeline_stats));
+
+    return (edgehog_result_t) atomic_set(&pipeline_result, EDGEHOG_RESULT_OK);
+}
+
+void ota_pipeline_stop(void)
+{
+    pipeline_entry_t entry = { .type = PIPELINE_ENTRY_STOP };
+    k_msgq_put(&pipeline_entries_msgq, &entry, K_FOREVER);
+    k_thread_join(&pipeline_thread, K_FOREVER);
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static void pipeline_thread_entry(void *unused1, void *unused2, void *unused3)
+{
+    ARG_UNUSED(unused1);
+    ARG_UNUSED(unused2);
+    ARG_UNUSED(unused3);
+
+    // The wait for the first chunk after a drain is not a network stall
+    bool idle = true;
+    pipeline_entry_t entry = { 0 };
+
+    while (true) {
+        int64_t wait_start = k_uptime_get();
+        k_msgq_get(&pipeline_entries_msgq, &entry, K_FOREVER);
+        if (!idle) {
+            pipeline_stats.network_stall_ms += k_uptime_get() - wait_start;
+        }
+
+        switch (entry.type) {
+            case PIPELINE_ENTRY_STOP:
+                return;
+            case PIPELINE_ENTRY_SYNC:
+                idle = true;
+                k_sem_give(&pipeline_sync_sem);
+                break;
+            case PIPELINE_ENTRY_DATA:
+                idle = false;
+                // After an error the remaining chunks are discarded, the error is reported
+                // to the receiving thread on its next push
+                if (atomic_get(&pipeline_result) == EDGEHOG_RESULT_OK) {
+                    int64_t busy_start = k_uptime_get();
+                    atomic_set(&pipeline_result,
+                        pipeline_process_cbk(&entry.response_chunk, pipeline_user_data));
+                    pipeline_stats.flash_busy_ms += k_uptime_get() - busy_start;
+                    pipeline_stats.bytes += entry.response_chunk.chunk_size;
+                }
+                k_msgq_put(&pipeline_free_msgq, &entry.buffer_index, K_NO_WAIT);
+                break;
+            default:
+                break;
+        }
+    }
+}
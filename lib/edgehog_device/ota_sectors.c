@@ -0,0 +1,170 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_sectors.h"
+
+#include "ota_flash.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/util.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_sectors, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define OTA_SECTOR_COMPARE_CHUNK_SIZE 64
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+// Sector of the image being received, compared with the secondary slot before writing it
+static uint8_t ota_sector_buf[CONFIG_EDGEHOG_DEVICE_OTA_SKIP_IDENTICAL_SECTOR_SIZE] __aligned(4);
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Write the content of the sector buffer unless the secondary slot already holds it.
+ *
+ * @param[inout] thread_data OTA thread data.
+ * @param[in] page_info Flash page the buffered data belongs to.
+ * @return 0 upon success, a negative error code otherwise.
+ */
+static int commit_image_sector(
+    ota_thread_data_t *thread_data, const struct flash_pages_info *page_info);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void ota_sectors_start_compare(ota_thread_data_t *thread_data)
+{
+    const struct flash_area *flash_area = thread_data->flash_ctx.flash_area;
+    const struct device *flash_dev = flash_area_get_device(flash_area);
+    size_t write_block_size = flash_get_write_block_size(flash_dev);
+    thread_data->sector_buf_size = 0;
+    thread_data->compare_sectors = true;
+
+    size_t offset = 0;
+    while (offset < flash_area->fa_size) {
+        struct flash_pages_info page_info = { 0 };
+        if ((flash_get_page_info_by_offs(
+                 flash_dev, (off_t) (flash_area->fa_off + offset), &page_info)
+                != 0)
+            || (page_info.size > sizeof(ota_sector_buf))) {
+            EDGEHOG_LOG_WRN("Flash pages larger than the sector buffer, writing all of them");
+            thread_data->compare_sectors = false;
+            return;
+        }
+        // The last sector of the image is padded to the write block size within its page
+        if ((page_info.size % write_block_size) != 0) {
+            EDGEHOG_LOG_WRN("Flash pages not a multiple of the write block size, writing all "
+                            "of them");
+            thread_data->compare_sectors = false;
+            return;
+        }
+        offset = page_info.start_offset + page_info.size - flash_area->fa_off;
+    }
+}
+
+int ota_sectors_write(ota_thread_data_t *thread_data, const uint8_t *data, size_t size, bool flush)
+{
+    const struct flash_area *flash_area = thread_data->flash_ctx.flash_area;
+    struct stream_flash_ctx *stream = &thread_data->flash_ctx.stream;
+    if (stream->bytes_written + thread_data->sector_buf_size + size > stream->available) {
+        return -ENOMEM;
+    }
+
+    while ((size > 0) || (flush && (thread_data->sector_buf_size > 0))) {
+        // The buffer holds the data following the bytes already written, up to the page end
+        struct flash_pages_info page_info = { 0 };
+        int err = flash_get_page_info_by_offs(flash_area_get_device(flash_area),
+            (off_t) (flash_area->fa_off + stream->bytes_written), &page_info);
+        if (err) {
+            return err;
+        }
+        size_t sector_size
+            = page_info.start_offset + page_info.size - flash_area->fa_off - stream->bytes_written;
+
+        size_t copy_size = MIN(size, sector_size - thread_data->sector_buf_size);
+        if (copy_size > 0) {
+            memcpy(ota_sector_buf + thread_data->sector_buf_size, data, copy_size);
+            thread_data->sector_buf_size += copy_size;
+            data += copy_size;
+            size -= copy_size;
+        }
+        if ((thread_data->sector_buf_size < sector_size) && !flush) {
+            return 0;
+        }
+
+        err = commit_image_sector(thread_data, &page_info);
+        if (err) {
+            return err;
+        }
+    }
+    return 0;
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static int commit_image_sector(
+    ota_thread_data_t *thread_data, const struct flash_pages_info *page_info)
+{
+    const struct flash_area *flash_area = thread_data->flash_ctx.flash_area;
+    struct stream_flash_ctx *stream = &thread_data->flash_ctx.stream;
+    size_t offset = stream->bytes_written;
+    size_t length = thread_data->sector_buf_size;
+
+    bool identical = true;
+    uint8_t flash_data[OTA_SECTOR_COMPARE_CHUNK_SIZE] = { 0 };
+    for (size_t i = 0; identical && (i < length); i += sizeof(flash_data)) {
+        size_t read_size = MIN(sizeof(flash_data), length - i);
+        int err = flash_area_read(flash_area, (off_t) (offset + i), flash_data, read_size);
+        if (err) {
+            return err;
+        }
+        identical = (memcmp(flash_data, ota_sector_buf + i, read_size) == 0);
+    }
+
+    size_t page_start = page_info->start_offset - flash_area->fa_off;
+    size_t page_end = page_start + page_info->size;
+    if (identical) {
+        thread_data->sectors_skipped++;
+    } else {
+        // Pages erased earlier in this download only need to be programmed
+        if (page_start >= thread_data->erased_size) {
+            int err = ota_flash_erase(thread_data, page_start, page_info->size);
+            if (err) {
+                return err;
+            }
+        }
+        // The last sector of the image is padded to the write block size
+        size_t write_size = ROUND_UP(length, flash_get_write_block_size(stream->fdev));
+        memset(ota_sector_buf + length, flash_area_erased_val(flash_area), write_size - length);
+        int err = flash_area_write(flash_area, (off_t) offset, ota_sector_buf, write_size);
+        if (err) {
+            return err;
+        }
+        thread_data->sectors_written++;
+    }
+
+    int err = ota_flash_advance_stream(thread_data, length);
+    if (err) {
+        return err;
+    }
+    thread_data->erased_size = MAX(thread_data->erased_size, page_end);
+    thread_data->sector_buf_size = 0;
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ota_slot_reuse.h"
+
+#include "http.h"
+#include "ota_flash.h"
+
+#include <string.h>
+
+#include <zephyr/sys/util.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_slot_reuse, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define OTA_REQ_TIMEOUT_MS (60 * 1000)
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+bool ota_slot_reuse_is_image_present(
+    ota_thread_data_t *thread_data, const ota_slot_record_t *record, uint32_t url_hash)
+{
+    if ((record->url_hash != url_hash) || (record->etag[0] == '\0')) {
+        return false;
+    }
+
+    // The image behind the URL could have changed, ask the server without downloading it
+    const char *header_fields[] = { 0 };
+    char etag[OTA_ETAG_SIZE] = { 0 };
+    edgehog_http_get_data_t http_head_data = { .url = thread_data->ota_request.download_url,
+        .timeout_ms = OTA_REQ_TIMEOUT_MS,
+        .header_fields = header_fields,
+        .etag = etag,
+        .etag_size = sizeof(etag) };
+    if ((edgehog_http_head(&http_head_data) != EDGEHOG_RESULT_OK)
+        || (strcmp(etag, record->etag) != 0)) {
+        return false;
+    }
+
+    ota_image_header_t header = { 0 };
+    uint8_t slot_hash[OTA_IMAGE_HASH_SIZE] = { 0 };
+    bool found = false;
+    size_t image_size = 0;
+    size_t trailer_start = 0;
+    uint8_t area_id = thread_data->flash_ctx.flash_area->fa_id;
+    if ((ota_image_read_header(area_id, &header) != EDGEHOG_RESULT_OK)
+        || (ota_image_read_hash(area_id, &header, slot_hash, &found) != EDGEHOG_RESULT_OK)
+        || !found || (memcmp(slot_hash, record->image_hash, sizeof(slot_hash)) != 0)
+        || (ota_image_read_size(area_id, &header, &image_size) != EDGEHOG_RESULT_OK)
+        || (ota_flash_get_trailer_start(thread_data->flash_ctx.flash_area, &trailer_start) != 0)
+        || (image_size > trailer_start)) {
+        return false;
+    }
+
+    // The slot could have been partially overwritten since the image was stored
+    if ((ota_flash_hash_slot(thread_data, ota_image_hashed_size(&header)) != EDGEHOG_RESULT_OK)
+        || (ota_flash_verify_hash(thread_data) != EDGEHOG_RESULT_OK)) {
+        return false;
+    }
+
+    // A previous upgrade attempt could have left the trailer in any state
+    if (ota_flash_erase_trailer(thread_data->flash_ctx.flash_area) != 0) {
+        EDGEHOG_LOG_ERR("Unable to erase the secondary slot trailer");
+        return false;
+    }
+    return true;
+}
+
+bool ota_slot_reuse_get_record(
+    const ota_thread_data_t *thread_data, uint32_t url_hash, ota_slot_record_t *record)
+{
+    // The flash image context only refers to the last image of a bundle
+    if (ota_flash_get_images(thread_data) != BIT(0)) {
+        return false;
+    }
+    if (thread_data->etag[0] == '\0') {
+        EDGEHOG_LOG_DBG("No ETag for the OTA image, it won't be reused");
+        return false;
+    }
+
+    memset(record, 0, sizeof(ota_slot_record_t));
+    record->url_hash = url_hash;
+    strncpy(record->etag, thread_data->etag, sizeof(record->etag) - 1);
+    bool found = false;
+    return (ota_image_read_hash(thread_data->flash_ctx.flash_area->fa_id,
+                &thread_data->image_header, record->image_hash, &found)
+               == EDGEHOG_RESULT_OK)
+        && found;
+}
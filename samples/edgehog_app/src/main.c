@@ -78,6 +78,10 @@ static struct k_thread zbus_thread_data;
 #define EDGEHOG_OTA_OBSERVER_NOTIFY_PRIORITY 5
 ZBUS_SUBSCRIBER_DEFINE(edgehog_ota_subscriber, EDGEHOG_OTA_SUBSCRIBER_NOTIFICATION_QUEUE_SIZE);
 ZBUS_CHAN_ADD_OBS(edgehog_ota_chan, edgehog_ota_subscriber, EDGEHOG_OTA_OBSERVER_NOTIFY_PRIORITY);
+#if CONFIG_SAMPLE_OTA_ACTIVATION_DELAY_SECONDS >= 0
+static bool ota_activation_pending;
+static k_timepoint_t ota_activation_timepoint;
+#endif
 #endif
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 
@@ -115,6 +119,12 @@ static void zbus_thread_entry_point(void *arg1, void *arg2, void *arg3);
  * is also used for reading the message.
  */
 static void edgehog_listen_zbus_channel(k_timeout_t timeout);
+#if CONFIG_SAMPLE_OTA_ACTIVATION_DELAY_SECONDS >= 0
+/**
+ * @brief Activate the staged OTA image once the activation delay has elapsed.
+ */
+static void activate_staged_ota(void);
+#endif
 #endif
 
 /************************************************
@@ -351,6 +361,9 @@ static void zbus_thread_entry_point(void *arg1, void *arg2, void *arg3)
 
     while (!atomic_test_bit(&device_threads_flags, DEVICE_THREADS_FLAGS_TERMINATION)) {
         edgehog_listen_zbus_channel(K_MSEC(ZBUS_PERIOD_MS));
+#if CONFIG_SAMPLE_OTA_ACTIVATION_DELAY_SECONDS >= 0
+        activate_staged_ota();
+#endif
     }
 }
 #endif
@@ -366,12 +379,13 @@ static void edgehog_listen_zbus_channel(k_timeout_t timeout)
             case EDGEHOG_OTA_INIT_EVENT:
                 LOG_WRN("To subscriber -> EDGEHOG_OTA_INIT_EVENT"); // NOLINT
                 break;
-            case EDGEHOG_OTA_PENDING_REBOOT_EVENT:
+            case EDGEHOG_OTA_PENDING_REBOOT_EVENT: {
                 LOG_WRN("To subscriber -> EDGEHOG_OTA_PENDING_REBOOT_EVENT"); // NOLINT
                 edgehog_ota_chan_event_t ota_chan_event
                     = { .event = EDGEHOG_OTA_CONFIRM_REBOOT_EVENT };
                 zbus_chan_pub(&edgehog_ota_chan, &ota_chan_event, K_SECONDS(1));
                 break;
+            }
             case EDGEHOG_OTA_CONFIRM_REBOOT_EVENT:
                 LOG_WRN("To subscriber -> EDGEHOG_OTA_CONFIRM_REBOOT_EVENT"); // NOLINT
                 break;
@@ -381,9 +395,39 @@ static void edgehog_listen_zbus_channel(k_timeout_t timeout)
             case EDGEHOG_OTA_SUCCESS_EVENT:
                 LOG_WRN("To subscriber -> EDGEHOG_OTA_SUCCESS_EVENT"); // NOLINT
                 break;
+            case EDGEHOG_OTA_STAGED_EVENT:
+                LOG_WRN("To subscriber -> EDGEHOG_OTA_STAGED_EVENT"); // NOLINT
+#if CONFIG_SAMPLE_OTA_ACTIVATION_DELAY_SECONDS >= 0
+                // The delay stands in for the condition a real application would wait for before
+                // rebooting into the new image, such as a user confirmation or an idle period.
+                LOG_INF("Activating the staged OTA image in %d s", // NOLINT
+                    CONFIG_SAMPLE_OTA_ACTIVATION_DELAY_SECONDS);
+                ota_activation_timepoint
+                    = sys_timepoint_calc(K_SECONDS(CONFIG_SAMPLE_OTA_ACTIVATION_DELAY_SECONDS));
+                ota_activation_pending = true;
+#endif
+                break;
+            case EDGEHOG_OTA_ACTIVATE_EVENT:
+                LOG_WRN("To subscriber -> EDGEHOG_OTA_ACTIVATE_EVENT"); // NOLINT
+                break;
             default:
                 LOG_WRN("To subscriber -> EDGEHOG_OTA_INVALID_EVENT"); // NOLINT
         }
     }
 }
 #endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT
+#if CONFIG_SAMPLE_OTA_ACTIVATION_DELAY_SECONDS >= 0
+static void activate_staged_ota(void)
+{
+    if (!ota_activation_pending || !sys_timepoint_expired(ota_activation_timepoint)) {
+        return;
+    }
+    ota_activation_pending = false;
+    LOG_INF("Activating the staged OTA image"); // NOLINT
+    edgehog_ota_chan_event_t activate_event = { .event = EDGEHOG_OTA_ACTIVATE_EVENT };
+    zbus_chan_pub(&edgehog_ota_chan, &activate_event, K_SECONDS(1));
+}
+#endif
+#endif
@@ -0,0 +1,110 @@
+# (C) Copyright 2026, SECO Mind Srl
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Generate a delta OTA patch between two signed MCUboot images.
+
+The patch format is the one applied by lib/edgehog_device/ota_delta.c. The patch mostly contains
+zeroed diff bytes, compress it with `lz4 -B4 --content-size` before serving it.
+"""
+
+import argparse
+import hashlib
+import struct
+
+MAGIC = 0x50444845
+# Length of the windows used to find matches between the two images
+WINDOW = 16
+# Stride of the indexed source windows
+STRIDE = 4
+# Mismatching bytes tolerated in the last WINDOW bytes while extending a match
+MAX_MISMATCHES = WINDOW // 2
+
+
+def index_source(source):
+    """Index the source windows by content."""
+    index = {}
+    for offset in range(0, len(source) - WINDOW + 1, STRIDE):
+        index.setdefault(source[offset : offset + WINDOW], offset)
+    return index
+
+
+def find_match(source, target, index, start):
+    """Find the next match of the target in the source, starting at a target offset."""
+    for target_offset in range(start, len(target) - WINDOW + 1):
+        source_offset = index.get(target[target_offset : target_offset + WINDOW])
+        if source_offset is not None:
+            return source_offset, target_offset
+    return None
+
+
+def extend_match(source, target, source_offset, target_offset):
+    """Extend a match forward, tolerating sparse mismatches as bsdiff does."""
+    length = 0
+    last_equal = 0
+    mismatches = []
+    while (source_offset + length < len(source)) and (target_offset + length < len(target)):
+        if source[source_offset + length] != target[target_offset + length]:
+            mismatches.append(length)
+            mismatches = [m for m in mismatches if m > length - WINDOW]
+            if len(mismatches) > MAX_MISMATCHES:
+                break
+        else:
+            last_equal = length + 1
+        length += 1
+    return last_equal
+
+
+def record(source, target, source_offset, target_offset, diff_len, extra_end, seek):
+    """Encode a patch record."""
+    diff = bytes(
+        (target[target_offset + i] - source[source_offset + i]) & 0xFF for i in range(diff_len)
+    )
+    extra = target[target_offset + diff_len : extra_end]
+    return struct.pack("<IIi", diff_len, len(extra), seek) + diff + extra
+
+
+def generate(source, target):
+    """Generate the patch reconstructing target from source."""
+    header = struct.pack("<IIII", MAGIC, len(source), len(target), 0)
+    header += hashlib.sha256(source).digest() + hashlib.sha256(target).digest()
+
+    patch = [header]
+    index = index_source(source)
+    match = find_match(source, target, index, 0)
+    # Leading bytes without a match are sent as extra bytes of an empty diff
+    first = match[1] if match else len(target)
+    seek = match[0] if match else 0
+    patch.append(record(source, target, 0, 0, 0, first, seek))
+
+    while match:
+        source_offset, target_offset = match
+        diff_len = extend_match(source, target, source_offset, target_offset)
+        match = find_match(source, target, index, target_offset + diff_len)
+        extra_end = match[1] if match else len(target)
+        seek = (match[0] - (source_offset + diff_len)) if match else 0
+        patch.append(
+            record(source, target, source_offset, target_offset, diff_len, extra_end, seek)
+        )
+
+    return b"".join(patch)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("source", help="signed image running on the devices")
+    parser.add_argument("target", help="new signed image")
+    parser.add_argument("patch", help="output patch")
+    args = parser.parse_args()
+
+    with open(args.source, "rb") as source_file, open(args.target, "rb") as target_file:
+        source = source_file.read()
+        target = target_file.read()
+    patch = generate(source, target)
+    with open(args.patch, "wb") as patch_file:
+        patch_file.write(patch)
+    print(f"Patch of {len(patch)} bytes for a target of {len(target)} bytes")
+
+
+if __name__ == "__main__":
+    main()
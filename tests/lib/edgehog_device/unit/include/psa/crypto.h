@@ -0,0 +1,71 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FAKE_PSA_CRYPTO_H
+#define FAKE_PSA_CRYPTO_H
+
+/**
+ * @file psa/crypto.h
+ * @brief Fake of the PSA hash API for the unit tests.
+ *
+ * @details No crypto library is available on the unit_testing platform. The fake operation keeps
+ * the hashed data, and a verification succeeds when the data is the content registered for the
+ * expected digest with fake_psa_register_digest().
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum amount of data held by a fake hash operation. */
+#define FAKE_PSA_HASH_DATA_SIZE 1024
+
+#define PSA_SUCCESS ((psa_status_t) 0)
+#define PSA_ERROR_GENERIC_ERROR ((psa_status_t) -132)
+#define PSA_ERROR_INSUFFICIENT_MEMORY ((psa_status_t) -141)
+#define PSA_ERROR_INVALID_SIGNATURE ((psa_status_t) -149)
+#define PSA_ALG_SHA_256 ((psa_algorithm_t) 0x02000009)
+
+typedef int32_t psa_status_t;
+typedef uint32_t psa_algorithm_t;
+
+/** @brief Fake hash operation, holding the hashed data. */
+typedef struct
+{
+    /** @brief Data passed to the operation. */
+    uint8_t data[FAKE_PSA_HASH_DATA_SIZE];
+    /** @brief Bytes held in the data buffer. */
+    size_t size;
+} psa_hash_operation_t;
+
+/**
+ * @brief Register the content a digest is computed from.
+ *
+ * @param[in] digest Digest, as stored by the code under test.
+ * @param[in] digest_size Size of the digest.
+ * @param[in] data Content the digest is computed from.
+ * @param[in] size Size of the content.
+ */
+void fake_psa_register_digest(
+    const uint8_t *digest, size_t digest_size, const uint8_t *data, size_t size);
+
+psa_status_t psa_crypto_init(void);
+psa_hash_operation_t psa_hash_operation_init(void);
+psa_status_t psa_hash_setup(psa_hash_operation_t *operation, psa_algorithm_t alg);
+psa_status_t psa_hash_update(psa_hash_operation_t *operation, const uint8_t *input, size_t len);
+psa_status_t psa_hash_verify(
+    psa_hash_operation_t *operation, const uint8_t *hash, size_t hash_length);
+psa_status_t psa_hash_abort(psa_hash_operation_t *operation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_PSA_CRYPTO_H
@@ -0,0 +1,52 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FAKE_FLASH_H
+#define FAKE_FLASH_H
+
+/**
+ * @file zephyr/drivers/flash.h
+ * @brief Fake of the flash driver API for the unit tests.
+ *
+ * @details The flash device is split in pages of the size set with fake_flash_set_page_size().
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct device;
+
+/** @brief Flash page, only the fields used by the code under test. */
+struct flash_pages_info
+{
+    /** @brief Offset of the page in the flash device. */
+    off_t start_offset;
+    /** @brief Size of the page. */
+    size_t size;
+    /** @brief Index of the page. */
+    uint32_t index;
+};
+
+/**
+ * @brief Set the size of the pages of the fake flash device.
+ *
+ * @param[in] page_size Size of the pages.
+ */
+void fake_flash_set_page_size(size_t page_size);
+
+int flash_get_page_info_by_offs(
+    const struct device *dev, off_t offset, struct flash_pages_info *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_FLASH_H
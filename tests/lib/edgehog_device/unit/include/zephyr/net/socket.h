@@ -0,0 +1,85 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FAKE_SOCKET_H
+#define FAKE_SOCKET_H
+
+/**
+ * @file zephyr/net/socket.h
+ * @brief Fake of the socket API for the unit tests.
+ *
+ * @details The unit_testing platform has no network stack. The data sent on any socket is
+ * collected in a single buffer, the closed sockets are recorded and a socket polls readable once
+ * marked with fake_socket_set_readable().
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum amount of data collected from the sends. */
+#define FAKE_SOCKET_SENT_SIZE 512
+/** @brief Maximum number of closed sockets recorded. */
+#define FAKE_SOCKET_CLOSED_MAX 8
+
+#define ZSOCK_POLLIN 1
+
+/** @brief Poll descriptor, only the fields used by the code under test. */
+struct zsock_pollfd
+{
+    /** @brief Polled socket. */
+    int fd;
+    /** @brief Requested events. */
+    short events;
+    /** @brief Returned events. */
+    short revents;
+};
+
+/**
+ * @brief Reset the fake sockets.
+ *
+ * @param[in] max_send_size Maximum number of bytes accepted by a single send.
+ * @param[in] fail_after Number of bytes after which the sends fail, SIZE_MAX to never fail.
+ */
+void fake_socket_reset(size_t max_send_size, size_t fail_after);
+
+/**
+ * @brief Get the data sent so far.
+ *
+ * @param[out] size Number of bytes sent.
+ * @return The sent data.
+ */
+const uint8_t *fake_socket_sent(size_t *size);
+
+/**
+ * @brief Check if a socket has been closed.
+ *
+ * @param[in] sock The socket.
+ * @return true if the socket has been closed since the last reset.
+ */
+bool fake_socket_is_closed(int sock);
+
+/**
+ * @brief Mark a socket as readable, as when closed by the peer.
+ *
+ * @param[in] sock The socket.
+ */
+void fake_socket_set_readable(int sock);
+
+ssize_t zsock_send(int sock, const void *buf, size_t len, int flags);
+int zsock_close(int sock);
+int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_SOCKET_H
@@ -0,0 +1,64 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FAKE_FLASH_MAP_H
+#define FAKE_FLASH_MAP_H
+
+/**
+ * @file zephyr/storage/flash_map.h
+ * @brief Fake of the flash map API for the unit tests.
+ *
+ * @details The unit_testing platform has no devicetree nor flash driver. A single flash area is
+ * available, backed by the buffer set with fake_flash_area_set().
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct device;
+
+/** @brief Flash area, only the fields used by the code under test. */
+struct flash_area
+{
+    /** @brief ID of the area. */
+    uint8_t fa_id;
+    /** @brief Offset of the area in the flash device. */
+    off_t fa_off;
+    /** @brief Size of the area. */
+    size_t fa_size;
+};
+
+/**
+ * @brief Set the content of the fake flash area.
+ *
+ * @param[in] id ID of the area.
+ * @param[in] data Content of the area, must outlive its use.
+ * @param[in] size Size of the area.
+ */
+void fake_flash_area_set(uint8_t id, const uint8_t *data, size_t size);
+
+/**
+ * @brief Set the offset of the fake flash area in the flash device.
+ *
+ * @param[in] offset Offset of the area, zero unless set.
+ */
+void fake_flash_area_set_offset(off_t offset);
+
+int flash_area_open(uint8_t id, const struct flash_area **fa);
+void flash_area_close(const struct flash_area *fa);
+int flash_area_read(const struct flash_area *fa, off_t off, void *dst, size_t len);
+const struct device *flash_area_get_device(const struct flash_area *fa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_FLASH_MAP_H
@@ -0,0 +1,92 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/unit/src/fake_flash_map.c
+ *
+ * @details Fake of the flash map and flash driver APIs, shared by the unit tests of the OTA.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/util.h>
+
+/************************************************
+ *       Global variables definition            *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static struct flash_area fake_area;
+static const uint8_t *fake_area_data;
+static size_t fake_page_size;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *                     Fakes                    *
+ ***********************************************/
+
+void fake_flash_area_set(uint8_t id, const uint8_t *data, size_t size)
+{
+    fake_area.fa_id = id;
+    fake_area.fa_off = 0;
+    fake_area.fa_size = size;
+    fake_area_data = data;
+}
+
+void fake_flash_area_set_offset(off_t offset)
+{
+    fake_area.fa_off = offset;
+}
+
+void fake_flash_set_page_size(size_t page_size)
+{
+    fake_page_size = page_size;
+}
+
+int flash_area_open(uint8_t id, const struct flash_area **fa)
+{
+    if (!fake_area_data || (id != fake_area.fa_id)) {
+        return -ENOENT;
+    }
+    *fa = &fake_area;
+    return 0;
+}
+
+void flash_area_close(const struct flash_area *fa)
+{
+    ARG_UNUSED(fa);
+}
+
+int flash_area_read(const struct flash_area *fa, off_t off, void *dst, size_t len)
+{
+    if ((off < 0) || ((size_t) off + len > fa->fa_size)) {
+        return -EINVAL;
+    }
+    memcpy(dst, fake_area_data + off, len);
+    return 0;
+}
+
+const struct device *flash_area_get_device(const struct flash_area *fa)
+{
+    ARG_UNUSED(fa);
+    return NULL;
+}
+
+int flash_get_page_info_by_offs(
+    const struct device *dev, off_t offset, struct flash_pages_info *info)
+{
+    ARG_UNUSED(dev);
+    if ((fake_page_size == 0) || (offset < 0)) {
+        return -EINVAL;
+    }
+    info->index = (uint32_t) ((size_t) offset / fake_page_size);
+    info->start_offset = (off_t) (info->index * fake_page_size);
+    info->size = fake_page_size;
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/unit/src/fake_socket.c
+ *
+ * @details Fake of the socket API, shared by the unit tests of the HTTP client.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/util.h>
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/** @brief State of the fake sockets. */
+typedef struct
+{
+    /** @brief Data sent on any socket. */
+    uint8_t sent[FAKE_SOCKET_SENT_SIZE];
+    /** @brief Number of bytes sent. */
+    size_t sent_size;
+    /** @brief Maximum number of bytes accepted by a single send. */
+    size_t max_send_size;
+    /** @brief Number of bytes after which the sends fail. */
+    size_t fail_after;
+    /** @brief Closed sockets. */
+    int closed[FAKE_SOCKET_CLOSED_MAX];
+    /** @brief Number of closed sockets. */
+    size_t closed_count;
+    /** @brief Socket polling readable, -1 if none. */
+    int readable;
+} fake_socket_state_t;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static fake_socket_state_t fake_socket;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *                     Fakes                    *
+ ***********************************************/
+
+void fake_socket_reset(size_t max_send_size, size_t fail_after)
+{
+    memset(&fake_socket, 0, sizeof(fake_socket));
+    fake_socket.max_send_size = max_send_size;
+    fake_socket.fail_after = fail_after;
+    fake_socket.readable = -1;
+}
+
+const uint8_t *fake_socket_sent(size_t *size)
+{
+    *size = fake_socket.sent_size;
+    return fake_socket.sent;
+}
+
+bool fake_socket_is_closed(int sock)
+{
+    for (size_t i = 0; i < fake_socket.closed_count; i++) {
+        if (fake_socket.closed[i] == sock) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void fake_socket_set_readable(int sock)
+{
+    fake_socket.readable = sock;
+}
+
+ssize_t zsock_send(int sock, const void *buf, size_t len, int flags)
+{
+    ARG_UNUSED(sock);
+    ARG_UNUSED(flags);
+
+    if (fake_socket.sent_size >= fake_socket.fail_after) {
+        errno = ECONNRESET;
+        return -1;
+    }
+    size_t size = MIN(len, fake_socket.max_send_size);
+    size = MIN(size, fake_socket.fail_after - fake_socket.sent_size);
+    size = MIN(size, sizeof(fake_socket.sent) - fake_socket.sent_size);
+    if (size == 0) {
+        errno = ENOMEM;
+        return -1;
+    }
+    memcpy(&fake_socket.sent[fake_socket.sent_size], buf, size);
+    fake_socket.sent_size += size;
+    return (ssize_t) size;
+}
+
+int zsock_close(int sock)
+{
+    if (fake_socket.closed_count < ARRAY_SIZE(fake_socket.closed)) {
+        fake_socket.closed[fake_socket.closed_count++] = sock;
+    }
+    return 0;
+}
+
+int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout)
+{
+    ARG_UNUSED(timeout);
+
+    int ready = 0;
+    for (int i = 0; i < nfds; i++) {
+        fds[i].revents = 0;
+        if ((fds[i].fd == fake_socket.readable) && (fds[i].events & ZSOCK_POLLIN)) {
+            fds[i].revents = ZSOCK_POLLIN;
+            ready++;
+        }
+    }
+    return ready;
+}
@@ -0,0 +1,171 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/unit/src/ft_scheduler_test.c
+ *
+ * @details Unit tests of the scheduling of the file transfer requests waiting for a worker.
+ */
+
+#include <string.h>
+
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+#include "file_transfer/scheduler.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define AGING_MS CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PRIORITY_AGING_MS
+#define MAX_REQUESTS 4
+
+/** @brief Requests waiting for a worker. */
+typedef struct
+{
+    /** @brief Scheduling information of the requests. */
+    edgehog_ft_sched_entry_t entries[MAX_REQUESTS];
+    /** @brief Set for the requests whose target is busy. */
+    bool blocked[MAX_REQUESTS];
+    /** @brief Number of requests. */
+    size_t count;
+} requests_t;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static requests_t requests;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Scheduling callback returning the test requests.
+ */
+static bool get_entry(size_t index, void *user_data, edgehog_ft_sched_entry_t *entry);
+
+/**
+ * @brief Add a request to the test requests.
+ *
+ * @param[in] priority Priority of the request.
+ * @param[in] enqueued_ms Uptime at which the request has been queued.
+ */
+static void add_request(enum edgehog_ft_priority priority, int64_t enqueued_ms);
+
+/**
+ * @brief Select a request among the test requests.
+ *
+ * @param[in] now_ms Current uptime.
+ * @return Index of the selected request.
+ */
+static size_t select_at(int64_t now_ms);
+
+/************************************************
+ *                     Tests                    *
+ ***********************************************/
+
+static void ft_scheduler_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    memset(&requests, 0, sizeof(requests));
+}
+
+ZTEST(ft_scheduler, test_ft_scheduler_empty)
+{
+    zassert_equal(select_at(0), 0);
+}
+
+ZTEST(ft_scheduler, test_ft_scheduler_priority)
+{
+    add_request(EDGEHOG_FT_PRIORITY_LOW, 0);
+    add_request(EDGEHOG_FT_PRIORITY_HIGH, 10);
+    add_request(EDGEHOG_FT_PRIORITY_NORMAL, 20);
+    zassert_equal(select_at(30), 1);
+}
+
+ZTEST(ft_scheduler, test_ft_scheduler_blocked)
+{
+    add_request(EDGEHOG_FT_PRIORITY_HIGH, 0);
+    add_request(EDGEHOG_FT_PRIORITY_LOW, 10);
+    requests.blocked[0] = true;
+    zassert_equal(select_at(20), 1);
+
+    requests.blocked[1] = true;
+    zassert_equal(select_at(20), requests.count);
+}
+
+ZTEST(ft_scheduler, test_ft_scheduler_aging)
+{
+    add_request(EDGEHOG_FT_PRIORITY_LOW, 0);
+    add_request(EDGEHOG_FT_PRIORITY_NORMAL, 10);
+    zassert_equal(select_at(AGING_MS - 1), 1);
+    // One aging period raises the low priority request to normal, it was queued first
+    zassert_equal(select_at(AGING_MS), 0);
+    // After one aging period of its own the normal request is ahead again
+    zassert_equal(select_at(AGING_MS + 10), 1);
+}
+
+ZTEST(ft_scheduler, test_ft_scheduler_ties)
+{
+    // Pending order doesn't follow the enqueue time, as several workers fill it
+    add_request(EDGEHOG_FT_PRIORITY_NORMAL, 30);
+    add_request(EDGEHOG_FT_PRIORITY_NORMAL, 10);
+    add_request(EDGEHOG_FT_PRIORITY_NORMAL, 20);
+    zassert_equal(select_at(40), 1);
+
+    // A tie between aged priorities also goes to the earliest request
+    memset(&requests, 0, sizeof(requests));
+    add_request(EDGEHOG_FT_PRIORITY_HIGH, AGING_MS);
+    add_request(EDGEHOG_FT_PRIORITY_NORMAL, 0);
+    zassert_equal(select_at(AGING_MS), 1);
+}
+
+ZTEST(ft_scheduler, test_ft_scheduler_starvation)
+{
+    // A low priority request competing with a stream of new high priority ones
+    add_request(EDGEHOG_FT_PRIORITY_LOW, 0);
+    add_request(EDGEHOG_FT_PRIORITY_HIGH, 0);
+
+    int64_t now_ms = 0;
+    size_t dispatched = 0;
+    while (select_at(now_ms) != 0) {
+        zassert_true(now_ms <= (2 * AGING_MS), "Low priority request starved");
+        // The high priority request is dispatched and replaced by a new one
+        now_ms += AGING_MS / 4;
+        requests.entries[1].enqueued_ms = now_ms;
+        dispatched++;
+    }
+    zassert_equal(now_ms, 2 * AGING_MS);
+    zassert_equal(dispatched, 8);
+}
+
+ZTEST_SUITE(ft_scheduler, NULL, NULL, ft_scheduler_before, NULL, NULL);
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static bool get_entry(size_t index, void *user_data, edgehog_ft_sched_entry_t *entry)
+{
+    requests_t *test_requests = (requests_t *) user_data;
+
+    zassert_true(index < test_requests->count);
+    *entry = test_requests->entries[index];
+    return !test_requests->blocked[index];
+}
+
+static void add_request(enum edgehog_ft_priority priority, int64_t enqueued_ms)
+{
+    zassert_true(requests.count < MAX_REQUESTS);
+    requests.entries[requests.count++]
+        = (edgehog_ft_sched_entry_t) { .priority = priority, .enqueued_ms = enqueued_ms };
+}
+
+static size_t select_at(int64_t now_ms)
+{
+    return edgehog_ft_scheduler_select(requests.count, now_ms, get_entry, &requests);
+}
@@ -0,0 +1,234 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/unit/src/http_headers_test.c
+ *
+ * @details Unit tests of the tracking of the HTTP response headers, fed as the HTTP parser does.
+ */
+
+#include <string.h>
+
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+#include "http_headers.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define ETAG_SIZE 16
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static http_headers_t headers;
+static char etag[ETAG_SIZE];
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Feed a header to the tracker, splitting its name and its value in pieces.
+ *
+ * @param[in] field Name of the header.
+ * @param[in] value Value of the header.
+ * @param[in] piece_size Size of the pieces, zero to feed the name and the value whole.
+ */
+static void feed_header(const char *field, const char *value, size_t piece_size);
+
+/************************************************
+ *                     Tests                    *
+ ***********************************************/
+
+static void http_headers_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    memset(etag, 'x', sizeof(etag));
+    http_headers_init(&headers, etag, sizeof(etag));
+}
+
+ZTEST(http_headers, test_http_headers_init)
+{
+    zassert_equal(etag[0], '\0');
+    zassert_false(headers.content_range_found);
+    zassert_equal(headers.retry_after_s, 0);
+}
+
+ZTEST(http_headers, test_http_headers_valid)
+{
+    feed_header("Content-Type", "application/octet-stream", 0);
+    feed_header("Content-Range", "bytes 1024-2047/4096", 0);
+    feed_header("ETag", "\"abc\"", 0);
+    feed_header("Retry-After", "120", 0);
+    http_headers_on_complete(&headers);
+
+    zassert_true(headers.content_range_found);
+    zassert_equal(headers.content_range_start, 1024);
+    zassert_str_equal(etag, "\"abc\"");
+    zassert_equal(headers.retry_after_s, 120);
+}
+
+ZTEST(http_headers, test_http_headers_case_insensitive)
+{
+    feed_header("content-range", "BYTES 7-8/9", 0);
+    feed_header("etag", "W/\"v1\"", 0);
+    feed_header("RETRY-AFTER", "5", 0);
+    http_headers_on_complete(&headers);
+
+    zassert_true(headers.content_range_found);
+    zassert_equal(headers.content_range_start, 7);
+    zassert_str_equal(etag, "W/\"v1\"");
+    zassert_equal(headers.retry_after_s, 5);
+}
+
+ZTEST(http_headers, test_http_headers_last_header_on_complete)
+{
+    feed_header("Retry-After", "30", 0);
+    zassert_equal(headers.retry_after_s, 0);
+    http_headers_on_complete(&headers);
+    zassert_equal(headers.retry_after_s, 30);
+}
+
+ZTEST(http_headers, test_http_headers_split)
+{
+    const size_t piece_sizes[] = { 1, 2, 5 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(piece_sizes); i++) {
+        http_headers_init(&headers, etag, sizeof(etag));
+        feed_header("Content-Range", "bytes 512-1023/2048", piece_sizes[i]);
+        feed_header("ETag", "\"split\"", piece_sizes[i]);
+        feed_header("Retry-After", "3600", piece_sizes[i]);
+        feed_header("Server", "test", piece_sizes[i]);
+        http_headers_on_complete(&headers);
+
+        zassert_true(headers.content_range_found, "Piece size %zu", piece_sizes[i]);
+        zassert_equal(headers.content_range_start, 512, "Piece size %zu", piece_sizes[i]);
+        zassert_str_equal(etag, "\"split\"", "Piece size %zu", piece_sizes[i]);
+        zassert_equal(headers.retry_after_s, 3600, "Piece size %zu", piece_sizes[i]);
+    }
+}
+
+ZTEST(http_headers, test_http_headers_oversized_value)
+{
+    char value[HTTP_HEADERS_VALUE_SIZE + 1];
+
+    memset(value, '1', sizeof(value) - 1);
+    value[sizeof(value) - 1] = '\0';
+    feed_header("Retry-After", value, 7);
+    feed_header("Content-Range", "bytes 1-2/3", 0);
+    http_headers_on_complete(&headers);
+
+    zassert_equal(headers.retry_after_s, 0);
+    zassert_true(headers.content_range_found);
+    zassert_equal(headers.content_range_start, 1);
+}
+
+ZTEST(http_headers, test_http_headers_oversized_etag)
+{
+    char value[ETAG_SIZE + 1];
+
+    memset(value, 'e', sizeof(value) - 1);
+    value[sizeof(value) - 1] = '\0';
+    feed_header("ETag", value, 0);
+    http_headers_on_complete(&headers);
+    zassert_equal(etag[0], '\0');
+
+    // The longest ETag fitting the buffer with its terminator
+    value[ETAG_SIZE - 1] = '\0';
+    feed_header("ETag", value, 0);
+    http_headers_on_complete(&headers);
+    zassert_str_equal(etag, value);
+}
+
+ZTEST(http_headers, test_http_headers_oversized_field)
+{
+    feed_header("Content-Range-Of-An-Unknown-Extension", "bytes 1-2/3", 0);
+    feed_header("Retry-After-Some-Unknown-Extension", "10", 3);
+    http_headers_on_complete(&headers);
+
+    zassert_false(headers.content_range_found);
+    zassert_equal(headers.retry_after_s, 0);
+}
+
+ZTEST(http_headers, test_http_headers_etag_not_requested)
+{
+    http_headers_init(&headers, NULL, 0);
+    feed_header("ETag", "\"abc\"", 0);
+    feed_header("Retry-After", "1", 0);
+    http_headers_on_complete(&headers);
+    zassert_equal(headers.retry_after_s, 1);
+}
+
+ZTEST(http_headers, test_http_headers_malformed_content_range)
+{
+    const char *values[] = {
+        "bytes ",
+        "bytes */4096",
+        "bytes -100/4096",
+        "bytes 100",
+        "bytes 100/4096",
+        "items 0-1/2",
+        "bytes 99999999999999999999999999-1/2",
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+        http_headers_init(&headers, etag, sizeof(etag));
+        feed_header("Content-Range", values[i], 0);
+        http_headers_on_complete(&headers);
+        zassert_false(headers.content_range_found, "Value %s", values[i]);
+    }
+}
+
+ZTEST(http_headers, test_http_headers_malformed_retry_after)
+{
+    const char *values[] = {
+        "",
+        "12a",
+        "-5",
+        "Wed, 21 Oct 2015 07:28:00 GMT",
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+        http_headers_init(&headers, etag, sizeof(etag));
+        feed_header("Retry-After", values[i], 0);
+        http_headers_on_complete(&headers);
+        zassert_equal(headers.retry_after_s, 0, "Value %s", values[i]);
+    }
+}
+
+ZTEST(http_headers, test_http_headers_retry_after_saturated)
+{
+    feed_header("Retry-After", "99999999999999999999", 0);
+    http_headers_on_complete(&headers);
+    zassert_equal(headers.retry_after_s, UINT32_MAX);
+}
+
+ZTEST_SUITE(http_headers, NULL, NULL, http_headers_before, NULL, NULL);
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static void feed_header(const char *field, const char *value, size_t piece_size)
+{
+    size_t field_len = strlen(field);
+    size_t value_len = strlen(value);
+    size_t field_piece = (piece_size > 0) ? piece_size : field_len;
+    size_t value_piece = (piece_size > 0) ? piece_size : value_len;
+
+    for (size_t offset = 0; offset < field_len; offset += field_piece) {
+        http_headers_on_field(&headers, &field[offset], MIN(field_piece, field_len - offset));
+    }
+    // The parser reports an empty value with a single empty piece
+    if (value_len == 0) {
+        http_headers_on_value(&headers, value, 0);
+    }
+    for (size_t offset = 0; offset < value_len; offset += value_piece) {
+        http_headers_on_value(&headers, &value[offset], MIN(value_piece, value_len - offset));
+    }
+}
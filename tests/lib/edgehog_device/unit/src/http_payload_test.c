@@ -0,0 +1,177 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/unit/src/http_payload_test.c
+ *
+ * @details Unit tests of the upload of HTTP request payloads, plain and chunked.
+ */
+
+#include <string.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+#include "http_payload.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define SOCK 3
+#define MAX_CHUNKS 4
+
+/** @brief Chunks returned by the payload callback, the last one ends the payload. */
+typedef struct
+{
+    /** @brief Data of the chunks, an empty string for an empty chunk. */
+    const char *chunks[MAX_CHUNKS];
+    /** @brief Number of chunks. */
+    size_t count;
+    /** @brief Number of chunks returned so far. */
+    size_t next;
+    /** @brief Result returned by the callback for the chunk at fail_at. */
+    edgehog_result_t fail_result;
+    /** @brief Index of the chunk whose request fails, count to never fail. */
+    size_t fail_at;
+} payload_t;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static payload_t payload;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Payload callback returning the chunks of the test payload.
+ */
+static edgehog_result_t payload_cbk(edgehog_http_payload_chunk_t *chunk, void *user_data);
+
+/**
+ * @brief Check that the data sent matches a string.
+ *
+ * @param[in] expected Expected data.
+ */
+static void assert_sent(const char *expected);
+
+/************************************************
+ *                     Tests                    *
+ ***********************************************/
+
+static void http_payload_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    fake_socket_reset(SIZE_MAX, SIZE_MAX);
+    payload = (payload_t) {
+        .chunks = { "hello", "", " chunked world!" },
+        .count = 3,
+        .fail_at = 3,
+    };
+}
+
+ZTEST(http_payload, test_http_payload_plain)
+{
+    edgehog_result_t result = EDGEHOG_RESULT_INTERNAL_ERROR;
+    int sent = http_payload_send(SOCK, false, payload_cbk, &payload, &result);
+
+    zassert_equal(result, EDGEHOG_RESULT_OK);
+    zassert_equal(sent, strlen("hello chunked world!"));
+    assert_sent("hello chunked world!");
+}
+
+ZTEST(http_payload, test_http_payload_chunked)
+{
+    edgehog_result_t result = EDGEHOG_RESULT_INTERNAL_ERROR;
+    int sent = http_payload_send(SOCK, true, payload_cbk, &payload, &result);
+
+    // The empty chunk is skipped, it would terminate the payload
+    const char *expected = "5\r\nhello\r\nf\r\n chunked world!\r\n0\r\n\r\n";
+    zassert_equal(result, EDGEHOG_RESULT_OK);
+    zassert_equal(sent, strlen(expected));
+    assert_sent(expected);
+}
+
+ZTEST(http_payload, test_http_payload_chunked_empty)
+{
+    payload = (payload_t) { .chunks = { "" }, .count = 1, .fail_at = 1 };
+    edgehog_result_t result = EDGEHOG_RESULT_INTERNAL_ERROR;
+    int sent = http_payload_send(SOCK, true, payload_cbk, &payload, &result);
+
+    zassert_equal(result, EDGEHOG_RESULT_OK);
+    zassert_equal(sent, strlen("0\r\n\r\n"));
+    assert_sent("0\r\n\r\n");
+}
+
+ZTEST(http_payload, test_http_payload_partial_sends)
+{
+    fake_socket_reset(2, SIZE_MAX);
+    edgehog_result_t result = EDGEHOG_RESULT_INTERNAL_ERROR;
+    int sent = http_payload_send(SOCK, true, payload_cbk, &payload, &result);
+
+    const char *expected = "5\r\nhello\r\nf\r\n chunked world!\r\n0\r\n\r\n";
+    zassert_equal(result, EDGEHOG_RESULT_OK);
+    zassert_equal(sent, strlen(expected));
+    assert_sent(expected);
+}
+
+ZTEST(http_payload, test_http_payload_send_error)
+{
+    const size_t fail_after[] = { 1, 8, 11, 33 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(fail_after); i++) {
+        fake_socket_reset(SIZE_MAX, fail_after[i]);
+        payload.next = 0;
+        edgehog_result_t result = EDGEHOG_RESULT_OK;
+        zassert_true(http_payload_send(SOCK, true, payload_cbk, &payload, &result) < 0,
+            "Failing after %zu bytes", fail_after[i]);
+        zassert_equal(result, EDGEHOG_RESULT_HTTP_REQUEST_ERROR, "Failing after %zu bytes",
+            fail_after[i]);
+    }
+}
+
+ZTEST(http_payload, test_http_payload_callback_error)
+{
+    payload.fail_at = 1;
+    payload.fail_result = EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+    edgehog_result_t result = EDGEHOG_RESULT_OK;
+    zassert_true(http_payload_send(SOCK, true, payload_cbk, &payload, &result) < 0);
+    zassert_equal(result, EDGEHOG_RESULT_HTTP_REQUEST_ABORTED);
+    // No terminator is sent, so the server doesn't take the payload as complete
+    assert_sent("5\r\nhello\r\n");
+}
+
+ZTEST_SUITE(http_payload, NULL, NULL, http_payload_before, NULL, NULL);
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static edgehog_result_t payload_cbk(edgehog_http_payload_chunk_t *chunk, void *user_data)
+{
+    payload_t *test_payload = (payload_t *) user_data;
+
+    zassert_true(test_payload->next < test_payload->count);
+    if (test_payload->next == test_payload->fail_at) {
+        return test_payload->fail_result;
+    }
+    const char *data = test_payload->chunks[test_payload->next++];
+    chunk->chunk_start_addr = (uint8_t *) data;
+    chunk->chunk_size = strlen(data);
+    chunk->last_chunk = (test_payload->next == test_payload->count);
+    return EDGEHOG_RESULT_OK;
+}
+
+static void assert_sent(const char *expected)
+{
+    size_t size = 0;
+    const uint8_t *sent = fake_socket_sent(&size);
+
+    zassert_equal(size, strlen(expected));
+    zassert_mem_equal(sent, expected, MIN(size, strlen(expected)));
+}
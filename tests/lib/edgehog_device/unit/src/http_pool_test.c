@@ -0,0 +1,129 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/unit/src/http_pool_test.c
+ *
+ * @details Unit tests of the keep-alive pool of the HTTP connections.
+ */
+
+#include <string.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+#include "http_pool.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define HOST "edgehog.example.com"
+#define OTHER_HOST "files.example.com"
+#define PORT "443"
+#define IDLE_TIMEOUT_MS CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE_IDLE_TIMEOUT_MS
+
+BUILD_ASSERT(CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE_POOL_SIZE == 2,
+    "The tests fill a pool of two connections");
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static http_pool_t pool;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *                     Tests                    *
+ ***********************************************/
+
+static void http_pool_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    fake_socket_reset(SIZE_MAX, SIZE_MAX);
+    memset(&pool, 0, sizeof(pool));
+}
+
+ZTEST(http_pool, test_http_pool_reuse)
+{
+    http_pool_put(&pool, 3, HOST, PORT, 0);
+    zassert_equal(http_pool_take(&pool, HOST, PORT, 10), 3);
+    // A connection is handed out only once
+    zassert_equal(http_pool_take(&pool, HOST, PORT, 10), -1);
+    zassert_false(fake_socket_is_closed(3));
+}
+
+ZTEST(http_pool, test_http_pool_match)
+{
+    http_pool_put(&pool, 3, HOST, PORT, 0);
+    zassert_equal(http_pool_take(&pool, OTHER_HOST, PORT, 10), -1);
+    zassert_equal(http_pool_take(&pool, HOST, "80", 10), -1);
+    zassert_equal(http_pool_take(&pool, HOST, PORT, 10), 3);
+}
+
+ZTEST(http_pool, test_http_pool_expired)
+{
+    http_pool_put(&pool, 3, HOST, PORT, 0);
+    zassert_equal(http_pool_take(&pool, HOST, PORT, IDLE_TIMEOUT_MS), -1);
+    zassert_true(fake_socket_is_closed(3));
+}
+
+ZTEST(http_pool, test_http_pool_evict_expired)
+{
+    zassert_equal(http_pool_evict_expired(&pool, 0), -1);
+
+    http_pool_put(&pool, 3, HOST, PORT, 0);
+    http_pool_put(&pool, 4, OTHER_HOST, PORT, 100);
+    zassert_equal(http_pool_evict_expired(&pool, 50), IDLE_TIMEOUT_MS - 50);
+    zassert_equal(http_pool_evict_expired(&pool, IDLE_TIMEOUT_MS), 100);
+    zassert_true(fake_socket_is_closed(3));
+    zassert_false(fake_socket_is_closed(4));
+    zassert_equal(http_pool_evict_expired(&pool, IDLE_TIMEOUT_MS + 100), -1);
+    zassert_true(fake_socket_is_closed(4));
+}
+
+ZTEST(http_pool, test_http_pool_full)
+{
+    http_pool_put(&pool, 3, HOST, PORT, 0);
+    http_pool_put(&pool, 4, HOST, PORT, 10);
+    // The connection idle for the longest time makes room for the new one
+    http_pool_put(&pool, 5, OTHER_HOST, PORT, 20);
+    zassert_true(fake_socket_is_closed(3));
+    zassert_equal(http_pool_take(&pool, HOST, PORT, 30), 4);
+    zassert_equal(http_pool_take(&pool, OTHER_HOST, PORT, 30), 5);
+}
+
+ZTEST(http_pool, test_http_pool_stale)
+{
+    http_pool_put(&pool, 3, HOST, PORT, 0);
+    http_pool_put(&pool, 4, HOST, PORT, 0);
+    // A connection closed by the server while idle is dropped, the next one is used
+    fake_socket_set_readable(3);
+    zassert_equal(http_pool_take(&pool, HOST, PORT, 10), 4);
+    zassert_true(fake_socket_is_closed(3));
+}
+
+ZTEST(http_pool, test_http_pool_host_too_long)
+{
+    char host[HTTP_POOL_HOST_SIZE + 1];
+
+    memset(host, 'h', sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    http_pool_put(&pool, 3, host, PORT, 0);
+    zassert_true(fake_socket_is_closed(3));
+    zassert_equal(http_pool_take(&pool, host, PORT, 0), -1);
+}
+
+ZTEST(http_pool, test_http_pool_close_all)
+{
+    http_pool_put(&pool, 3, HOST, PORT, 0);
+    http_pool_put(&pool, 4, OTHER_HOST, PORT, 0);
+    http_pool_close_all(&pool);
+    zassert_true(fake_socket_is_closed(3));
+    zassert_true(fake_socket_is_closed(4));
+    zassert_equal(http_pool_take(&pool, HOST, PORT, 0), -1);
+    zassert_equal(http_pool_evict_expired(&pool, 0), -1);
+}
+
+ZTEST_SUITE(http_pool, NULL, NULL, http_pool_before, NULL, NULL);
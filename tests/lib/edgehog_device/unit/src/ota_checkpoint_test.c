@@ -0,0 +1,153 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/unit/src/ota_checkpoint_test.c
+ *
+ * @details Unit tests of the checkpoints used to resume an OTA download after a reboot.
+ */
+
+#include <string.h>
+
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+#include "ota_checkpoint.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define AREA_ID 3
+#define AREA_OFFSET 0x20000
+#define PAGE_SIZE 0x1000
+#define SLOT_SIZE (8 * PAGE_SIZE)
+#define IMAGE_SIZE (6 * PAGE_SIZE)
+#define INTERVAL CONFIG_EDGEHOG_DEVICE_OTA_CHECKPOINT_INTERVAL
+
+#define REQUEST_UUID "5f0a2c1e-9b7d-4e3a-8c6f-1d2e3f4a5b6c"
+#define OTHER_UUID "0e9d8c7b-6a5f-4e3d-2c1b-0a9f8e7d6c5b"
+#define URL_HASH 0x1234abcdU
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static uint8_t slot[SLOT_SIZE];
+static const struct flash_area *flash_area;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Fill a checkpoint of the test request.
+ *
+ * @param[in] persisted_size Bytes of the image persisted in the slot.
+ * @return The checkpoint.
+ */
+static ota_checkpoint_t make_checkpoint(size_t persisted_size);
+
+/************************************************
+ *                     Tests                    *
+ ***********************************************/
+
+static void ota_checkpoint_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    fake_flash_area_set(AREA_ID, slot, sizeof(slot));
+    fake_flash_area_set_offset(AREA_OFFSET);
+    fake_flash_set_page_size(PAGE_SIZE);
+    zassert_ok(flash_area_open(AREA_ID, &flash_area));
+}
+
+ZTEST(ota_checkpoint, test_ota_checkpoint_init)
+{
+    ota_checkpoint_t checkpoint = make_checkpoint(PAGE_SIZE + 10);
+
+    zassert_str_equal(checkpoint.uuid, REQUEST_UUID);
+    zassert_equal(checkpoint.url_hash, URL_HASH);
+    zassert_equal(checkpoint.image_size, IMAGE_SIZE);
+    zassert_equal(checkpoint.bytes_written, PAGE_SIZE + 10);
+    zassert_equal(checkpoint.flash_offset, AREA_OFFSET + PAGE_SIZE + 10);
+}
+
+ZTEST(ota_checkpoint, test_ota_checkpoint_matches)
+{
+    ota_checkpoint_t checkpoint = make_checkpoint(PAGE_SIZE);
+    zassert_true(ota_checkpoint_matches(&checkpoint, REQUEST_UUID, URL_HASH));
+    zassert_false(ota_checkpoint_matches(&checkpoint, OTHER_UUID, URL_HASH));
+    // The same request with a new URL downloads another image
+    zassert_false(ota_checkpoint_matches(&checkpoint, REQUEST_UUID, URL_HASH + 1));
+
+    // Nothing to resume before the first byte nor after the last one
+    checkpoint = make_checkpoint(0);
+    zassert_false(ota_checkpoint_matches(&checkpoint, REQUEST_UUID, URL_HASH));
+    checkpoint = make_checkpoint(IMAGE_SIZE);
+    zassert_false(ota_checkpoint_matches(&checkpoint, REQUEST_UUID, URL_HASH));
+}
+
+ZTEST(ota_checkpoint, test_ota_checkpoint_is_due)
+{
+    zassert_false(ota_checkpoint_is_due(0, INTERVAL - 1, IMAGE_SIZE));
+    zassert_true(ota_checkpoint_is_due(0, INTERVAL, IMAGE_SIZE));
+    zassert_false(ota_checkpoint_is_due(INTERVAL, (2 * INTERVAL) - 1, IMAGE_SIZE));
+    zassert_true(ota_checkpoint_is_due(INTERVAL, 2 * INTERVAL, IMAGE_SIZE));
+    // The whole image is written, the download won't be resumed
+    zassert_false(ota_checkpoint_is_due(0, IMAGE_SIZE, IMAGE_SIZE));
+}
+
+ZTEST(ota_checkpoint, test_ota_checkpoint_resume_size)
+{
+    size_t resume_size = 0;
+
+    // Data written after the checkpoint could be incomplete, the page holding it is rewritten
+    ota_checkpoint_t checkpoint = make_checkpoint((2 * PAGE_SIZE) + 100);
+    zassert_true(ota_checkpoint_get_resume_size(&checkpoint, flash_area, &resume_size));
+    zassert_equal(resume_size, 2 * PAGE_SIZE);
+
+    checkpoint = make_checkpoint(3 * PAGE_SIZE);
+    zassert_true(ota_checkpoint_get_resume_size(&checkpoint, flash_area, &resume_size));
+    zassert_equal(resume_size, 3 * PAGE_SIZE);
+
+    // Nothing is kept from the first page
+    checkpoint = make_checkpoint(PAGE_SIZE - 1);
+    zassert_false(ota_checkpoint_get_resume_size(&checkpoint, flash_area, &resume_size));
+}
+
+ZTEST(ota_checkpoint, test_ota_checkpoint_slot_layout)
+{
+    size_t resume_size = 0;
+
+    // The secondary slot moved since the checkpoint has been saved
+    ota_checkpoint_t checkpoint = make_checkpoint(2 * PAGE_SIZE);
+    checkpoint.flash_offset += PAGE_SIZE;
+    zassert_false(ota_checkpoint_get_resume_size(&checkpoint, flash_area, &resume_size));
+
+    // The image doesn't fit the secondary slot anymore
+    checkpoint = make_checkpoint(2 * PAGE_SIZE);
+    checkpoint.image_size = SLOT_SIZE + 1;
+    zassert_false(ota_checkpoint_get_resume_size(&checkpoint, flash_area, &resume_size));
+
+    // The flash device can't tell the page of the checkpoint
+    checkpoint = make_checkpoint(2 * PAGE_SIZE);
+    fake_flash_set_page_size(0);
+    zassert_false(ota_checkpoint_get_resume_size(&checkpoint, flash_area, &resume_size));
+}
+
+ZTEST_SUITE(ota_checkpoint, NULL, NULL, ota_checkpoint_before, NULL, NULL);
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static ota_checkpoint_t make_checkpoint(size_t persisted_size)
+{
+    ota_checkpoint_t checkpoint;
+    ota_checkpoint_init(
+        &checkpoint, REQUEST_UUID, URL_HASH, IMAGE_SIZE, flash_area, persisted_size);
+    return checkpoint;
+}
@@ -0,0 +1,389 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/unit/src/ota_delta_test.c
+ *
+ * @details Unit tests of the delta OTA patch applier, with a patch generated by
+ * scripts/ota_delta.py.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+#include "ota_delta.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define SOURCE_AREA_ID 1
+#define SOURCE_SIZE 384
+#define TARGET_SIZE 345
+#define LCG_SEED 1
+#define PATCH_SOURCE_HASH_OFFSET 16
+#define PATCH_TARGET_HASH_OFFSET (PATCH_SOURCE_HASH_OFFSET + OTA_DELTA_HASH_SIZE)
+// Control block of the record holding diff, extra and seek
+#define PATCH_RECORD_OFFSET (OTA_DELTA_HEADER_SIZE + OTA_DELTA_CONTROL_SIZE)
+#define PATCH_RECORD_DIFF_LEN_OFFSET (PATCH_RECORD_OFFSET)
+#define PATCH_RECORD_EXTRA_LEN_OFFSET (PATCH_RECORD_OFFSET + sizeof(uint32_t))
+#define PATCH_RECORD_SEEK_OFFSET (PATCH_RECORD_OFFSET + 2 * sizeof(uint32_t))
+#define PATCH_RECORD_DIFF_OFFSET (PATCH_RECORD_OFFSET + OTA_DELTA_CONTROL_SIZE)
+#define FAKE_PSA_DIGESTS 2
+
+/**
+ * Patch from the source to the target image built by build_images(), generated with
+ * scripts/ota_delta.py. It is made of an extra only record, a record with diff, extra and seek,
+ * and a diff only record.
+ */
+static const uint8_t patch[] = {
+    0x45, 0x48, 0x44, 0x50, 0x80, 0x01, 0x00, 0x00, 0x59, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x52, 0x35, 0x50, 0xc6, 0xcc, 0x6d, 0xec, 0xd0,
+    0x2a, 0xd4, 0xcc, 0x53, 0x9e, 0x05, 0x42, 0x50, 0xb3, 0xd4, 0x0a, 0x66,
+    0xa7, 0xcb, 0xa9, 0xb0, 0xad, 0xe4, 0x6b, 0xbe, 0x5f, 0x25, 0xea, 0x44,
+    0x64, 0xa9, 0x9a, 0x78, 0xfb, 0x04, 0x92, 0xb6, 0xf7, 0x47, 0x0b, 0x0a,
+    0x19, 0xb0, 0xb9, 0x58, 0x7a, 0x5b, 0x86, 0x76, 0xab, 0x95, 0xa5, 0xb6,
+    0x17, 0xd9, 0x2d, 0xd5, 0x81, 0x2e, 0xc0, 0xa1, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00,
+    0x19, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x2a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x45, 0x44, 0x47, 0x45, 0x48, 0x4f, 0x47, 0x2d,
+    0x44, 0x45, 0x4c, 0x54, 0x41, 0x2d, 0x45, 0x58, 0x54, 0x52, 0x41, 0x2d,
+    0x42, 0x59, 0x54, 0x45, 0x53, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+/** @brief Content registered for a digest of the fake PSA hash. */
+typedef struct
+{
+    const uint8_t *digest;
+    const uint8_t *data;
+    size_t size;
+} fake_psa_digest_t;
+
+/************************************************
+ *       Checks over configuration values       *
+ ***********************************************/
+
+BUILD_ASSERT(sizeof(patch) > PATCH_RECORD_DIFF_OFFSET, "The test patch is too short");
+
+/************************************************
+ *       Global variables definition            *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static uint8_t source[SOURCE_SIZE];
+static uint8_t target[TARGET_SIZE];
+static uint8_t output[TARGET_SIZE];
+static size_t output_size;
+static uint8_t patch_copy[sizeof(patch)];
+static ota_delta_ctx_t ctx;
+
+static fake_psa_digest_t fake_psa_digests[FAKE_PSA_DIGESTS];
+static size_t fake_psa_digests_count;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Build the source image and the target image the test patch has been generated for.
+ *
+ * @details The source is pseudo-random data. The target changes two of its bytes, replaces part
+ * of it with new bytes and drops another part, then changes one more byte.
+ */
+static void build_images(void);
+
+/**
+ * @brief Write callback of the applier, collecting the reconstructed image.
+ */
+static int write_output(const uint8_t *data, size_t size, void *user_data);
+
+/**
+ * @brief Apply a patch in chunks of a fixed size.
+ *
+ * @param[in] data Patch to apply.
+ * @param[in] size Size of the patch.
+ * @param[in] chunk_size Size of the chunks passed to the applier.
+ * @return The result of the first failing chunk, EDGEHOG_RESULT_OK if none fails.
+ */
+static edgehog_result_t apply_chunked(const uint8_t *data, size_t size, size_t chunk_size);
+
+/************************************************
+ *                     Fakes                    *
+ ***********************************************/
+
+void fake_psa_register_digest(
+    const uint8_t *digest, size_t digest_size, const uint8_t *data, size_t size)
+{
+    zassert_equal(digest_size, OTA_DELTA_HASH_SIZE);
+    zassert_true(fake_psa_digests_count < FAKE_PSA_DIGESTS);
+    fake_psa_digests[fake_psa_digests_count++]
+        = (fake_psa_digest_t) { .digest = digest, .data = data, .size = size };
+}
+
+psa_status_t psa_crypto_init(void)
+{
+    return PSA_SUCCESS;
+}
+
+psa_hash_operation_t psa_hash_operation_init(void)
+{
+    return (psa_hash_operation_t) { 0 };
+}
+
+psa_status_t psa_hash_setup(psa_hash_operation_t *operation, psa_algorithm_t alg)
+{
+    if (alg != PSA_ALG_SHA_256) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+    operation->size = 0;
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_hash_update(psa_hash_operation_t *operation, const uint8_t *input, size_t len)
+{
+    if (operation->size + len > sizeof(operation->data)) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+    memcpy(&operation->data[operation->size], input, len);
+    operation->size += len;
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_hash_verify(
+    psa_hash_operation_t *operation, const uint8_t *hash, size_t hash_length)
+{
+    for (size_t i = 0; i < fake_psa_digests_count; i++) {
+        const fake_psa_digest_t *entry = &fake_psa_digests[i];
+        if ((hash_length == OTA_DELTA_HASH_SIZE) && (memcmp(entry->digest, hash, hash_length) == 0)
+            && (entry->size == operation->size)
+            && (memcmp(entry->data, operation->data, operation->size) == 0)) {
+            return PSA_SUCCESS;
+        }
+    }
+    return PSA_ERROR_INVALID_SIGNATURE;
+}
+
+psa_status_t psa_hash_abort(psa_hash_operation_t *operation)
+{
+    operation->size = 0;
+    return PSA_SUCCESS;
+}
+
+/************************************************
+ *                     Tests                    *
+ ***********************************************/
+
+static void *ota_delta_suite_setup(void)
+{
+    build_images();
+    return NULL;
+}
+
+static void ota_delta_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    memcpy(patch_copy, patch, sizeof(patch));
+    memset(output, 0, sizeof(output));
+    output_size = 0;
+    fake_flash_area_set(SOURCE_AREA_ID, source, sizeof(source));
+    fake_psa_digests_count = 0;
+    fake_psa_register_digest(
+        &patch[PATCH_SOURCE_HASH_OFFSET], OTA_DELTA_HASH_SIZE, source, sizeof(source));
+    fake_psa_register_digest(
+        &patch[PATCH_TARGET_HASH_OFFSET], OTA_DELTA_HASH_SIZE, target, sizeof(target));
+    zassert_equal(ota_delta_init(&ctx, SOURCE_AREA_ID, write_output, NULL), EDGEHOG_RESULT_OK);
+}
+
+static void ota_delta_after(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    ota_delta_free(&ctx);
+}
+
+ZTEST(ota_delta, test_ota_delta_is_patch)
+{
+    zassert_true(ota_delta_is_patch(patch, sizeof(patch)));
+    zassert_false(ota_delta_is_patch(patch, sizeof(uint32_t) - 1));
+    zassert_false(ota_delta_is_patch(source, sizeof(source)));
+}
+
+ZTEST(ota_delta, test_ota_delta_apply)
+{
+    zassert_equal(ota_delta_process(&ctx, patch, sizeof(patch)), EDGEHOG_RESULT_OK);
+    zassert_equal(ota_delta_finish(&ctx), EDGEHOG_RESULT_OK);
+    zassert_equal(output_size, sizeof(target));
+    zassert_mem_equal(output, target, sizeof(target));
+}
+
+ZTEST(ota_delta, test_ota_delta_apply_chunked)
+{
+    const size_t chunk_sizes[] = { 1, 7, 64 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(chunk_sizes); i++) {
+        if (i > 0) {
+            ota_delta_free(&ctx);
+            output_size = 0;
+            zassert_equal(
+                ota_delta_init(&ctx, SOURCE_AREA_ID, write_output, NULL), EDGEHOG_RESULT_OK);
+        }
+        zassert_equal(apply_chunked(patch, sizeof(patch), chunk_sizes[i]), EDGEHOG_RESULT_OK,
+            "Chunk size %zu", chunk_sizes[i]);
+        zassert_equal(ota_delta_finish(&ctx), EDGEHOG_RESULT_OK, "Chunk size %zu", chunk_sizes[i]);
+        zassert_mem_equal(output, target, sizeof(target), "Chunk size %zu", chunk_sizes[i]);
+    }
+}
+
+ZTEST(ota_delta, test_ota_delta_truncated_header)
+{
+    zassert_equal(ota_delta_process(&ctx, patch, OTA_DELTA_HEADER_SIZE / 2), EDGEHOG_RESULT_OK);
+    zassert_equal(ota_delta_finish(&ctx), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_equal(output_size, 0);
+}
+
+ZTEST(ota_delta, test_ota_delta_truncated_record)
+{
+    zassert_equal(ota_delta_process(&ctx, patch, sizeof(patch) - 1), EDGEHOG_RESULT_OK);
+    zassert_equal(ota_delta_finish(&ctx), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_equal(output_size, sizeof(target) - 1);
+}
+
+ZTEST(ota_delta, test_ota_delta_truncated_control)
+{
+    zassert_equal(ota_delta_process(&ctx, patch, PATCH_RECORD_OFFSET + 1), EDGEHOG_RESULT_OK);
+    zassert_equal(ota_delta_finish(&ctx), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+}
+
+ZTEST(ota_delta, test_ota_delta_trailing_data)
+{
+    zassert_equal(ota_delta_process(&ctx, patch, sizeof(patch)), EDGEHOG_RESULT_OK);
+    zassert_equal(ota_delta_process(&ctx, patch, 1), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+}
+
+ZTEST(ota_delta, test_ota_delta_corrupt_diff_len)
+{
+    sys_put_le32(SOURCE_SIZE + 1, &patch_copy[PATCH_RECORD_DIFF_LEN_OFFSET]);
+    zassert_equal(ota_delta_process(&ctx, patch_copy, sizeof(patch_copy)),
+        EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+}
+
+ZTEST(ota_delta, test_ota_delta_corrupt_extra_len)
+{
+    // Diff plus extra lengths wrapping around a 32 bit size_t
+    sys_put_le32(1, &patch_copy[PATCH_RECORD_DIFF_LEN_OFFSET]);
+    sys_put_le32(UINT32_MAX, &patch_copy[PATCH_RECORD_EXTRA_LEN_OFFSET]);
+    zassert_equal(ota_delta_process(&ctx, patch_copy, sizeof(patch_copy)),
+        EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_true(output_size < sizeof(target));
+}
+
+ZTEST(ota_delta, test_ota_delta_corrupt_seek)
+{
+    sys_put_le32((uint32_t) -(SOURCE_SIZE + 1), &patch_copy[PATCH_RECORD_SEEK_OFFSET]);
+    zassert_equal(ota_delta_process(&ctx, patch_copy, sizeof(patch_copy)),
+        EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+}
+
+ZTEST(ota_delta, test_ota_delta_corrupt_diff)
+{
+    patch_copy[PATCH_RECORD_DIFF_OFFSET] ^= 0x01;
+    zassert_equal(ota_delta_process(&ctx, patch_copy, sizeof(patch_copy)), EDGEHOG_RESULT_OK);
+    zassert_equal(ota_delta_finish(&ctx), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+}
+
+ZTEST(ota_delta, test_ota_delta_wrong_source)
+{
+    uint8_t other_source[SOURCE_SIZE];
+
+    memcpy(other_source, source, sizeof(source));
+    other_source[0] ^= 0x01;
+    fake_flash_area_set(SOURCE_AREA_ID, other_source, sizeof(other_source));
+    zassert_equal(
+        ota_delta_process(&ctx, patch, sizeof(patch)), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_equal(output_size, 0);
+}
+
+ZTEST_SUITE(ota_delta, NULL, ota_delta_suite_setup, ota_delta_before, ota_delta_after, NULL);
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static void build_images(void)
+{
+    // Same generator used to produce the source image given to scripts/ota_delta.py
+    uint32_t state = LCG_SEED;
+    for (size_t i = 0; i < sizeof(source); i++) {
+        state = ((state * 1103515245U) + 12345U) & 0x7FFFFFFFU;
+        source[i] = (uint8_t) (state >> 16);
+    }
+
+    const char extra[] = "EDGEHOG-DELTA-EXTRA-BYTES";
+    size_t extra_len = sizeof(extra) - 1;
+    size_t head_len = 128;
+    size_t tail_offset = 192;
+
+    memcpy(target, source, head_len);
+    target[40] ^= 0x5A;
+    target[90] += 3;
+    memcpy(&target[head_len], extra, extra_len);
+    memcpy(&target[head_len + extra_len], &source[tail_offset], sizeof(source) - tail_offset);
+    target[200] ^= 0xFF;
+}
+
+static int write_output(const uint8_t *data, size_t size, void *user_data)
+{
+    ARG_UNUSED(user_data);
+    if (output_size + size > sizeof(output)) {
+        return -ENOMEM;
+    }
+    memcpy(&output[output_size], data, size);
+    output_size += size;
+    return 0;
+}
+
+static edgehog_result_t apply_chunked(const uint8_t *data, size_t size, size_t chunk_size)
+{
+    for (size_t offset = 0; offset < size; offset += chunk_size) {
+        edgehog_result_t res
+            = ota_delta_process(&ctx, &data[offset], MIN(chunk_size, size - offset));
+        if (res != EDGEHOG_RESULT_OK) {
+            return res;
+        }
+    }
+    return EDGEHOG_RESULT_OK;
+}
@@ -0,0 +1,296 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/unit/src/ota_image_test.c
+ *
+ * @details Unit tests of the parsing of the MCUboot image header and TLVs.
+ */
+
+#include <string.h>
+
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+#include "ota_image.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define AREA_ID 2
+#define SLOT_SIZE 256
+
+#define IMAGE_MAGIC 0x96f3b83dU
+#define IMAGE_TLV_INFO_MAGIC 0x6907U
+#define IMAGE_TLV_SHA256 0x10U
+#define IMAGE_TLV_SHA384 0x11U
+#define TLV_HEADER_SIZE 4
+
+#define LOAD_ADDR 0x20000000U
+#define HDR_SIZE 64
+#define IMG_SIZE 100
+#define PROTECT_TLV_SIZE 12
+#define FLAGS OTA_IMAGE_F_RAM_LOAD
+
+/** @brief Offset of the unprotected TLV area in the test image. */
+#define TLV_INFO_OFFSET (HDR_SIZE + IMG_SIZE + PROTECT_TLV_SIZE)
+/** @brief Offset of the first TLV of the unprotected area in the test image. */
+#define TLV_OFFSET (TLV_INFO_OFFSET + TLV_HEADER_SIZE)
+/** @brief Size of the unprotected TLV area holding an unknown TLV and the hash TLV. */
+#define TLV_AREA_SIZE                                                                              \
+    (TLV_HEADER_SIZE + TLV_HEADER_SIZE + 4 + TLV_HEADER_SIZE + OTA_IMAGE_HASH_SIZE)
+
+BUILD_ASSERT(TLV_INFO_OFFSET + TLV_AREA_SIZE <= SLOT_SIZE, "The test image exceeds the slot");
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static uint8_t slot[SLOT_SIZE];
+static uint8_t hash[OTA_IMAGE_HASH_SIZE];
+static ota_image_header_t header;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Write a valid image in the test slot.
+ *
+ * @details The image has version 1.2.3+4 and a protected TLV area. Its unprotected TLV area holds
+ * an unknown TLV followed by the SHA-256 TLV.
+ */
+static void build_image(void);
+
+/**
+ * @brief Write a TLV header in the test slot.
+ *
+ * @param[in] offset Offset of the TLV header.
+ * @param[in] type Type of the TLV, or magic of the TLV area info.
+ * @param[in] len Length of the TLV, or total size of the TLV area.
+ */
+static void put_tlv(size_t offset, uint16_t type, uint16_t len);
+
+/************************************************
+ *                     Tests                    *
+ ***********************************************/
+
+static void ota_image_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    build_image();
+    fake_flash_area_set(AREA_ID, slot, sizeof(slot));
+    zassert_ok(ota_image_parse_header(slot, sizeof(slot), &header));
+}
+
+ZTEST(ota_image, test_ota_image_parse_header)
+{
+    zassert_equal(header.load_addr, LOAD_ADDR);
+    zassert_equal(header.hdr_size, HDR_SIZE);
+    zassert_equal(header.protect_tlv_size, PROTECT_TLV_SIZE);
+    zassert_equal(header.img_size, IMG_SIZE);
+    zassert_equal(header.flags, FLAGS);
+    zassert_equal(header.version.major, 1);
+    zassert_equal(header.version.minor, 2);
+    zassert_equal(header.version.revision, 3);
+    zassert_equal(header.version.build_num, 4);
+    zassert_equal(ota_image_hashed_size(&header), TLV_INFO_OFFSET);
+}
+
+ZTEST(ota_image, test_ota_image_bad_magic)
+{
+    ota_image_header_t parsed = { 0 };
+
+    slot[0] ^= 1;
+    zassert_equal(
+        ota_image_parse_header(slot, sizeof(slot), &parsed), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_equal(ota_image_read_header(AREA_ID, &parsed), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+}
+
+ZTEST(ota_image, test_ota_image_truncated_header)
+{
+    ota_image_header_t parsed = { 0 };
+
+    zassert_equal(ota_image_parse_header(slot, OTA_IMAGE_HEADER_SIZE - 1, &parsed),
+        EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_ok(ota_image_parse_header(slot, OTA_IMAGE_HEADER_SIZE, &parsed));
+
+    // A header declaring a size shorter than its fixed part
+    sys_put_le16(OTA_IMAGE_HEADER_SIZE - 1, &slot[8]);
+    zassert_equal(
+        ota_image_parse_header(slot, sizeof(slot), &parsed), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+}
+
+ZTEST(ota_image, test_ota_image_read_header)
+{
+    ota_image_header_t parsed = { 0 };
+
+    zassert_ok(ota_image_read_header(AREA_ID, &parsed));
+    zassert_mem_equal(&parsed, &header, sizeof(header));
+    zassert_equal(ota_image_read_header(AREA_ID + 1, &parsed), EDGEHOG_RESULT_FLASH_ERROR);
+}
+
+ZTEST(ota_image, test_ota_image_compare_versions)
+{
+    struct mcuboot_img_sem_ver older = header.version;
+    struct mcuboot_img_sem_ver newer = header.version;
+
+    zassert_equal(ota_image_compare_versions(&older, &newer), 0);
+    newer.build_num++;
+    zassert_true(ota_image_compare_versions(&older, &newer) < 0);
+    // The build number is compared last
+    older.revision++;
+    zassert_true(ota_image_compare_versions(&older, &newer) > 0);
+    newer.minor++;
+    zassert_true(ota_image_compare_versions(&older, &newer) < 0);
+    older.major++;
+    zassert_true(ota_image_compare_versions(&older, &newer) > 0);
+}
+
+ZTEST(ota_image, test_ota_image_read_size)
+{
+    size_t size = 0;
+
+    zassert_ok(ota_image_read_size(AREA_ID, &header, &size));
+    zassert_equal(size, TLV_INFO_OFFSET + TLV_AREA_SIZE);
+}
+
+ZTEST(ota_image, test_ota_image_read_hash)
+{
+    uint8_t read_hash[OTA_IMAGE_HASH_SIZE] = { 0 };
+    bool found = false;
+
+    zassert_ok(ota_image_read_hash(AREA_ID, &header, read_hash, &found));
+    zassert_true(found);
+    zassert_mem_equal(read_hash, hash, sizeof(hash));
+}
+
+ZTEST(ota_image, test_ota_image_missing_sha)
+{
+    uint8_t read_hash[OTA_IMAGE_HASH_SIZE] = { 0 };
+    bool found = true;
+
+    // An image hashed with another algorithm
+    put_tlv(TLV_OFFSET + TLV_HEADER_SIZE + 4, IMAGE_TLV_SHA384, OTA_IMAGE_HASH_SIZE);
+    zassert_ok(ota_image_read_hash(AREA_ID, &header, read_hash, &found));
+    zassert_false(found);
+
+    // A SHA-256 TLV with an unexpected length is not taken as the hash
+    found = true;
+    put_tlv(TLV_OFFSET + TLV_HEADER_SIZE + 4, IMAGE_TLV_SHA256, OTA_IMAGE_HASH_SIZE - 1);
+    zassert_ok(ota_image_read_hash(AREA_ID, &header, read_hash, &found));
+    zassert_false(found);
+
+    // An empty TLV area
+    found = true;
+    put_tlv(TLV_INFO_OFFSET, IMAGE_TLV_INFO_MAGIC, TLV_HEADER_SIZE);
+    zassert_ok(ota_image_read_hash(AREA_ID, &header, read_hash, &found));
+    zassert_false(found);
+}
+
+ZTEST(ota_image, test_ota_image_missing_tlv_area)
+{
+    uint8_t read_hash[OTA_IMAGE_HASH_SIZE] = { 0 };
+    bool found = true;
+    size_t size = 0;
+
+    put_tlv(TLV_INFO_OFFSET, IMAGE_TLV_INFO_MAGIC + 1, TLV_AREA_SIZE);
+    zassert_equal(
+        ota_image_read_size(AREA_ID, &header, &size), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_equal(ota_image_read_hash(AREA_ID, &header, read_hash, &found),
+        EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_false(found);
+
+    // A body so large that the TLV area would be past the end of the slot
+    ota_image_header_t large = header;
+    large.img_size = SLOT_SIZE;
+    zassert_equal(
+        ota_image_read_size(AREA_ID, &large, &size), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    // A body size overflowing the offset of the TLV area on 32 bit targets
+    large.img_size = UINT32_MAX;
+    zassert_equal(
+        ota_image_read_size(AREA_ID, &large, &size), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+}
+
+ZTEST(ota_image, test_ota_image_tlv_area_overflow)
+{
+    uint8_t read_hash[OTA_IMAGE_HASH_SIZE] = { 0 };
+    bool found = true;
+    size_t size = 0;
+
+    // The TLV area declares a size past the end of the slot
+    put_tlv(TLV_INFO_OFFSET, IMAGE_TLV_INFO_MAGIC, SLOT_SIZE - TLV_INFO_OFFSET + 1);
+    zassert_equal(
+        ota_image_read_size(AREA_ID, &header, &size), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_equal(ota_image_read_hash(AREA_ID, &header, read_hash, &found),
+        EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    put_tlv(TLV_INFO_OFFSET, IMAGE_TLV_INFO_MAGIC, UINT16_MAX);
+    zassert_equal(
+        ota_image_read_size(AREA_ID, &header, &size), EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_false(found);
+}
+
+ZTEST(ota_image, test_ota_image_tlv_overflow)
+{
+    uint8_t read_hash[OTA_IMAGE_HASH_SIZE] = { 0 };
+    bool found = true;
+
+    // The hash TLV runs past the end of the TLV area
+    put_tlv(TLV_INFO_OFFSET, IMAGE_TLV_INFO_MAGIC, TLV_AREA_SIZE - 1);
+    zassert_equal(ota_image_read_hash(AREA_ID, &header, read_hash, &found),
+        EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_false(found);
+
+    // The unknown TLV before it declares a length past the end of the TLV area
+    put_tlv(TLV_INFO_OFFSET, IMAGE_TLV_INFO_MAGIC, TLV_AREA_SIZE);
+    put_tlv(TLV_OFFSET, 0x50, UINT16_MAX);
+    zassert_equal(ota_image_read_hash(AREA_ID, &header, read_hash, &found),
+        EDGEHOG_RESULT_OTA_INVALID_IMAGE);
+    zassert_false(found);
+}
+
+ZTEST_SUITE(ota_image, NULL, NULL, ota_image_before, NULL, NULL);
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static void build_image(void)
+{
+    memset(slot, 0xff, sizeof(slot));
+
+    sys_put_le32(IMAGE_MAGIC, &slot[0]);
+    sys_put_le32(LOAD_ADDR, &slot[4]);
+    sys_put_le16(HDR_SIZE, &slot[8]);
+    sys_put_le16(PROTECT_TLV_SIZE, &slot[10]);
+    sys_put_le32(IMG_SIZE, &slot[12]);
+    sys_put_le32(FLAGS, &slot[16]);
+    slot[20] = 1;
+    slot[21] = 2;
+    sys_put_le16(3, &slot[22]);
+    sys_put_le32(4, &slot[24]);
+    memset(&slot[28], 0, HDR_SIZE - 28);
+
+    for (size_t i = 0; i < IMG_SIZE; i++) {
+        slot[HDR_SIZE + i] = (uint8_t) (i * 7);
+    }
+
+    for (size_t i = 0; i < sizeof(hash); i++) {
+        hash[i] = (uint8_t) (0xa0 + i);
+    }
+    put_tlv(TLV_INFO_OFFSET, IMAGE_TLV_INFO_MAGIC, TLV_AREA_SIZE);
+    put_tlv(TLV_OFFSET, 0x50, 4);
+    memset(&slot[TLV_OFFSET + TLV_HEADER_SIZE], 0, 4);
+    put_tlv(TLV_OFFSET + TLV_HEADER_SIZE + 4, IMAGE_TLV_SHA256, OTA_IMAGE_HASH_SIZE);
+    memcpy(&slot[TLV_OFFSET + TLV_HEADER_SIZE + 4 + TLV_HEADER_SIZE], hash, sizeof(hash));
+}
+
+static void put_tlv(size_t offset, uint16_t type, uint16_t len)
+{
+    sys_put_le16(type, &slot[offset]);
+    sys_put_le16(len, &slot[offset + 2]);
+}